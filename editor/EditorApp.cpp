@@ -3,7 +3,10 @@
 #include "editor/EditorPaths.h"
 #include "editor/EditorApp.h"
 #include "editor/modes/modeling/EditableMesh.h"
+#include "editor/modes/modeling/MeshBVH.h"
 #include "editor/modes/modeling/RenderMesh.h"
+#include "editor/modes/modeling/VertexPickGrid.h"
+#include "engine/core/Profiler.h"
 #include "third_party/imgui/imgui.h"
 #include "third_party/imgui/imgui_impl_win32.h"
 #include "third_party/imgui/imgui_impl_dx12.h"
@@ -13,25 +16,11 @@
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <string>
 
 using namespace DirectX;
 
-static const char* CommandName(EditorCommandType type) {
-    switch (type) {
-    case EditorCommandType::AddObject: return "AddObject";
-    case EditorCommandType::DuplicateActiveObject: return "DuplicateActiveObject";
-    case EditorCommandType::DeleteActiveObject: return "DeleteActiveObject";
-    case EditorCommandType::SetActiveObject: return "SetActiveObject";
-    case EditorCommandType::SaveScene: return "SaveScene";
-    case EditorCommandType::LoadScene: return "LoadScene";
-    case EditorCommandType::SetActiveTransform: return "SetActiveTransform";
-    case EditorCommandType::SetGizmoMode: return "SetGizmoMode";
-    case EditorCommandType::FocusCamera: return "FocusCamera";
-    default: return "None";
-    }
-}
-
 static void BeginImGuiFrame() {
     ImGui_ImplDX12_NewFrame();
     ImGui_ImplWin32_NewFrame();
@@ -42,10 +31,6 @@ static void EndImGuiFrame() {
     ImGui::Render();
 }
 
-static bool RayIntersectsTriangle(const DirectX::XMFLOAT3& rayOrigin, const DirectX::XMFLOAT3& rayDir, const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c, float& outT) {
-    return false;
-}
-
 App::App(EditorCamera& camera) : m_camera(camera) {
     m_ctx.camera = &m_camera;
 
@@ -69,18 +54,7 @@ App::App(EditorCamera& camera) : m_camera(camera) {
         m_orbitDistance = (std::max)(0.25f, std::sqrt(dx * dx + dy * dy + dz * dz));
     }
 
-    ResetAllObjects();
-    
-    m_objectCount = 2;
-    m_objects[0].transform.pos = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    m_objects[1].transform.pos = DirectX::XMFLOAT3(2.0f, 0.0f, 0.0f);
-        
-    for (uint32_t i = 0; i < m_objectCount; ++i) {
-        SceneObject& object = m_objects[i];
-
-        object.editMesh.BuildTetrahedron(1.0f);
-        object.renderMesh.BuildFromEditable(object.editMesh);
-    }
+    CreateDefaultScene();
 }
 
 void App::BeginFrame() {
@@ -94,21 +68,8 @@ void App::BeginFrame() {
     m_input.fPressed = false;
 }
 
-void App::Update(const HostFrame& frame) {
-    m_frame = frame;
-    float dt = frame.dt;
-
-    if (!m_engine || !m_editMesh || !m_renderMesh) return;
-
-    EditorCamera* cam = m_ctx.camera;
-    if (!cam) return;
-
-    if (!m_colorsInit) {
-        for (uint32_t i = 0; i < m_renderMesh->drawVertexCount; ++i) {
-            m_baseColors[i] = m_renderMesh->drawVertices[i].color;
-        }
-        m_colorsInit = true;
-    }
+void App::UpdateCamera(float dt) {
+    AE_PROFILE_ZONE("Camera");
 
     // Update viewport for camera.
     RECT rc;
@@ -242,6 +203,23 @@ void App::Update(const HostFrame& frame) {
     if (m_input.fPressed && !m_isDragging) {
         ExecuteCommand(EditorCommandType::FocusCamera);
     }
+}
+
+void App::Update(const HostFrame& frame) {
+    m_frame = frame;
+    float dt = frame.dt;
+    UpdateCpuUsage();
+
+    if (m_engine) { m_engine->MarkUpdateBegin(); }
+    m_scene.ClearChanged();
+    UpdateSceneLoad(kLoadSliceSeconds);
+    SyncActiveMesh();
+    if (!m_engine || !m_editMesh || !m_renderMesh) return;
+
+    EditorCamera* cam = m_ctx.camera;
+    if (!cam) return;
+
+    UpdateCamera(dt);
 
     // Object move (when not in RMB-fly mode).
     // Layer note: this is "app/input"... no D3D12 layer yet; we just update transforms.
@@ -254,19 +232,29 @@ void App::Update(const HostFrame& frame) {
         if (GetAsyncKeyState(VK_UP)    & 0x8000) dy += 1.0f;
         if (GetAsyncKeyState(VK_DOWN)  & 0x8000) dy -= 1.0f;
 
-        if ((dx != 0.0f || dy != 0.0f) && (m_activeObject < m_objectCount)) {
+        if ((dx != 0.0f || dy != 0.0f) && (ActiveIndex() != Scene::kInvalidIndex)) {
             float step = 2.0f * dt;
-            SceneObject& object = m_objects[m_activeObject];
-            object.transform.pos.x  += dx * step;
-            object.transform.pos.y  += dy * step;
+            ObjectTransform transform = m_scene.Transform(ActiveIndex());
+            transform.pos.x  += dx * step;
+            transform.pos.y  += dy * step;
+            m_scene.SetTransform(ActiveIndex(), transform);
         }
     }
 
-    // 1) On press: gizmo first, then active-object vertex, then object selection.
+    // Loads, arrow keys and Transform edits are all in by now; rebuild their matrices here, on the job
+    // system, before picking and the upload below read them through Scene::World.
+    {
+        AE_PROFILE_ZONE("World matrices");
+        m_scene.UpdateWorldMatrices(m_jobs);
+    }
+
+    // 1) On press: gizmo first, then active-object vertex, then active-object face, then object selection.
+    bool pressedOnGizmo = false;
     if (!m_input.rmbDown && m_input.lmbPressed && !m_gizmo.IsDragging()) {
+        AE_PROFILE_ZONE("Picking");
         bool overGizmo = false;
 
-        if (m_activeObject < m_objectCount) {
+        if (ActiveIndex() != Scene::kInvalidIndex) {
             int axis = -1;
             float t0 = 0.0f;
 
@@ -280,41 +268,34 @@ void App::Update(const HostFrame& frame) {
                 axis,
                 t0
             );
+            pressedOnGizmo = overGizmo; //the gizmo starts its drag from the same pick below
         }
 
         if (!overGizmo) {
             int hitVertex = HitTestVertex(m_input.mouseX, m_input.mouseY);
 
             if (hitVertex != -1) {
-                m_selectedVertex = hitVertex;
+                SetSelectedVertex(hitVertex);
                 m_isDragging = false;
-
-                for (uint32_t i = 0; i < m_renderMesh->drawVertexCount; ++i) {
-                    m_renderMesh->drawVertices[i].color = m_baseColors[i];
-                }
-
-                for (uint32_t i = 0; i < m_renderMesh->drawVertexCount; ++i) {
-                    if ((int)m_renderMesh->drawToEdit[i] == m_selectedVertex) {
-                        m_renderMesh->drawVertices[i].color = DirectX::XMFLOAT4(1, 1, 1, 1);
-                    }
-                }
-
-                m_renderMesh->dirty = true;
             } else {
                 int hitObject = HitTestObject(m_input.mouseX, m_input.mouseY);
 
-                if (hitObject != -1) {
+                // Faces are only picked on the active object; clicking another object selects it instead.
+                int hitTriangle = -1;
+                if (hitObject == -1 || hitObject == (int)ActiveIndex()) {
+                    hitTriangle = HitTestTriangle(m_input.mouseX, m_input.mouseY);
+                }
+
+                if (hitTriangle != -1) {
+                    SetSelectedVertex(-1);
+                    m_selectedTriangle = hitTriangle;
+                } else if (hitObject != -1) {
                     EditorCommand command{ EditorCommandType::SetActiveObject };
-                    command.objectIndex = (uint32_t)hitObject;
+                    command.object = m_scene.HandleAt((uint32_t)hitObject);
                     ExecuteCommand(command);
                 } else {
-                    m_selectedVertex = -1;
-
-                    for (uint32_t i = 0; i < m_renderMesh->drawVertexCount; ++i) {
-                        m_renderMesh->drawVertices[i].color = m_baseColors[i];
-                    }
-
-                    m_renderMesh->dirty = true;
+                    SetSelectedVertex(-1);
+                    m_selectedTriangle = -1;
                 }
             }
         }
@@ -324,64 +305,144 @@ void App::Update(const HostFrame& frame) {
 
     // Debug: visualize orbit pivot as a tiny cyan tetra at m_viewPivot.
     // This helps validate what point MMB orbit is rotating around.
-    uint32_t renderCount = m_objectCount;
-    uint32_t pivotIndex = 0xFFFFFFFFu;
-    if (renderCount < kMaxObjects) {
-        pivotIndex = renderCount;
-        renderCount++;
-    }
+    // Scene objects use engine slots [0, count), the pivot marker takes the slot after them.
+    uint32_t objectCount = m_scene.Count();
+    uint32_t pivotIndex = objectCount;
 
-    m_engine->SetObjectCount(renderCount);
-
-    for (uint32_t i = 0; i < m_objectCount; ++i) {
-        const SceneObject& object = m_objects[i];
-        XMMATRIX S = XMMatrixScaling(object.transform.scale.x, object.transform.scale.y, object.transform.scale.z);
-        XMMATRIX R = XMMatrixRotationRollPitchYaw(object.transform.rot.x, object.transform.rot.y, object.transform.rot.z);
-        XMMATRIX T = XMMatrixTranslation(object.transform.pos.x, object.transform.pos.y, object.transform.pos.z);        
-        XMMATRIX W = S * R * T; //W = World matrix for this object
-        XMFLOAT4X4 world;
-        XMStoreFloat4x4(&world, W);
-        m_engine->SetObjectWorld(i, world);
-        m_engine->SetObjectTint(i, object.color);
-    }
+    {
+        AE_PROFILE_ZONE("Transform upload");
+
+        m_engine->SetObjectCount(objectCount + 1);
+
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            m_engine->SetObjectWorld(i, m_scene.World(i)); //cached, only rebuilt when the transform changed
+            m_engine->SetObjectTint(i, m_scene.Color(i));
+            m_engine->SetObjectMesh(i, m_scene.Mesh(i));
+        }
 
-    if (pivotIndex != 0xFFFFFFFFu) {
-        XMMATRIX W = XMMatrixScaling(0.15f, 0.15f, 0.15f) * XMMatrixTranslation(m_viewPivot.x, m_viewPivot.y, m_viewPivot.z);
-        XMFLOAT4X4 world;
-        XMStoreFloat4x4(&world, W);
-        m_engine->SetObjectWorld(pivotIndex, world);
-        m_engine->SetDebugPivotIndex(pivotIndex);
-    } else {
-        m_engine->SetDebugPivotIndex(0xFFFFFFFFu);
+        {
+            XMMATRIX W = XMMatrixScaling(0.15f, 0.15f, 0.15f) * XMMatrixTranslation(m_viewPivot.x, m_viewPivot.y, m_viewPivot.z);
+            XMFLOAT4X4 world;
+            XMStoreFloat4x4(&world, W);
+            m_engine->SetObjectWorld(pivotIndex, world);
+            m_engine->SetObjectMesh(pivotIndex, m_tetraMesh);
+            m_engine->SetDebugPivotIndex(pivotIndex);
+        }
     }
 
     bool renderMeshDirty = false;
-    
-    GizmoUpdateArgs gizmoArgs = BuildGizmoUpdateArgs(renderMeshDirty);
-    m_gizmo.Update(gizmoArgs);
 
-    if (renderMeshDirty)
-        m_renderMesh->dirty = true;
+    {
+        AE_PROFILE_ZONE("Gizmo");
+
+        // A translate drag on a selected vertex writes into the mesh, so give the object its own copy first.
+        if (m_selectedVertex >= 0 && m_gizmo.GetMode() == GizmoMode::Translate && (pressedOnGizmo || m_gizmo.IsDragging())) {
+            MakeActiveMeshUnique();
+        }
+
+        GizmoUpdateArgs gizmoArgs = BuildGizmoUpdateArgs(renderMeshDirty);
+        m_gizmo.Update(gizmoArgs);
+
+        // The gizmo edits a copy of the active transform; write it back only if it moved so the matrix stays cached.
+        uint32_t gizmoObject = gizmoArgs.target.activeObject;
+        if (gizmoObject != Scene::kInvalidIndex && std::memcmp(&m_gizmoTransform, &m_scene.Transform(gizmoObject), sizeof(ObjectTransform)) != 0) {
+            m_scene.SetTransform(gizmoObject, m_gizmoTransform);
+
+            // Objects were already handed to the engine above; resend whatever moved, children included.
+            m_scene.UpdateWorldMatrices(m_jobs);
+            for (uint32_t index : m_scene.ChangedThisFrame()) { m_engine->SetObjectWorld(index, m_scene.World(index)); }
+        }
+    }
+
+    // The gizmo only edits mesh data when dragging the selected vertex, so only its draw vertices need re-uploading.
+    if (renderMeshDirty && m_selectedVertex >= 0) {
+        m_renderMesh->MarkEditVertexDirty((VertexID)m_selectedVertex);
+        m_meshBvh->RefitVertex(*m_editMesh, (VertexID)m_selectedVertex);
+    }
 
-    m_engine->SetSelectedObject(m_activeObject);
+    m_engine->SetSelectedObject(ActiveIndex());
 
-    if (m_renderMesh->dirty) {
-        m_engine->UpdateVertexBuffer(m_editMesh, m_renderMesh, m_hwnd);
-        m_renderMesh->dirty = false;
+    // Upload every asset with pending changes (new copies, edits, highlights) into its own GPU buffers.
+    for (MeshAssetID id = 0; id < m_meshAssets.SlotCount(); ++id) {
+        MeshAsset* asset = m_meshAssets.Get(id);
+        if (asset && asset->renderMesh.dirty) {
+            AE_PROFILE_ZONE("Mesh upload");
+            m_engine->UpdateVertexBuffer(id, &asset->editMesh, &asset->renderMesh, m_hwnd);
+        }
     }
 }
 
-void App::PumpMessages(MSG& msg) {
+bool App::PumpMessages(int& exitCode) {
+    MSG msg = {};
     while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        if (msg.message == WM_QUIT) {
+            exitCode = static_cast<int>(msg.wParam);
+            return false;
+        }
         TranslateMessage(&msg);
         DispatchMessage(&msg);
+        m_redraw.Request(RedrawReason::Input);
+    }
+
+    m_redraw.SetAnimating(IsAnimating());
+    return true;
+}
+
+void App::WaitForEvents(double timeoutSeconds) {
+    DWORD timeoutMs = (timeoutSeconds < 0.0) ? INFINITE : (DWORD)(timeoutSeconds * 1000.0 + 0.5);
+    MsgWaitForMultipleObjectsEx(0, nullptr, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+}
+
+// Held buttons and keys drive the camera and object movement by polling, so they need frames without messages.
+bool App::IsAnimating() const {
+    if (IsLoadingScene()) { return true; } //polls the loader and publishes a slice per frame
+    if (m_input.lmbDown || m_input.rmbDown || m_input.mmbDown || m_isDragging || m_gizmo.IsDragging()) { return true; }
+
+    const int movementKeys[] = { VK_LEFT, VK_RIGHT, VK_UP, VK_DOWN };
+    for (int key : movementKeys) {
+        if (m_input.keys[key]) { return true; }
+    }
+    return false;
+}
+
+void App::UpdateCpuUsage() {
+    FILETIME creation, exit, kernel, user, now;
+    GetSystemTimeAsFileTime(&now);
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) { return; }
+
+    auto ticks = [](const FILETIME& time) { return (uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+    uint64_t wall = ticks(now);
+    uint64_t cpu = ticks(kernel) + ticks(user);
+    uint64_t frames = m_redraw.Stats().framesRendered;
+
+    const uint64_t kSampleTicks = 10000000; //1 s in 100 ns units
+    if (m_cpuSampleWall100ns == 0) {
+        m_cpuSampleWall100ns = wall;
+        m_cpuSampleCpu100ns = cpu;
+        m_cpuSampleFrames = frames;
+    } else if (wall - m_cpuSampleWall100ns >= kSampleTicks) {
+        double wallTicks = double(wall - m_cpuSampleWall100ns);
+        m_cpuPercent = 100.0 * double(cpu - m_cpuSampleCpu100ns) / wallTicks;
+        m_renderedFps = double(frames - m_cpuSampleFrames) * 1.0e7 / wallTicks;
+        m_cpuSampleWall100ns = wall;
+        m_cpuSampleCpu100ns = cpu;
+        m_cpuSampleFrames = frames;
     }
 }
 
 void App::BuildFrameUI() {
+    // The render thread may be drawing the previous frame's ImGui output (and updating its textures).
+    std::unique_lock<std::mutex> uiLock;
+    if (m_engine) { uiLock = std::unique_lock<std::mutex>(m_engine->UiMutex()); }
+
     BeginImGuiFrame();
     DrawSceneWindow();
+    DrawRenderStatsWindow();
+    DrawProfilerWindow();
     EndImGuiFrame();
+
+    // A focused text field blinks its cursor without any input.
+    if (ImGui::GetIO().WantTextInput) { m_redraw.RequestAfter(0.5); }
 }
 
 void App::Render() {
@@ -482,7 +543,7 @@ LRESULT App::HandleWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lPa
 
                 if (!wasDown && wParam == 'O' && (GetAsyncKeyState(VK_CONTROL) & 0x8000)) {
                     std::wstring scenePath = GetDefaultScenePath();
-                    EditorCommand command = {EditorCommandType::LoadScene};
+                    EditorCommand command = {EditorCommandType::LoadSceneAsync};
                     command.path = scenePath.c_str();
                     ExecuteCommand(command);
                 }
@@ -510,123 +571,121 @@ LRESULT App::HandleWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lPa
             handled = true;
             return 0;
         }
+        case WM_KILLFOCUS: {
+            // Key-ups go to the focused window, so keys held when focus left would stay down forever.
+            std::memset(m_input.keys, 0, sizeof(m_input.keys));
+            break;
+        }
     }
 
     return 0;
 }
 
 int App::HitTestVertex(int mouseX, int mouseY) {
-    if (!m_hwnd) return -1;
+    if (!m_hwnd || !m_editMesh || ActiveIndex() == Scene::kInvalidIndex) return -1;
+
+    RECT rc;
+    GetClientRect(m_hwnd, &rc);
+    float width = float(rc.right - rc.left);
+    float height = float(rc.bottom - rc.top);
 
-    float bestDistSq = 1.0e30f;
-    int bestVertex = -1;
     const float pickRadiusPx = 14.0f;
-    const float pickRadiusSq = pickRadiusPx * pickRadiusPx;
 
-    for (uint32_t i = 0; i < m_editMesh->vertexCount; ++i) {
-        DirectX::XMFLOAT3 p = m_editMesh->GetVertex((VertexID)i);
-        DirectX::XMFLOAT3 pw = LocalVertexToWorld(p);
+    DirectX::XMFLOAT4X4 world;
+    DirectX::XMStoreFloat4x4(&world, ObjectWorldMatrix(ActiveIndex()));
 
-        float sx = 0.0f;
-        float sy = 0.0f;
-        if (!WorldToScreen(pw, sx, sy)) continue;
+    // Only re-projects when the mesh, object transform, camera or viewport changed since the last pick.
+    m_vertexPickGrid.Update(*m_editMesh, world, m_camera.ViewProj(), width, height, pickRadiusPx);
+    return m_vertexPickGrid.Pick(float(mouseX), float(mouseY));
+}
 
-        float dx = sx - float(mouseX);
-        float dy = sy - float(mouseY);
-        float distSq = dx * dx + dy * dy;
+int App::HitTestTriangle(int mouseX, int mouseY) {
+    if (!m_editMesh || ActiveIndex() == Scene::kInvalidIndex) return -1;
 
-        if (distSq <= pickRadiusSq && distSq < bestDistSq) {
-            bestDistSq = distSq;
-            bestVertex = i;
-        }
-    }
+    LARGE_INTEGER freq, start, end;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
 
-    return bestVertex;
-}
+    MeshBVH* bvh = PickBvh(m_scene.Mesh(ActiveIndex()));
+    if (!bvh) return -1;
 
-int App::HitTestTriangle(int mouseX, int mouseY) {
-    return 1;
+    DirectX::XMFLOAT3 origin, dir;
+    m_camera.BuildRayFromScreen(float(mouseX), float(mouseY), origin, dir);
+
+    // Bring the ray into object space once instead of transforming every triangle to world space.
+    // The direction is left unnormalized so the hit t stays a world-space distance.
+    DirectX::XMMATRIX invW = ObjectInverseWorldMatrix(ActiveIndex());
+
+    DirectX::XMFLOAT3 localOrigin, localDir;
+    DirectX::XMStoreFloat3(&localOrigin, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&origin), invW));
+    DirectX::XMStoreFloat3(&localDir, DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&dir), invW));
+
+    TriangleID hitTriangle = kInvalidTriangleID;
+    float hitT = 0.0f;
+    bool hit = bvh->Raycast(*m_editMesh, localOrigin, localDir, hitTriangle, hitT);
+
+    QueryPerformanceCounter(&end);
+    m_lastPickMs = double(end.QuadPart - start.QuadPart) * 1000.0 / double(freq.QuadPart);
+
+    return hit ? (int)hitTriangle : -1;
 }
 
-int App::HitTestObject(int mouseX, int mouseY) const {
+int App::HitTestObject(int mouseX, int mouseY) {
     DirectX::XMFLOAT3 origin, dir;
     m_camera.BuildRayFromScreen(float(mouseX), float(mouseY), origin, dir);
+    return PickObject(origin, dir);
+}
 
-    DirectX::XMVECTOR rayOrigin = DirectX::XMLoadFloat3(&origin);
-    DirectX::XMVECTOR rayDir = DirectX::XMLoadFloat3(&dir);
-
-    float bestDist = 1.0e30f;
-    int bestIndex = -1;
-
-    for (uint32_t index = 0; index < m_objectCount; ++index) {
-        const SceneObject& object = m_objects[index];
-
-        DirectX::XMFLOAT3 center = object.transform.pos;
-        DirectX::XMFLOAT3 objScale = object.transform.scale;
-        float scale = (std::max)(objScale.x, (std::max)(objScale.y, objScale.z));
-        float radius = 1.0f * scale;
-
-        DirectX::XMVECTOR sphereCenter = DirectX::XMLoadFloat3(&center); //Also object center in world space
-        DirectX::XMVECTOR offset = DirectX::XMVectorSubtract(rayOrigin, sphereCenter); //points from the sphere center to the ray origin 
-        
-        /*
-        |X - C| = r(Sphere: C is the sphere center, r is the radius, X is any point on the sphere)
-        |X - C|^2 = r^2      (Remove the square root on the LHS since it's a distance formula)
-        P(t) = O + tD        (Ray: O = origin, D = direction, t = distance along the ray)
-        |O + tD - C|^2 = r^2 (plug ray into the sphere equation) 
-        m = O - C            (vector from sphere center to ray origin)
-        |m + tD|^2 = r^2
-        |m + tD|^2 = (m + tD) · (m + tD)
-        (m + tD) · (m + tD) = m·m + 2t(m·D) + t^2(D·D)
-        t^2(D·D) + 2t(m·D) + (m·m - r^2) = 0
-        m·m : The squared distance from the ray origin to the sphere center
-        m·D : how the ray direction lines up with the vector from center to origin
-        D·D = 1 : The squared length of the direction vector (normalized)
-        m·m - r^2 : whether the ray origin starts outside, on, or inside the sphere
-            positive: outside
-            zero: exactly on surface
-            negative: inside
-        */
-
-        //proj < 0 means the ray points back toward the sphere
-        //proj > 0 means the ray points away from the sphere
-        float proj = DirectX::XMVectorGetX(DirectX::XMVector3Dot(offset, rayDir)); //is the sphere center roughly in front of the ray or behind it, and by how much?
-        float offsetLenSq = DirectX::XMVectorGetX(DirectX::XMVector3Dot(offset, offset)); //squared distance from the ray origin to the sphere center
-        //dist > 0 means the ray origin is outside the sphere
-        //dist == 0 means the ray origin is exactly on the sphere
-        //dist < 0 means the ray origin is inside the sphere
-        float dist = offsetLenSq - radius * radius;
-
-        if (dist > 0.0f && proj > 0.0f) continue; // The ray starts outside the sphere and points away from it, so a hit is impossible.
-
-        //ax² + bx + c = 0, x = -b ± sqrt(b² - 4ac) / 2a, discriminant = b² - 4ac
-
-        float disc = proj * proj - dist; //reduced discriminant, obtained because the ray-sphere quadratic was written as:
-        //t² + 2proj·t + dist = 0
-        //a = 1
-        //b = 2proj
-        //c = dist
-        //disc = 4(proj² - dist)
-
-        //disc < 0 means no real intersection (No real roots)
-        //disc == 0 means tangent hit (one real root)
-        //disc > 0 means the ray enters and exits the sphere (two distinct real roots)
-        if (disc < 0.0f) continue; //So if disc is negative, skip this object
-
-        float hit = -proj - std::sqrt(disc); //t = -proj ± sqrt(disc), using only minus because that is the nearer root
-        //Since sqrt(disc) is nonnegative, -proj - sqrt(disc) <= -proj + sqrt(disc)
-        //-proj - sqrt(disc) is the smaller root
-        //-proj + sqrt(disc) is the larger root
-        
-        if (hit < 0.0f) hit = 0.0f;
-
-        if (hit < bestDist) {
-            bestDist = hit;
-            bestIndex = (int)index;
-        }
+DirectX::XMMATRIX App::ObjectWorldMatrix(uint32_t index) const {
+    return DirectX::XMLoadFloat4x4(&m_scene.World(index));
+}
+
+DirectX::XMMATRIX App::ObjectInverseWorldMatrix(uint32_t index) const {
+    return DirectX::XMLoadFloat4x4(&m_scene.InverseWorld(index));
+}
+
+// Points m_editMesh/m_renderMesh/m_meshBvh at the active object's mesh asset.
+void App::SyncActiveMesh() {
+    uint32_t index = ActiveIndex();
+    MeshAsset* asset = (index != Scene::kInvalidIndex) ? m_meshAssets.Get(m_scene.Mesh(index)) : nullptr;
+    RenderMesh* renderMesh = asset ? &asset->renderMesh : nullptr;
+
+    // The vertex highlight lives in the render mesh, so drop it before switching to another asset.
+    if (renderMesh != m_renderMesh) {
+        SetSelectedVertex(-1);
+        m_selectedTriangle = -1;
     }
 
-    return bestIndex;
+    m_editMesh = asset ? &asset->editMesh : nullptr;
+    m_renderMesh = renderMesh;
+    m_meshBvh = asset ? &asset->bvh : nullptr;
+}
+
+void App::OnActiveObjectChanging() {
+    SetSelectedVertex(-1); //the highlight lives in the asset, which may be released
+    m_selectedTriangle = -1;
+}
+
+void App::OnActiveObjectChanged() {
+    SyncActiveMesh();
+    m_isDragging = false;
+    m_gizmo.Reset();
+}
+
+// Copy-on-write: the first edit through a shared asset moves the active object onto a private copy.
+void App::MakeActiveMeshUnique() {
+    uint32_t index = ActiveIndex();
+    if (index == Scene::kInvalidIndex) return;
+
+    MeshAssetID mesh = m_scene.Mesh(index);
+    if (m_meshAssets.RefCount(mesh) <= 1) return;
+
+    int vertex = m_selectedVertex;
+    SetSelectedVertex(-1); //clear the highlight in the shared asset before it is copied
+
+    m_scene.SetMesh(index, m_meshAssets.MakeUnique(mesh));
+    SyncActiveMesh();
+    SetSelectedVertex(vertex);
 }
 
 bool App::ScreenToWorldOnZPlane(int screenX, int screenY, float& worldX, float& worldY) {
@@ -644,27 +703,9 @@ bool App::ScreenToWorldOnZPlane(int screenX, int screenY, float& worldX, float&
 }
 
 DirectX::XMFLOAT3 App::LocalVertexToWorld(const DirectX::XMFLOAT3& p) const {
-    if (m_activeObject >= m_objectCount) return p;
-
-    const SceneObject& object = m_objects[m_activeObject];
-
-    DirectX::XMMATRIX S = DirectX::XMMatrixScaling(
-        object.transform.scale.x,
-        object.transform.scale.y,
-        object.transform.scale.z
-    );
-    DirectX::XMMATRIX R = DirectX::XMMatrixRotationRollPitchYaw(
-        object.transform.rot.x,
-        object.transform.rot.y,
-        object.transform.rot.z
-    );
-    DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(
-        object.transform.pos.x,
-        object.transform.pos.y,
-        object.transform.pos.z
-    );
-
-    DirectX::XMMATRIX W = S * R * T;
+    if (ActiveIndex() == Scene::kInvalidIndex) return p;
+
+    DirectX::XMMATRIX W = ObjectWorldMatrix(ActiveIndex());
 
     DirectX::XMVECTOR v = DirectX::XMVectorSet(p.x, p.y, p.z, 1.0f);
     DirectX::XMVECTOR r = DirectX::XMVector3TransformCoord(v, W);
@@ -675,28 +716,9 @@ DirectX::XMFLOAT3 App::LocalVertexToWorld(const DirectX::XMFLOAT3& p) const {
 }
 
 DirectX::XMFLOAT3 App::WorldPointToLocal(const DirectX::XMFLOAT3& p) const {
-    if (m_activeObject >= m_objectCount) return p;
-
-    const SceneObject& object = m_objects[m_activeObject];
-
-    DirectX::XMMATRIX S = DirectX::XMMatrixScaling(
-        object.transform.scale.x,
-        object.transform.scale.y,
-        object.transform.scale.z
-    );
-    DirectX::XMMATRIX R = DirectX::XMMatrixRotationRollPitchYaw(
-        object.transform.rot.x,
-        object.transform.rot.y,
-        object.transform.rot.z
-    );
-    DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(
-        object.transform.pos.x,
-        object.transform.pos.y,
-        object.transform.pos.z
-    );
-
-    DirectX::XMMATRIX W = S * R * T;
-    DirectX::XMMATRIX invW = DirectX::XMMatrixInverse(nullptr, W);
+    if (ActiveIndex() == Scene::kInvalidIndex) return p;
+
+    DirectX::XMMATRIX invW = ObjectInverseWorldMatrix(ActiveIndex());
 
     DirectX::XMVECTOR v = DirectX::XMVectorSet(p.x, p.y, p.z, 1.0f);
     DirectX::XMVECTOR r = DirectX::XMVector3TransformCoord(v, invW);
@@ -736,14 +758,18 @@ bool App::WorldToScreen(const DirectX::XMFLOAT3& worldPos, float& outScreenX, fl
 GizmoTarget App::BuildGizmoTarget() {
     GizmoTarget target = {};
     target.editMesh = m_editMesh;
-    target.activeObject = m_activeObject;
+    target.activeObject = ActiveIndex(); //UINT32_MAX when nothing is active
     target.selectedVertex = m_selectedVertex;
 
-    if (m_activeObject < m_objectCount) {
-        SceneObject& object = m_objects[m_activeObject];
-        target.transform.pos = &object.transform.pos;
-        target.transform.rot = &object.transform.rot;
-        target.transform.scale = &object.transform.scale;
+    if (target.activeObject != Scene::kInvalidIndex) {
+        // The gizmo writes through these pointers; Update copies the result back with SetTransform.
+        m_gizmoTransform = m_scene.Transform(target.activeObject);
+        target.transform.pos = &m_gizmoTransform.pos;
+        target.transform.rot = &m_gizmoTransform.rot;
+        target.transform.scale = &m_gizmoTransform.scale;
+
+        uint32_t parent = m_scene.Parent(target.activeObject);
+        if (parent != Scene::kInvalidIndex) { target.transform.parentWorld = &m_scene.World(parent); }
     }
 
     return target;
@@ -772,17 +798,22 @@ void App::UpdateViewProj() {
 }
 
 void App::FocusCamera() {
-    if (m_activeObject >= m_objectCount)
+    if (ActiveIndex() == Scene::kInvalidIndex)
         return;
 
-    const SceneObject& object = m_objects[m_activeObject];
-    DirectX::XMFLOAT3 center = object.transform.pos;
-    DirectX::XMFLOAT3 scale = object.transform.scale;
-    float maxScale = (std::max)(scale.x, (std::max)(scale.y, scale.z)); //Take the largest scale axis. The (std::max) style is intentional. It avoids problems if Windows headers define a max macro.
-
-    float baseRadius = 0.75f; //computes a rough bounding radius
-    float radius = baseRadius * maxScale;
-    radius = (std::max)(radius, 0.5f); //So an object with scale 1 gets radius 0.75. If the object is tiny, the radius is clamped to at least 0.5, so the camera does not get too close.
+    DirectX::XMFLOAT3 scale = m_scene.Transform(ActiveIndex()).scale;
+    float maxScale = (std::max)(fabsf(scale.x), (std::max)(fabsf(scale.y), fabsf(scale.z))); //Take the largest scale axis. The (std::max) style is intentional. It avoids problems if Windows headers define a max macro.
+
+    // Frame the mesh's bounding sphere: its center moved to world space, radius scaled by the largest axis.
+    const DirectX::XMFLOAT4X4& world = m_scene.World(ActiveIndex());
+    DirectX::XMFLOAT3 center(world.m[3][0], world.m[3][1], world.m[3][2]);
+    float radius = 0.75f * maxScale;
+    if (m_editMesh && !m_editMesh->GetBounds().empty) {
+        const MeshBounds& bounds = m_editMesh->GetBounds();
+        DirectX::XMStoreFloat3(&center, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&bounds.center), ObjectWorldMatrix(ActiveIndex())));
+        radius = bounds.radius * maxScale;
+    }
+    radius = (std::max)(radius, 0.5f); //If the object is tiny, the radius is clamped to at least 0.5, so the camera does not get too close.
 
     float dist = radius / std::tan(m_camera.FovY() * 0.5f); //computes how far the camera should be from the object based on vertical FOV
     dist = (std::max)(dist, 1.0f);                          //distance = radius / tan(fov / 2)
@@ -800,216 +831,14 @@ void App::FocusCamera() {
     m_orbitDistance = dist;
 }
 
-bool App::SaveSceneAem(const wchar_t* path) {
-    // File format:
-    //   AE_MODEL 1                                          //px py pz = object position x/y/z
-    //   objects N                                           //rx ry rz = object rotation x/y/z
-    //   active I                                            //sx sy sz = object scale x/y/z
-    //   obj tetra px py pz rx ry rz sx sy sz cr cg cb ca    //cr cg cb ca = object color red/green/blue/alpha
-    FILE* f = nullptr;
-    if (_wfopen_s(&f, path, L"wb") != 0 || !f) return false;
-
-    std::fprintf(f, "AE_MODEL 1\n");
-    std::fprintf(f, "objects %u\n", (unsigned)m_objectCount);
-    std::fprintf(f, "active %u\n", (unsigned)m_activeObject);
-
-    for (uint32_t i = 0; i < m_objectCount; ++i) {
-        const SceneObject& object = m_objects[i];
-        std::fprintf(f, "obj tetra %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g\n",
-            object.transform.pos.x, object.transform.pos.y, object.transform.pos.z,
-            object.transform.rot.x, object.transform.rot.y, object.transform.rot.z,
-            object.transform.scale.x, object.transform.scale.y, object.transform.scale.z,
-            object.color.x, object.color.y, object.color.z, object.color.w
-        );
+// Moves the vertex highlight: only the draw vertices of the old and new selection are rewritten.
+void App::SetSelectedVertex(int vertex) {
+    if (m_renderMesh) {
+        if (m_selectedVertex >= 0) { m_renderMesh->SetVertexHighlight((VertexID)m_selectedVertex, false); }
+        if (vertex >= 0) { m_renderMesh->SetVertexHighlight((VertexID)vertex, true); }
     }
 
-    std::fclose(f);
-    return true;
-}
-
-bool App::LoadSceneAem(const wchar_t* path) {
-    FILE* f = nullptr;
-    if (_wfopen_s(&f, path, L"rb") != 0 || !f) return false;
-
-    char header[64] = {};
-    int ver = 0;
-    if (std::fscanf(f, "%63s %d", header, &ver) != 2) { std::fclose(f); return false; }
-    if (std::strcmp(header, "AE_MODEL") != 0 || ver != 1) { std::fclose(f); return false; }
-
-    char key[64] = {};
-    unsigned n = 0;
-    if (std::fscanf(f, "%63s %u", key, &n) != 2) { std::fclose(f); return false; }
-    if (std::strcmp(key, "objects") != 0) { std::fclose(f); return false; }
-
-    unsigned active = 0;
-    if (std::fscanf(f, "%63s %u", key, &active) != 2) { std::fclose(f); return false; }
-    if (std::strcmp(key, "active") != 0) { std::fclose(f); return false; }
-
-    if (n == 0) n = 1;
-    if (n > kMaxObjects) n = kMaxObjects;
-
-    m_objectCount = (uint32_t)n;
-    m_activeObject = (active < m_objectCount) ? (uint32_t)active : 0;
-
-    ResetAllObjects();
-
-    for (uint32_t i = 0; i < m_objectCount; ++i) {
-        char objKey[16] = {};
-        char prim[16] = {};
-        if (std::fscanf(f, "%15s %15s", objKey, prim) != 2) { std::fclose(f); return false; }
-        if (std::strcmp(objKey, "obj") != 0) { std::fclose(f); return false; }
-        if (std::strcmp(prim, "tetra") != 0) { std::fclose(f); return false; }
-
-        SceneObject& object = m_objects[i];
-
-        if (std::fscanf(f, "%f %f %f %f %f %f %f %f %f %f %f %f %f",
-            &object.transform.pos.x, &object.transform.pos.y, &object.transform.pos.z,
-            &object.transform.rot.x, &object.transform.rot.y, &object.transform.rot.z,
-            &object.transform.scale.x, &object.transform.scale.y, &object.transform.scale.z,
-            &object.color.x, &object.color.y, &object.color.z, &object.color.w
-        ) != 13) { std::fclose(f); return false; }
-
-        object.editMesh.BuildTetrahedron(1.0f);
-        object.renderMesh.BuildFromEditable(object.editMesh);
-    }
-
-    std::fclose(f);
-    return true;
-}
-
-bool App::GetActiveObjectTransform(DirectX::XMFLOAT3& pos, DirectX::XMFLOAT3& rot, DirectX::XMFLOAT3& scale) const {
-    if (m_activeObject >= m_objectCount)
-        return false;
-
-    const SceneObject& object = m_objects[m_activeObject];
-
-    pos = object.transform.pos;
-    rot = object.transform.rot;
-    scale = object.transform.scale;
-
-    return true;
-}
-
-bool App::SetActiveObjectTransform(const DirectX::XMFLOAT3& pos, const DirectX::XMFLOAT3& rot, const DirectX::XMFLOAT3& scale) {
-    if (m_activeObject >= m_objectCount)
-        return false;
-
-    DirectX::XMFLOAT3 safeScale = scale;
-    const float minScale = 0.001f;
-    if (fabsf(safeScale.x) < minScale) safeScale.x = (safeScale.x < 0.0f) ? -minScale : minScale;
-    if (fabsf(safeScale.y) < minScale) safeScale.y = (safeScale.y < 0.0f) ? -minScale : minScale;
-    if (fabsf(safeScale.z) < minScale) safeScale.z = (safeScale.z < 0.0f) ? -minScale : minScale;
-
-    SceneObject& object = m_objects[m_activeObject];
-    object.transform.pos = pos;
-    object.transform.rot = rot;
-    object.transform.scale = safeScale;
-    
-    return true;
-}
-
-void App::SetActiveObject(uint32_t index) {
-    if (index >= m_objectCount)
-        return;
-
-    m_activeObject = index;
-    m_selectedVertex = -1;
-    m_selectedTriangle = -1;
-    m_isDragging = false;
-    m_gizmo.Reset();
-
-    if (m_renderMesh && m_colorsInit) {
-        for (uint32_t i = 0; i < m_renderMesh->drawVertexCount; ++i) {
-            m_renderMesh->drawVertices[i].color = m_baseColors[i];
-        }
-
-        m_renderMesh->dirty = true;
-    }
-}
-
-bool App::AddObject(const DirectX::XMFLOAT3& pos) {
-    if (m_objectCount >= kMaxObjects)
-        return false;
-
-    SceneObject& object = m_objects[m_objectCount];
-
-    object.transform.pos = pos;
-    object.transform.rot = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    object.transform.scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
-    object.color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-    object.editMesh.BuildTetrahedron(1.0f);
-    object.renderMesh.BuildFromEditable(object.editMesh);
-
-    m_objectCount++;
-    m_activeObject = m_objectCount - 1;
-    m_selectedVertex = -1;
-    m_selectedTriangle = -1;
-    return true;
-}
-
-bool App::DuplicateActiveObject() {
-    if (m_activeObject >= m_objectCount)
-        return false;
-
-    const SceneObject& source = m_objects[m_activeObject];
-
-    DirectX::XMFLOAT3 p = source.transform.pos;
-    DirectX::XMFLOAT3 r = source.transform.rot;
-    DirectX::XMFLOAT3 s = source.transform.scale;
-    DirectX::XMFLOAT4 c = source.color;
-
-    p.x += 0.5f; // small offset so it’s visible
-    if (!AddObject(p)) return false;
-
-    SceneObject& duplicate = m_objects[m_activeObject];
-    duplicate.transform.rot = r;
-    duplicate.transform.scale = s;
-    duplicate.color = c;
-
-    return true;
-}
-
-bool App::DeleteActiveObject() {
-    if (m_objectCount <= 1)
-        return false;
-
-    if (m_activeObject >= m_objectCount)
-        return false;
-
-    for (uint32_t i = m_activeObject + 1; i < m_objectCount; ++i) {
-        m_objects[i - 1] = m_objects[i];
-    }
-
-    m_objectCount--;
-
-    SceneObject& duplicate = m_objects[m_objectCount]; //Last object is a duplicate of the previous one in the array
-    duplicate.transform.pos = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    duplicate.transform.rot = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    duplicate.transform.scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
-    duplicate.color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-    duplicate.editMesh.Clear();
-    duplicate.renderMesh.Clear();
-
-    if (m_activeObject >= m_objectCount)
-        m_activeObject = m_objectCount - 1;
-
-    m_selectedVertex = -1;
-    m_selectedTriangle = -1;
-    m_gizmo.Reset();
-
-    return true;
-}
-
-void App::ResetAllObjects() {
-    for (uint32_t i = 0; i < kMaxObjects; ++i) {
-        SceneObject& object = m_objects[i];
-        object.transform.pos = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-        object.transform.rot = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-        object.transform.scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
-        object.color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-        object.editMesh.Clear();
-        object.renderMesh.Clear();
-    }
+    m_selectedVertex = vertex;
 }
 
 bool App::ExecuteCommand(EditorCommandType type) {
@@ -1020,38 +849,6 @@ bool App::ExecuteCommand(const EditorCommand& command) {
     bool ok = false;
 
     switch (command.type) {
-    case EditorCommandType::AddObject:
-        ok = AddObject(command.pos);
-        break;
-
-    case EditorCommandType::DuplicateActiveObject:
-        ok = DuplicateActiveObject();
-        break;
-
-    case EditorCommandType::DeleteActiveObject:
-        ok = DeleteActiveObject();
-        break;
-
-    case EditorCommandType::SaveScene:
-        if (!command.path) return false;
-        ok = SaveSceneAem(command.path);
-        break;
-
-    case EditorCommandType::LoadScene:
-        if (!command.path) return false;
-        ok = LoadSceneAem(command.path);
-        break;
-
-    case EditorCommandType::SetActiveObject:
-        if (command.objectIndex >= m_objectCount) return false;
-        SetActiveObject(command.objectIndex);
-        ok = true;
-        break;
-
-    case EditorCommandType::SetActiveTransform:
-        ok = SetActiveObjectTransform(command.pos, command.rot, command.scale);
-        break;
-
     case EditorCommandType::SetGizmoMode:
         if (command.gizmoMode > (uint32_t)GizmoMode::Rotate) return false;
         SetGizmoMode((GizmoMode)command.gizmoMode);
@@ -1064,11 +861,13 @@ bool App::ExecuteCommand(const EditorCommand& command) {
         break;
 
     default:
-        return false;
+        ok = SceneDocument::ExecuteCommand(command);
+        break;
     }
 
     if (ok) {
-        m_lastCommandName = CommandName(command.type);
+        m_lastCommandName = EditorCommandName(command.type);
+        m_redraw.Request(RedrawReason::Command);
     }
 
     return ok;
@@ -1111,25 +910,65 @@ void App::DrawSceneWindow() {
     ImGui::SameLine();
 
     if (ImGui::Button("Load")) {
-        EditorCommand command = {EditorCommandType::LoadScene};
+        EditorCommand command = {EditorCommandType::LoadSceneAsync};
         command.path = scenePath.c_str();
         ExecuteCommand(command);
     }
 
+    // Binary container: same contents plus mesh geometry, loads from a memory mapping.
+    std::wstring binaryScenePath = GetDefaultBinaryScenePath();
+
+    ImGui::SameLine();
+
+    if (ImGui::Button("Save .aeb")) {
+        EnsureDefaultSceneDirectoryExists();
+        EditorCommand command = {EditorCommandType::SaveScene};
+        command.path = binaryScenePath.c_str();
+        ExecuteCommand(command);
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::Button("Load .aeb")) {
+        EditorCommand command = {EditorCommandType::LoadSceneAsync};
+        command.path = binaryScenePath.c_str();
+        ExecuteCommand(command);
+    }
+
+    // Loads run in the background; the scene stays editable while objects and meshes come in.
+    const SceneLoadStats& load = LoadStats();
+    if (load.loading) {
+        ImGui::Text("Loading: %u / %u objects, %u / %u meshes", load.objectsPublished, load.objects, load.meshesResident, load.meshes);
+    } else if (load.failed) {
+        ImGui::TextWrapped("Last load failed: %s", LastLoadError().c_str());
+    } else if (load.objects > 0) {
+        ImGui::Text("Last load: first objects %.1f ms, all %.1f ms, meshes %.1f ms (read %.1f ms)", load.firstObjectsMs, load.allObjectsMs, load.allMeshesMs, load.readMs);
+        ImGui::Text("  %u frames, longest %.2f ms, %u placeholders", load.slices, load.maxSliceMs, load.placeholders);
+    }
+
     ImGui::Separator();
     ImGui::Text("OBJECT LIST:");
 
-    for (uint32_t i = 0; i < ObjectCount(); ++i) {
-        char label[32];
-        sprintf_s(label, "Object %u", i);
-        bool selected = (i == ActiveObject());
-
-        if (ImGui::Selectable(label, selected)) {
-            EditorCommand command = {EditorCommandType::SetActiveObject};
-            command.objectIndex = i;
-            ExecuteCommand(command);
+    // Clipped so only visible rows are submitted; labels use the handle slot, which survives deletes.
+    ImGui::BeginChild("ObjectList", ImVec2(0.0f, 120.0f));
+    ImGuiListClipper clipper;
+    clipper.Begin((int)ObjectCount());
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            ObjectHandle handle = m_scene.HandleAt((uint32_t)i);
+
+            char label[32];
+            sprintf_s(label, "Object %u", handle.index);
+            bool selected = (handle == ActiveObject());
+
+            if (ImGui::Selectable(label, selected)) {
+                EditorCommand command = {EditorCommandType::SetActiveObject};
+                command.object = handle;
+                ExecuteCommand(command);
+            }
         }
     }
+    ImGui::EndChild();
 
     ImGui::Separator();
     ImGui::Text("Last Command: %s", LastCommandName());
@@ -1137,6 +976,51 @@ void App::DrawSceneWindow() {
     ImGui::Text("dt: %.4f  total: %.2f", m_frame.dt, m_frame.totalTime);
     ImGui::Text("Selected Vertex: %d", m_selectedVertex);
     ImGui::Text("Selected Triangle: %d", m_selectedTriangle);
+    ImGui::Text("Last face pick: %.3f ms (%u BVH nodes)", m_lastPickMs, m_meshBvh ? m_meshBvh->NodeCount() : 0u);
+    ImGui::Text("Mesh assets: %u for %u objects (%.1f KB)", m_meshAssets.AliveCount(), ObjectCount(), double(m_meshAssets.MemoryBytes()) / 1024.0);
+    if (m_engine) { ImGui::Text("Mesh upload: %llu B (total %llu B)", (unsigned long long)m_engine->LastMeshUploadBytes(), (unsigned long long)m_engine->TotalMeshUploadBytes()); }
+    if (m_engine) {
+        bool instanced = m_engine->GetDrawSubmitMode() == DrawSubmitMode::Instanced;
+        if (ImGui::Checkbox("Instanced draws", &instanced)) {
+            m_engine->SetDrawSubmitMode(instanced ? DrawSubmitMode::Instanced : DrawSubmitMode::PerObject);
+        }
+        ImGui::Text("Object draw calls: %u (%u instances)", m_engine->LastDrawCallCount(), m_engine->LastInstanceCount());
+
+        FrameTimingSummary timing = m_engine->GetFrameTimingSummary();
+        ImGui::Text("Render thread: %s", m_engine->IsRenderThreadRunning() ? "on" : "off");
+        ImGui::Text("Update %.2f ms, render %.2f ms, overlap %.2f ms", timing.updateMs, timing.renderMs, timing.overlapMs);
+        ImGui::Text("Dropped snapshots: %llu", (unsigned long long)timing.droppedSnapshots);
+        const FramesInFlight& frames = m_engine->Frames();
+        ImGui::Text("Frames in flight: %u (GPU waits: %llu, %.1f ms)", frames.FrameCount(), (unsigned long long)frames.StallCount(), frames.StallMs());
+        UploadRingStats ring = m_engine->GetUploadRingStats();
+        ImGui::Text("Upload ring: %.1f / %.1f KB (peak %.1f KB, frame %.1f KB, peak frame %.1f KB, grown %u)",
+            ring.usedBytes / 1024.0, ring.capacityBytes / 1024.0, ring.highWaterBytes / 1024.0,
+            ring.lastFrameBytes / 1024.0, ring.peakFrameBytes / 1024.0, ring.growCount);
+        if (ImGui::Button("Write timing report")) {
+            FILE* f = nullptr;
+            if (_wfopen_s(&f, GetFrameTimingReportPath().c_str(), L"w") == 0 && f) {
+                m_engine->WriteFrameTimingReport(f);
+                fclose(f);
+            }
+        }
+    }
+    ImGui::Text("World matrix rebuilds: %u this frame (%llu total)", m_scene.MatrixRebuildsThisFrame(), (unsigned long long)m_scene.MatrixRebuildCount());
+    if (m_jobs) { ImGui::Text("Job threads: %u (%llu jobs, %llu stolen)", m_jobs->ThreadCount(), (unsigned long long)m_jobs->JobCount(), (unsigned long long)m_jobs->StealCount()); }
+
+    bool idle = m_redraw.IdleEnabled();
+    if (ImGui::Checkbox("Idle redraw", &idle)) { m_redraw.SetIdleEnabled(idle); }
+    const RedrawStats& redraw = m_redraw.Stats();
+    double idlePercent = (m_frame.totalTime > 0.0f) ? 100.0 * redraw.idleSeconds / (redraw.idleSeconds + double(m_frame.totalTime)) : 0.0;
+    ImGui::Text("CPU %.1f%% of a core, %.1f frames/s", m_cpuPercent, m_renderedFps);
+    ImGui::Text("Frames %llu, idle waits %llu (%.0f%% of the time idle)", (unsigned long long)redraw.framesRendered, (unsigned long long)redraw.idleWaits, idlePercent);
+    if (m_pacer) {
+        FramePacingStats pacing = m_pacer->Stats();
+        if (pacing.targetMs > 0.0) {
+            ImGui::Text("Paced to %.2f ms: mean %.2f ms, jitter p50 %.3f / p99 %.3f ms, %llu missed", pacing.targetMs, pacing.meanMs, pacing.p50DeviationMs, pacing.p99DeviationMs, (unsigned long long)pacing.missedDeadlines);
+        } else {
+            ImGui::Text("Frame time %.2f ms, jitter p50 %.3f / p99 %.3f ms", pacing.meanMs, pacing.p50DeviationMs, pacing.p99DeviationMs);
+        }
+    }
     ImGui::Separator();
 
     ImGui::Text("Gizmo Mode: %s", GizmoModeName());
@@ -1186,6 +1070,36 @@ void App::DrawSceneWindow() {
             command.scale = DirectX::XMFLOAT3(scaleEdit[0], scaleEdit[1], scaleEdit[2]);
             ExecuteCommand(command);
         }
+
+        uint32_t parent = m_scene.Parent(ActiveIndex());
+        char parentLabel[32] = "None";
+        if (parent != Scene::kInvalidIndex) { sprintf_s(parentLabel, "Object %u", m_scene.HandleAt(parent).index); }
+
+        if (ImGui::BeginCombo("Parent", parentLabel)) {
+            if (ImGui::Selectable("None", parent == Scene::kInvalidIndex)) {
+                EditorCommand command = {EditorCommandType::SetActiveParent};
+                ExecuteCommand(command);
+            }
+
+            ImGuiListClipper parentClipper;
+            parentClipper.Begin((int)ObjectCount());
+            while (parentClipper.Step()) {
+                for (int i = parentClipper.DisplayStart; i < parentClipper.DisplayEnd; ++i) {
+                    if ((uint32_t)i == ActiveIndex()) continue;
+
+                    ObjectHandle handle = m_scene.HandleAt((uint32_t)i);
+                    char label[32];
+                    sprintf_s(label, "Object %u", handle.index);
+
+                    if (ImGui::Selectable(label, (uint32_t)i == parent)) {
+                        EditorCommand command = {EditorCommandType::SetActiveParent};
+                        command.object = handle;
+                        ExecuteCommand(command);
+                    }
+                }
+            }
+            ImGui::EndCombo();
+        }
     }
 
     ImGui::End();
@@ -1194,20 +1108,171 @@ void App::DrawSceneWindow() {
     ImGui::SetNextWindowSize(ImVec2(260, 80), ImGuiCond_FirstUseEver);
     ImGui::Begin("Color");
 
-    if (m_activeObject < m_objectCount) {
-        SceneObject& object = m_objects[m_activeObject];
+    if (ActiveIndex() != Scene::kInvalidIndex) {
+        DirectX::XMFLOAT4& objectColor = m_scene.Color(ActiveIndex());
 
         float color[4] = {
-            object.color.x,
-            object.color.y,
-            object.color.z,
-            object.color.w
+            objectColor.x,
+            objectColor.y,
+            objectColor.z,
+            objectColor.w
         };
 
         if (ImGui::ColorEdit4("Color", color)) {
-            object.color = DirectX::XMFLOAT4(color[0], color[1], color[2], color[3]);
+            objectColor = DirectX::XMFLOAT4(color[0], color[1], color[2], color[3]);
         }
     }
 
     ImGui::End();
-}
\ No newline at end of file
+}
+
+void App::DrawRenderStatsWindow() {
+    if (!m_engine) { return; }
+
+    ImGui::SetNextWindowPos(ImVec2(280, 280), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340, 420), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Render Stats");
+
+    if (ImGui::Button("Write render stats CSV")) {
+        FILE* f = nullptr;
+        if (_wfopen_s(&f, GetRenderStatsCsvPath().c_str(), L"w") == 0 && f) {
+            m_engine->WriteRenderStatsCsv(f);
+            fclose(f);
+        }
+    }
+
+    std::vector<RenderFrameStats> history = m_engine->GetRenderStatsHistory();
+    if (history.empty()) {
+        ImGui::Text("No frames rendered.");
+        ImGui::End();
+        return;
+    }
+
+    const RenderFrameStats& last = history.back();
+    ImGui::Text("Frame %llu", (unsigned long long)last.frame);
+    ImGui::Text("Draw calls: %u (%u instances, %llu vertices)", last.drawCalls, last.instances, (unsigned long long)last.verticesSubmitted);
+    ImGui::Text("Pipeline switches: %u", last.pipelineSwitches);
+    ImGui::Text("Root constant writes: %u, root SRV writes: %u", last.rootConstantWrites, last.rootSrvWrites);
+    ImGui::Text("Mesh uploads: %u (%u full), %u copies, %.1f KB", last.meshUploads, last.fullMeshUploads, last.copyCommands, last.meshUploadBytes / 1024.0);
+    ImGui::Text("Instances %.1f KB, gizmo %.1f KB, ring %.1f KB", last.instanceBytes / 1024.0, last.gizmoBytes / 1024.0, last.transientBytes / 1024.0);
+    ImGui::Text("UI: %u draw calls, %u vertices", last.uiDrawCalls, last.uiVertices);
+
+    // A full upload every frame (or a steady stream of mesh bytes while nothing is edited) is the usual regression.
+    uint32_t fullUploadFrames = 0;
+    uint64_t maxMeshBytes = 0;
+    for (const RenderFrameStats& stats : history) {
+        if (stats.fullMeshUploads > 0) { fullUploadFrames++; }
+        maxMeshBytes = (std::max)(maxMeshBytes, stats.meshUploadBytes);
+    }
+    ImGui::Separator();
+    ImGui::Text("Last %u frames: %u with full mesh uploads, max %.1f KB uploaded", (uint32_t)history.size(), fullUploadFrames, maxMeshBytes / 1024.0);
+
+    auto plot = [this, &history](const char* label, double (*value)(const RenderFrameStats&)) {
+        m_renderStatsPlot.clear();
+        for (const RenderFrameStats& stats : history) { m_renderStatsPlot.push_back((float)value(stats)); }
+        ImGui::PlotLines(label, m_renderStatsPlot.data(), (int)m_renderStatsPlot.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0.0f, 40.0f));
+    };
+    plot("Draw calls", [](const RenderFrameStats& stats) { return double(stats.drawCalls); });
+    plot("PSO switches", [](const RenderFrameStats& stats) { return double(stats.pipelineSwitches); });
+    plot("Vertices", [](const RenderFrameStats& stats) { return double(stats.verticesSubmitted); });
+    plot("Mesh KB", [](const RenderFrameStats& stats) { return stats.meshUploadBytes / 1024.0; });
+    plot("Ring KB", [](const RenderFrameStats& stats) { return stats.transientBytes / 1024.0; });
+
+    ImGui::End();
+}
+
+// Stable per-name colour so a zone keeps its colour from frame to frame.
+static ImU32 ProfileZoneColor(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c; ++c) { hash = (hash ^ (uint8_t)*c) * 16777619u; }
+    return IM_COL32(90 + (hash & 0x7F), 90 + ((hash >> 8) & 0x7F), 90 + ((hash >> 16) & 0x7F), 255);
+}
+
+void App::DrawProfilerWindow() {
+    ImGui::SetNextWindowPos(ImVec2(280, 10), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(720, 260), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Profiler");
+
+    Profiler& profiler = Profiler::Get();
+    bool enabled = profiler.IsEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) { profiler.SetEnabled(enabled); }
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &m_profilerPaused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::SliderInt("Frames", &m_profilerFrames, 1, 32);
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace")) {
+        FILE* f = nullptr;
+        if (_wfopen_s(&f, GetProfileTracePath().c_str(), L"w") == 0 && f) {
+            profiler.WriteChromeTrace(f);
+            fclose(f);
+        }
+    }
+
+    // One more start than frames shown: the last start closes the newest complete frame.
+    if (!m_profilerPaused) {
+        profiler.RecentFrameStarts((uint32_t)m_profilerFrames + 1, m_profilerFrameStarts);
+        if (m_profilerFrameStarts.size() >= 2) {
+            profiler.CollectZones(m_profilerFrameStarts.front(), m_profilerFrameStarts.back(), m_profilerZones);
+        }
+    }
+    if (m_profilerFrameStarts.size() < 2) {
+        ImGui::Text("No frames recorded.");
+        ImGui::End();
+        return;
+    }
+
+    uint64_t beginNs = m_profilerFrameStarts.front();
+    uint64_t endNs = m_profilerFrameStarts.back();
+    uint32_t frameCount = (uint32_t)m_profilerFrameStarts.size() - 1;
+    ImGui::Text("%u frames, %.2f ms per frame", frameCount, double(endNs - beginNs) / 1.0e6 / frameCount);
+
+    // Lanes per thread, one row per nesting depth; time runs left to right across the window.
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    ImGui::BeginChild("ProfilerLanes");
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float width = (std::max)(ImGui::GetContentRegionAvail().x, 1.0f);
+    double pixelsPerNs = double(width) / double(endNs - beginNs);
+    ImVec2 mouse = ImGui::GetIO().MousePos;
+
+    for (const ProfileThreadZones& thread : m_profilerZones) {
+        ImGui::Text("%s", thread.threadName.c_str());
+
+        uint32_t maxDepth = 0;
+        for (const ProfileZoneRecord& zone : thread.zones) { maxDepth = (std::max)(maxDepth, zone.depth); }
+
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float laneHeight = rowHeight * float(maxDepth + 1);
+        drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + laneHeight), IM_COL32(30, 30, 30, 255));
+        for (size_t i = 1; i + 1 < m_profilerFrameStarts.size(); ++i) {
+            float x = origin.x + float(double(m_profilerFrameStarts[i] - beginNs) * pixelsPerNs);
+            drawList->AddLine(ImVec2(x, origin.y), ImVec2(x, origin.y + laneHeight), IM_COL32(255, 255, 255, 60));
+        }
+
+        for (const ProfileZoneRecord& zone : thread.zones) {
+            uint64_t zoneBegin = (std::max)(zone.beginNs, beginNs);
+            uint64_t zoneEnd = (std::min)(zone.endNs, endNs);
+            float x0 = origin.x + float(double(zoneBegin - beginNs) * pixelsPerNs);
+            float x1 = (std::max)(origin.x + float(double(zoneEnd - beginNs) * pixelsPerNs), x0 + 1.0f);
+            float y0 = origin.y + rowHeight * float(zone.depth);
+            ImVec2 min(x0, y0);
+            ImVec2 max(x1, y0 + rowHeight - 1.0f);
+
+            drawList->AddRectFilled(min, max, ProfileZoneColor(zone.name));
+            if (x1 - x0 > 20.0f) {
+                drawList->PushClipRect(min, max, true);
+                drawList->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), zone.name);
+                drawList->PopClipRect();
+            }
+            if (ImGui::IsWindowHovered() && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+                ImGui::SetTooltip("%s\n%.3f ms", zone.name, double(zone.endNs - zone.beginNs) / 1.0e6);
+            }
+        }
+
+        ImGui::Dummy(ImVec2(width, laneHeight));
+    }
+    ImGui::EndChild();
+
+    ImGui::End();
+}
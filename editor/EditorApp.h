@@ -4,59 +4,45 @@
 #include <windowsx.h>
 #include <DirectXMath.h>
 #include <cstdint>
+#include <vector>
 #include "engine/core/Engine.h"
+#include "engine/core/FramePacer.h"
 #include "engine/core/HostApp.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/Profiler.h"
+#include "engine/core/RedrawPolicy.h"
 #include "editor/EditorCamera.h"
 #include "editor/EditorContext.h"
 #include "editor/EditorCommands.h"
 #include "editor/Gizmo.h"
+#include "editor/SceneDocument.h"
 #include "editor/modes/modeling/EditableMesh.h"
+#include "editor/modes/modeling/MeshBVH.h"
 #include "editor/modes/modeling/RenderMesh.h"
+#include "editor/modes/modeling/VertexPickGrid.h"
 
-struct ObjectTransform {
-    DirectX::XMFLOAT3 pos = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    DirectX::XMFLOAT3 rot = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
-    DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
-};
-
-struct SceneObject {
-    ObjectTransform transform;
-    EditableMesh editMesh;
-    RenderMesh renderMesh;
-    DirectX::XMFLOAT4 color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-};
-
-class App : public IHostApp {
+// The windowed editor: input, camera, gizmo, vertex/face selection and UI on top of the SceneDocument.
+class App : public IHostApp, public SceneDocument {
 public:
     App(EditorCamera& camera);
 
     EditorContext& Ctx() { return m_ctx; }
     void SetEngine(Engine* engine) { m_engine = engine; }
-    void SetMeshes(EditableMesh* editMesh, RenderMesh* renderMesh) { m_editMesh = editMesh; m_renderMesh = renderMesh; }
+    void SetFramePacer(FramePacer* pacer) { m_pacer = pacer; }
     void SetWindow(HWND hwnd) { m_hwnd = hwnd; m_ctx.hwnd = hwnd; }
 
     void BeginFrame() override;
-    void PumpMessages(MSG& msg) override;
+    bool PumpMessages(int& exitCode) override;
     void Update(const HostFrame& frame) override;
     void BuildFrameUI() override;
     void Render() override;
+    RedrawPolicy* Redraw() override { return &m_redraw; }
+    void WaitForEvents(double timeoutSeconds) override;
 
-    LRESULT HandleWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, bool& handled);
-
-    uint32_t ObjectCount() const { return m_objectCount; }
-    uint32_t ActiveObject() const { return m_activeObject; }
-    void SetActiveObject(uint32_t index);
-
-    bool AddObject(const DirectX::XMFLOAT3& pos);
-    bool DuplicateActiveObject();
-    bool DeleteActiveObject();
-    void ResetAllObjects();
+    // For changes that do not come from input or commands (loads finishing, external edits).
+    void RequestRedraw() { m_redraw.Request(RedrawReason::Dirty); }
 
-    bool SaveSceneAem(const wchar_t* path);
-    bool LoadSceneAem(const wchar_t* path);
-
-    bool GetActiveObjectTransform(DirectX::XMFLOAT3& pos, DirectX::XMFLOAT3& rot, DirectX::XMFLOAT3& scale) const;
-    bool SetActiveObjectTransform(const DirectX::XMFLOAT3& pos, const DirectX::XMFLOAT3& rot, const DirectX::XMFLOAT3& scale);
+    LRESULT HandleWindowMessage(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, bool& handled);
 
     bool ExecuteCommand(EditorCommandType type);
     bool ExecuteCommand(const EditorCommand& command);
@@ -90,19 +76,22 @@ private:
     };
 
     Engine* m_engine = nullptr;
+    FramePacer* m_pacer = nullptr;
+
+    // m_editMesh/m_renderMesh/m_meshBvh point into the active object's asset, see SyncActiveMesh.
     EditableMesh* m_editMesh = nullptr;
     RenderMesh* m_renderMesh = nullptr;
+    MeshBVH* m_meshBvh = nullptr;
 
     InputState m_input;
 
     bool m_isDragging = false; //dragging a gizmo
     int m_selectedVertex = -1;
     int m_selectedTriangle = -1;
+    double m_lastPickMs = 0.0;
+    VertexPickGrid m_vertexPickGrid; //screen-space buckets of the active object's vertices
     HWND m_hwnd = nullptr;
 
-    bool m_colorsInit = false;
-    DirectX::XMFLOAT4 m_baseColors[RenderMesh::kMaxDrawVertexCount] = {};
-
     EditorCamera m_camera;
     POINT m_lastCameraMouse = { 0, 0 };
 
@@ -113,24 +102,49 @@ private:
     const char* m_lastCommandName = "None";
     HostFrame m_frame = {};
 
-    static const uint32_t kMaxObjects = 16;
-    uint32_t m_objectCount = 2;
-    uint32_t m_activeObject = 0;
-    SceneObject m_objects[kMaxObjects] = {};
-
     Gizmo m_gizmo;
-
+    ObjectTransform m_gizmoTransform; //copy of the active transform the gizmo edits in place
+
+    // Profiler window: the last m_profilerFrames frames, kept as they were while paused.
+    int m_profilerFrames = 4;
+    bool m_profilerPaused = false;
+    std::vector<uint64_t> m_profilerFrameStarts;
+    std::vector<ProfileThreadZones> m_profilerZones;
+
+    std::vector<float> m_renderStatsPlot; //scratch for the Render Stats graphs
+
+    RedrawPolicy m_redraw;
+    // Process CPU time over wall time, resampled about once a second (see UpdateCpuUsage).
+    uint64_t m_cpuSampleWall100ns = 0;
+    uint64_t m_cpuSampleCpu100ns = 0;
+    uint64_t m_cpuSampleFrames = 0;
+    double m_cpuPercent = 0.0;
+    double m_renderedFps = 0.0;
+
+    void OnActiveObjectChanging() override;
+    void OnActiveObjectChanged() override;
+    void SyncActiveMesh();
+    void MakeActiveMeshUnique();
+
+    void SetSelectedVertex(int vertex);
     int HitTestVertex(int mouseX, int mouseY);
     int HitTestTriangle(int mouseX, int mouseY);
-    int HitTestObject(int mouseX, int mouseY) const;
+    int HitTestObject(int mouseX, int mouseY);
+    DirectX::XMMATRIX ObjectWorldMatrix(uint32_t index) const;
+    DirectX::XMMATRIX ObjectInverseWorldMatrix(uint32_t index) const;
     bool ScreenToWorldOnZPlane(int screenX, int screenY, float& worldX, float& worldY);
     DirectX::XMFLOAT3 LocalVertexToWorld(const DirectX::XMFLOAT3& p) const;
     DirectX::XMFLOAT3 WorldPointToLocal(const DirectX::XMFLOAT3& p) const;
     bool WorldToScreen(const DirectX::XMFLOAT3& worldPos, float& outScreenX, float& outScreenY) const;
     GizmoTarget BuildGizmoTarget();
     GizmoUpdateArgs BuildGizmoUpdateArgs(bool& outRenderMeshDirty);
+    void UpdateCamera(float dt);
     void UpdateViewProj();
     void FocusCamera();
+    bool IsAnimating() const;
+    void UpdateCpuUsage();
     EditorCamera* Cam() { return m_ctx.camera; }
     void DrawSceneWindow();
+    void DrawProfilerWindow();
+    void DrawRenderStatsWindow();
 };
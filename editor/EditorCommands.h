@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <DirectXMath.h>
+#include "editor/Scene.h"
 
 enum class EditorCommandType {
     None = 0,
@@ -15,9 +16,11 @@ enum class EditorCommandType {
     // Scene commands
     SaveScene,
     LoadScene,
+    LoadSceneAsync,      // returns once the load has started; see SceneDocument::BeginLoadScene
 
     // Transform commands
     SetActiveTransform,
+    SetActiveParent,
     SetGizmoMode,
     FocusCamera
 };
@@ -25,7 +28,7 @@ enum class EditorCommandType {
 struct EditorCommand {
     EditorCommandType type = EditorCommandType::None;
 
-    uint32_t objectIndex = 0;
+    ObjectHandle object;
     uint32_t gizmoMode = 0;
     const wchar_t* path = nullptr;
 
@@ -33,3 +36,20 @@ struct EditorCommand {
     DirectX::XMFLOAT3 rot = { 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT3 scale = { 1.0f, 1.0f, 1.0f };
 };
+
+inline const char* EditorCommandName(EditorCommandType type) {
+    switch (type) {
+    case EditorCommandType::AddObject: return "AddObject";
+    case EditorCommandType::DuplicateActiveObject: return "DuplicateActiveObject";
+    case EditorCommandType::DeleteActiveObject: return "DeleteActiveObject";
+    case EditorCommandType::SetActiveObject: return "SetActiveObject";
+    case EditorCommandType::SaveScene: return "SaveScene";
+    case EditorCommandType::LoadScene: return "LoadScene";
+    case EditorCommandType::LoadSceneAsync: return "LoadSceneAsync";
+    case EditorCommandType::SetActiveTransform: return "SetActiveTransform";
+    case EditorCommandType::SetActiveParent: return "SetActiveParent";
+    case EditorCommandType::SetGizmoMode: return "SetGizmoMode";
+    case EditorCommandType::FocusCamera: return "FocusCamera";
+    default: return "None";
+    }
+}
@@ -2,15 +2,19 @@
 #include <windowsx.h>
 #include <dxgi1_6.h>
 #include <d3dcompiler.h>
+#include <timeapi.h>
 #include <wrl/client.h>
 #include <cwchar>
 
 #include "editor/EditorPaths.h"
 #include "editor/modes/modeling/EditableMesh.h"
 #include "editor/modes/modeling/RenderMesh.h"
+#include "engine/gfx/D3D12GpuQueue.h"
 #include "engine/gfx/GraphicsDevice.h"
 #include "engine/core/Engine.h"
+#include "engine/core/FramePacer.h"
 #include "engine/core/HostRunner.h"
+#include "engine/core/JobSystem.h"
 #include "editor/EditorApp.h"
 #include "editor/EditorCommands.h"
 #include "third_party/imgui/imgui.h"
@@ -20,6 +24,7 @@
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
+#pragma comment(lib, "winmm.lib")
 
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
@@ -28,25 +33,46 @@ using namespace DirectX;
 const int WINDOW_WIDTH = 800;
 const int WINDOW_HEIGHT = 600;
 
+// Threads for the job system, main thread included. 0 = one per core, 1 = run every job inline on the
+// main thread in submission order (deterministic debugging).
+const uint32_t JOB_THREAD_COUNT = 0;
+
+// Frames the CPU may record ahead of the GPU (2 or 3). Each has its own command allocator; their
+// transient data shares the engine's upload ring.
+const uint32_t FRAMES_IN_FLIGHT = 2;
+const uint32_t SWAP_CHAIN_BUFFER_COUNT = (FRAMES_IN_FLIGHT > 2) ? 3 : 2;
+
+// Record and present on a dedicated render thread while the next frame updates. false = render inline
+// at the end of each frame.
+const bool USE_RENDER_THREAD = true;
+
+// Only run frames when input, a command, a held key or drag, or a timer asks for one, and otherwise
+// block on the message queue. Can be toggled in the Scene window.
+const bool USE_IDLE_REDRAW = true;
+
+// Frame rate cap on top of vsync, 0 = none. 24 previews the game runtime's pacing (the editor has no
+// fixed-step simulation of its own, so only frames are paced).
+const double FRAME_RATE_LIMIT = 0.0;
+
 // Global variables
 HWND g_hwnd = nullptr;
 ComPtr<ID3D12Device> g_device;
-ComPtr<ID3D12CommandAllocator> g_commandAllocator;
-ComPtr<ID3D12GraphicsCommandList> g_commandList;
 ComPtr<ID3D12RootSignature> g_rootSignature;
 ComPtr<ID3D12PipelineState> g_pipelineState;
 ComPtr<ID3D12PipelineState> g_pipelineStateLine;
 ComPtr<ID3D12PipelineState> g_pipelineStateLineOccluded;
 ComPtr<ID3D12PipelineState> g_pipelineStateGizmo;
 ComPtr<ID3D12PipelineState> g_pipelineStateGizmoOccluded;
-ComPtr<ID3D12Resource> g_vertexBuffer;
+ComPtr<ID3D12PipelineState> g_pipelineStateIndexed;
+ComPtr<ID3D12PipelineState> g_pipelineStateInstanced;
+ComPtr<ID3D12PipelineState> g_pipelineStateInstancedIndexed;
 ComPtr<ID3D12Resource> g_vertexBufferGrid;
 uint32_t g_gridVertexCount = 0;
-ComPtr<ID3D12Fence> g_fence;
-UINT64 g_fenceValue;
-HANDLE g_fenceEvent;
 GraphicsDevice g_gfx;
+D3D12GpuQueue g_gpuQueue;
 Engine g_engine;
+JobSystem g_jobs;
+FramePacer g_framePacer;
 EditorCamera g_editorCamera;
 App g_app(g_editorCamera);
 
@@ -59,15 +85,11 @@ struct InputState {
     bool lmbReleased = false;  // edge: went up this frame
 };
 
-EditableMesh g_editMesh;
-RenderMesh   g_renderMesh;
-
 // Forward declarations
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 void InitializeWindow(HINSTANCE hInstance);
 void InitializeDirect3D();
 void CreatePipelineState();
-void CreateVertexBuffer();
 void CreateGridVertexBuffer();
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 void InitializeImGui();
@@ -76,14 +98,11 @@ void ShutdownImGui();
 static void ShutdownD3D() {
     g_engine.WaitForGpu();
 
-    if (g_fenceEvent) {
-        CloseHandle(g_fenceEvent);
-        g_fenceEvent = nullptr;
-    }
-
     g_vertexBufferGrid.Reset();
-    g_vertexBuffer.Reset();
 
+    g_pipelineStateInstancedIndexed.Reset();
+    g_pipelineStateInstanced.Reset();
+    g_pipelineStateIndexed.Reset();
     g_pipelineStateGizmoOccluded.Reset();
     g_pipelineStateGizmo.Reset();
     g_pipelineStateLineOccluded.Reset();
@@ -91,10 +110,7 @@ static void ShutdownD3D() {
     g_pipelineState.Reset();
     g_rootSignature.Reset();
 
-    g_commandList.Reset();
-    g_commandAllocator.Reset();
-
-    g_fence.Reset();
+    g_gpuQueue.Shutdown();
     g_device.Reset();
 }
 
@@ -102,22 +118,42 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPSTR, _In
     InitializeWindow(hInstance);
     InitializeDirect3D();
     CreatePipelineState();
-    CreateVertexBuffer();
     CreateGridVertexBuffer();
 
     g_editorCamera.SetLens(DirectX::XM_PIDIV4, 0.1f, 1000.0f);
     g_engine.SetGraphicsDevice(&g_gfx);
-    g_engine.SetRenderObjects(g_commandAllocator.Get(), g_commandList.Get(), g_rootSignature.Get(), g_pipelineState.Get(), g_pipelineStateLine.Get(), g_pipelineStateLineOccluded.Get(), g_pipelineStateGizmo.Get(), g_pipelineStateGizmoOccluded.Get(), g_fence.Get(), g_fenceEvent, &g_fenceValue, g_vertexBuffer.Get(), g_vertexBufferGrid.Get(), g_gridVertexCount, WINDOW_WIDTH, WINDOW_HEIGHT);
-    g_engine.UpdateVertexBuffer(&g_editMesh, &g_renderMesh, g_hwnd);
+    if (!g_engine.InitializeFrames(&g_gpuQueue, FRAMES_IN_FLIGHT)) {
+        MessageBox(g_hwnd, L"Engine frame resources could not be created.", L"Error", MB_OK);
+        return 1;
+    }
+    g_engine.SetRenderObjects(g_rootSignature.Get(), g_pipelineState.Get(), g_pipelineStateLine.Get(), g_pipelineStateLineOccluded.Get(), g_pipelineStateGizmo.Get(), g_pipelineStateGizmoOccluded.Get(), g_vertexBufferGrid.Get(), g_gridVertexCount, WINDOW_WIDTH, WINDOW_HEIGHT);
+    g_engine.SetIndexedPipeline(g_pipelineStateIndexed.Get());
+    g_engine.SetInstancedPipelines(g_pipelineStateInstanced.Get(), g_pipelineStateInstancedIndexed.Get());
     g_engine.SetObjectCount(2);
     g_app.SetWindow(g_hwnd);
     g_app.SetEngine(&g_engine);
-    g_app.SetMeshes(&g_editMesh, &g_renderMesh);
+
+    g_jobs.Initialize(JOB_THREAD_COUNT);
+    g_app.SetJobSystem(&g_jobs);
+    g_app.Redraw()->SetIdleEnabled(USE_IDLE_REDRAW);
+    g_app.SetFramePacer(&g_framePacer);
 
     InitializeImGui();
+    if (USE_RENDER_THREAD) { g_engine.StartRenderThread(); }
+
+    // Frame times are recorded either way; the pacer only waits with a limit. A 1 ms timer resolution
+    // keeps its sleeps short of the deadline instead of a whole scheduler tick.
+    HostLoopConfig loop;
+    loop.pacer = &g_framePacer;
+    g_framePacer.SetTargetFrameRate(FRAME_RATE_LIMIT);
+    if (FRAME_RATE_LIMIT > 0.0) { timeBeginPeriod(1); }
+
+    int exitCode = HostRunner::Run(g_app, loop);
 
-    int exitCode = HostRunner::Run(g_app);
+    if (FRAME_RATE_LIMIT > 0.0) { timeEndPeriod(1); }
 
+    g_engine.StopRenderThread();
+    g_jobs.Shutdown();
     ShutdownImGui();
     ShutdownD3D();
     return exitCode;
@@ -212,7 +248,7 @@ void InitializeDirect3D() {
         return;
     }
 
-    if (!g_gfx.CreateSwapChain(factory.Get(), g_hwnd, WINDOW_WIDTH, WINDOW_HEIGHT, DXGI_FORMAT_R8G8B8A8_UNORM, 2)) {
+    if (!g_gfx.CreateSwapChain(factory.Get(), g_hwnd, WINDOW_WIDTH, WINDOW_HEIGHT, DXGI_FORMAT_R8G8B8A8_UNORM, SWAP_CHAIN_BUFFER_COUNT)) {
         MessageBox(g_hwnd, L"CreateSwapChain failed.", L"Error", MB_OK);
         PostQuitMessage(0);
         return;
@@ -220,7 +256,7 @@ void InitializeDirect3D() {
 
     g_gfx.SetFrameIndexFromSwapChain();
 
-    if (!g_gfx.CreateRTVs(g_device.Get(), DXGI_FORMAT_R8G8B8A8_UNORM, 2)) {
+    if (!g_gfx.CreateRTVs(g_device.Get(), DXGI_FORMAT_R8G8B8A8_UNORM, SWAP_CHAIN_BUFFER_COUNT)) {
         MessageBox(g_hwnd, L"CreateRTVs failed.", L"Error", MB_OK);
         PostQuitMessage(0);
         return;
@@ -238,19 +274,18 @@ void InitializeDirect3D() {
         return;
     }
 
-    g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&g_commandAllocator));
-    g_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, g_commandAllocator.Get(), nullptr, IID_PPV_ARGS(&g_commandList));
-    g_commandList->Close();
-
-    g_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&g_fence));
-    g_fenceValue = 1;
-    g_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!g_gpuQueue.Initialize(g_device.Get(), g_gfx.Queue())) {
+        MessageBox(g_hwnd, L"Fence creation failed.", L"Error", MB_OK);
+        PostQuitMessage(0);
+        return;
+    }
 }
 
 void CreatePipelineState() {
-    CD3DX12_ROOT_PARAMETER rootParams[2]; // Create root signature
+    CD3DX12_ROOT_PARAMETER rootParams[3]; // Create root signature
     rootParams[0].InitAsConstants(16, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // Root param 0: 16 32-bit constants for a 4x4 matrix at b0 (vertex shader)
     rootParams[1].InitAsConstants(4, 1, 0, D3D12_SHADER_VISIBILITY_PIXEL);   // Root param 1: 4  32-bit constants for a float4 tint at b1 (pixel shader)
+    rootParams[2].InitAsShaderResourceView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // Root param 2: per-instance structured buffer at t0 (instanced VS only)
     CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
     rootSignatureDesc.Init(_countof(rootParams), rootParams, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -347,6 +382,132 @@ void CreatePipelineState() {
         return;
     }
 
+    // Indexed mesh PSO: vertices are shared between faces, so the per-face color is looked up
+    // from SV_PrimitiveID (palette must match RenderMesh::FaceColor). Vertex color is an overlay
+    // (selection highlight) blended over the face color by its alpha.
+    const char* pixelShaderIndexedSource = R"(
+        cbuffer TintCB : register(b1) {
+            float4 uTint;
+        };
+
+        struct PSInput {
+            float4 position : SV_POSITION;
+            float4 color : COLOR;
+        };
+
+        static const float4 kFaceColors[4] = {
+            float4(1, 0, 0, 1),
+            float4(0, 1, 0, 1),
+            float4(0, 0, 1, 1),
+            float4(1, 1, 0, 1)
+        };
+
+        float4 PSMain(PSInput input, uint primitiveId : SV_PrimitiveID) : SV_TARGET {
+            float4 face = kFaceColors[primitiveId % 4];
+            float3 rgb = lerp(face.rgb, input.color.rgb, saturate(input.color.a));
+            return float4(rgb, 1.0f) * uTint;
+        }
+    )";
+
+    ComPtr<ID3DBlob> pixelShaderIndexed;
+    if (FAILED(D3DCompile(pixelShaderIndexedSource, strlen(pixelShaderIndexedSource), nullptr, nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShaderIndexed, &error))) {
+        if (error) {
+            OutputDebugStringA(static_cast<char*>(error->GetBufferPointer()));
+        }
+        return;
+    }
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC indexedPso = psoDesc;
+    indexedPso.PS = { pixelShaderIndexed->GetBufferPointer(), pixelShaderIndexed->GetBufferSize() };
+    if (FAILED(g_device->CreateGraphicsPipelineState(&indexedPso, IID_PPV_ARGS(&g_pipelineStateIndexed)))) {
+        return;
+    }
+
+    // Instanced PSOs: one draw per mesh, each instance reads its world matrix and tint from the
+    // structured buffer at t0 (layout = InstanceData in engine/gfx/DrawList.h). b0 holds only ViewProj.
+    const char* vertexShaderInstancedSource = R"(
+        cbuffer CameraCB : register(b0) {
+            row_major float4x4 uViewProj;
+        };
+
+        struct InstanceData {
+            row_major float4x4 world;
+            float4 tint;
+        };
+
+        StructuredBuffer<InstanceData> gInstances : register(t0);
+
+        struct PSInput {
+            float4 position : SV_POSITION;
+            float4 color : COLOR;
+            nointerpolation float4 tint : TINT;
+        };
+
+        PSInput VSMain(float3 position : POSITION, float4 color : COLOR, uint instanceId : SV_InstanceID) {
+            InstanceData instance = gInstances[instanceId];
+            PSInput result;
+            result.position = mul(mul(float4(position, 1.0f), instance.world), uViewProj);
+            result.color = color;
+            result.tint = instance.tint;
+            return result;
+        }
+    )";
+
+    const char* pixelShaderInstancedSource = R"(
+        struct PSInput {
+            float4 position : SV_POSITION;
+            float4 color : COLOR;
+            nointerpolation float4 tint : TINT;
+        };
+
+        float4 PSMain(PSInput input) : SV_TARGET {
+            return input.color * input.tint;
+        }
+    )";
+
+    const char* pixelShaderInstancedIndexedSource = R"(
+        struct PSInput {
+            float4 position : SV_POSITION;
+            float4 color : COLOR;
+            nointerpolation float4 tint : TINT;
+        };
+
+        static const float4 kFaceColors[4] = {
+            float4(1, 0, 0, 1),
+            float4(0, 1, 0, 1),
+            float4(0, 0, 1, 1),
+            float4(1, 1, 0, 1)
+        };
+
+        float4 PSMain(PSInput input, uint primitiveId : SV_PrimitiveID) : SV_TARGET {
+            float4 face = kFaceColors[primitiveId % 4];
+            float3 rgb = lerp(face.rgb, input.color.rgb, saturate(input.color.a));
+            return float4(rgb, 1.0f) * input.tint;
+        }
+    )";
+
+    ComPtr<ID3DBlob> vertexShaderInstanced;
+    ComPtr<ID3DBlob> pixelShaderInstanced;
+    ComPtr<ID3DBlob> pixelShaderInstancedIndexed;
+    bool instancedCompiled =
+        SUCCEEDED(D3DCompile(vertexShaderInstancedSource, strlen(vertexShaderInstancedSource), nullptr, nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &vertexShaderInstanced, &error)) &&
+        SUCCEEDED(D3DCompile(pixelShaderInstancedSource, strlen(pixelShaderInstancedSource), nullptr, nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShaderInstanced, &error)) &&
+        SUCCEEDED(D3DCompile(pixelShaderInstancedIndexedSource, strlen(pixelShaderInstancedIndexedSource), nullptr, nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &pixelShaderInstancedIndexed, &error));
+
+    // Optional: if these fail the engine keeps drawing one object per draw call.
+    if (!instancedCompiled) {
+        if (error) { OutputDebugStringA(static_cast<char*>(error->GetBufferPointer())); }
+    } else {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC instancedPso = psoDesc;
+        instancedPso.VS = { vertexShaderInstanced->GetBufferPointer(), vertexShaderInstanced->GetBufferSize() };
+        instancedPso.PS = { pixelShaderInstanced->GetBufferPointer(), pixelShaderInstanced->GetBufferSize() };
+        g_device->CreateGraphicsPipelineState(&instancedPso, IID_PPV_ARGS(&g_pipelineStateInstanced));
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC instancedIndexedPso = instancedPso;
+        instancedIndexedPso.PS = { pixelShaderInstancedIndexed->GetBufferPointer(), pixelShaderInstancedIndexed->GetBufferSize() };
+        g_device->CreateGraphicsPipelineState(&instancedIndexedPso, IID_PPV_ARGS(&g_pipelineStateInstancedIndexed));
+    }
+
     // Create a line PSO for drawing the editor grid.
     // We reuse the same shaders and root signature, but switch topology type to LINE.
     // Depth test stays on so the grid respects scene depth, but we disable depth writes
@@ -393,9 +554,7 @@ void CreateGridVertexBuffer() {
 
     const uint32_t linesPerDir = uint32_t(2 * N + 1);
     const uint32_t lineCount = linesPerDir * 2; // X-parallel + Z-parallel
-    const uint32_t baseGridVertexCount = lineCount * 2;
-    const uint32_t gizmoVertexCount = 18; // 3 axes * (2 triangles * 3 verts)
-    g_gridVertexCount = baseGridVertexCount + gizmoVertexCount;
+    g_gridVertexCount = lineCount * 2;
 
     Vertex* verts = new Vertex[g_gridVertexCount];
     uint32_t v = 0;
@@ -421,11 +580,6 @@ void CreateGridVertexBuffer() {
         verts[v++] = { XMFLOAT3(k, y,  halfSize), colZ };
     }
 
-    // Reserve tail vertices for the translate gizmo (written every frame by the editor).
-    for (; v < g_gridVertexCount; ++v) {
-        verts[v] = { XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f) };
-    }
-
     const UINT vbSize = sizeof(Vertex) * g_gridVertexCount;
 
     CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
@@ -448,51 +602,6 @@ void CreateGridVertexBuffer() {
     delete[] verts;
 }
 
-void CreateVertexBuffer() {
-    // Create editable tetrahedron, then build GPU draw vertices from editable topology.
-    const float s = 0.8f;
-    g_editMesh.BuildTetrahedron(s);
-
-    if (!g_renderMesh.BuildFromEditable(g_editMesh)) {
-        MessageBox(g_hwnd, L"BuildFromEditable failed.", L"Error", MB_OK);
-        return;
-    }
-
-    const UINT vertexBufferSize = sizeof(Vertex) * RenderMesh::kMaxDrawVertexCount;
-
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize);
-
-    HRESULT hr = g_device->CreateCommittedResource(
-        &heapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &resourceDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&g_vertexBuffer)
-    );
-
-    if (FAILED(hr) || !g_vertexBuffer) {
-        MessageBox(g_hwnd, L"Create vertex buffer failed.", L"Error", MB_OK);
-        return;
-    }
-
-    // Initial upload. Copy the full bounded buffer so unused slots are initialized too.
-    UINT8* pVertexDataBegin = nullptr;
-    D3D12_RANGE readRange = { 0, 0 };
-
-    hr = g_vertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin));
-    if (FAILED(hr) || !pVertexDataBegin) {
-        MessageBox(g_hwnd, L"Map vertex buffer failed.", L"Error", MB_OK);
-        return;
-    }
-
-    memcpy(pVertexDataBegin, g_renderMesh.drawVertices, vertexBufferSize);
-    g_vertexBuffer->Unmap(0, nullptr);
-
-    g_renderMesh.dirty = false;
-}
-
 void InitializeImGui() {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -505,7 +614,7 @@ void InitializeImGui() {
     ImGui_ImplDX12_InitInfo initInfo = {};
     initInfo.Device = g_device.Get();
     initInfo.CommandQueue = g_gfx.Queue();
-    initInfo.NumFramesInFlight = 2;
+    initInfo.NumFramesInFlight = FRAMES_IN_FLIGHT;
     initInfo.RTVFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
     initInfo.DSVFormat = DXGI_FORMAT_D32_FLOAT;
     initInfo.SrvDescriptorHeap = g_gfx.SrvHeap();
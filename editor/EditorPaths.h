@@ -29,6 +29,22 @@ inline std::wstring GetDefaultScenePath() {
     return GetDefaultSceneDirectory() + L"\\scene.aem";
 }
 
+inline std::wstring GetDefaultBinaryScenePath() {
+    return GetDefaultSceneDirectory() + L"\\scene.aeb";
+}
+
+inline std::wstring GetFrameTimingReportPath() {
+    return GetExecutableDirectory() + L"\\frame_timing.txt";
+}
+
+inline std::wstring GetRenderStatsCsvPath() {
+    return GetExecutableDirectory() + L"\\render_stats.csv";
+}
+
+inline std::wstring GetProfileTracePath() {
+    return GetExecutableDirectory() + L"\\profile_trace.json";
+}
+
 inline void EnsureDefaultSceneDirectoryExists() {
     std::wstring exeDir = GetExecutableDirectory();
     std::wstring assetsDir = exeDir + L"\\assets";
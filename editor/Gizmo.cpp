@@ -36,12 +36,18 @@ const char* Gizmo::GetModeName() const {
     }
 }
 
-XMFLOAT3 Gizmo::LocalVertexToWorld(const XMFLOAT3& point, const XMFLOAT3& objectPos, const XMFLOAT3& objectRot, const XMFLOAT3& objectScale) const {
-    XMMATRIX scaleMat = XMMatrixScaling(objectScale.x, objectScale.y, objectScale.z);
-    XMMATRIX rotMat = XMMatrixRotationRollPitchYaw(objectRot.x, objectRot.y, objectRot.z);
-    XMMATRIX transMat = XMMatrixTranslation(objectPos.x, objectPos.y, objectPos.z);
+static XMMATRIX ObjectWorld(const GizmoTransformRef& transform) {
+    XMMATRIX scaleMat = XMMatrixScaling(transform.scale->x, transform.scale->y, transform.scale->z);
+    XMMATRIX rotMat = XMMatrixRotationRollPitchYaw(transform.rot->x, transform.rot->y, transform.rot->z);
+    XMMATRIX transMat = XMMatrixTranslation(transform.pos->x, transform.pos->y, transform.pos->z);
 
     XMMATRIX worldMat = scaleMat * rotMat * transMat;
+    if (transform.parentWorld) { worldMat = worldMat * XMLoadFloat4x4(transform.parentWorld); }
+    return worldMat;
+}
+
+XMFLOAT3 Gizmo::LocalVertexToWorld(const XMFLOAT3& point, const GizmoTransformRef& transform) const {
+    XMMATRIX worldMat = ObjectWorld(transform);
 
     XMVECTOR local = XMVectorSet(point.x, point.y, point.z, 1.0f);
     XMVECTOR world = XMVector3TransformCoord(local, worldMat);
@@ -51,13 +57,8 @@ XMFLOAT3 Gizmo::LocalVertexToWorld(const XMFLOAT3& point, const XMFLOAT3& object
     return out;
 }
 
-XMFLOAT3 Gizmo::WorldPointToLocal(const XMFLOAT3& point, const XMFLOAT3& objectPos, const XMFLOAT3& objectRot, const XMFLOAT3& objectScale) const {
-    XMMATRIX scaleMat = XMMatrixScaling(objectScale.x, objectScale.y, objectScale.z);
-    XMMATRIX rotMat = XMMatrixRotationRollPitchYaw(objectRot.x, objectRot.y, objectRot.z);
-    XMMATRIX transMat = XMMatrixTranslation(objectPos.x, objectPos.y, objectPos.z);
-
-    XMMATRIX worldMat = scaleMat * rotMat * transMat;
-    XMMATRIX invWorldMat = XMMatrixInverse(nullptr, worldMat);
+XMFLOAT3 Gizmo::WorldPointToLocal(const XMFLOAT3& point, const GizmoTransformRef& transform) const {
+    XMMATRIX invWorldMat = XMMatrixInverse(nullptr, ObjectWorld(transform));
 
     XMVECTOR world = XMVectorSet(point.x, point.y, point.z, 1.0f);
     XMVECTOR local = XMVector3TransformCoord(world, invWorldMat);
@@ -67,13 +68,31 @@ XMFLOAT3 Gizmo::WorldPointToLocal(const XMFLOAT3& point, const XMFLOAT3& objectP
     return out;
 }
 
+// Object position (in its parent's space) to world space and back. Identity for root objects.
+XMFLOAT3 Gizmo::ParentPointToWorld(const XMFLOAT3& point, const GizmoTransformRef& transform) const {
+    if (!transform.parentWorld) { return point; }
+
+    XMFLOAT3 out;
+    XMStoreFloat3(&out, XMVector3TransformCoord(XMLoadFloat3(&point), XMLoadFloat4x4(transform.parentWorld)));
+    return out;
+}
+
+XMFLOAT3 Gizmo::WorldPointToParent(const XMFLOAT3& point, const GizmoTransformRef& transform) const {
+    if (!transform.parentWorld) { return point; }
+
+    XMMATRIX invParent = XMMatrixInverse(nullptr, XMLoadFloat4x4(transform.parentWorld));
+    XMFLOAT3 out;
+    XMStoreFloat3(&out, XMVector3TransformCoord(XMLoadFloat3(&point), invParent));
+    return out;
+}
+
 XMFLOAT3 Gizmo::GetOrigin(const GizmoTarget& target) const {
     if (target.selectedVertex != -1) {
         XMFLOAT3 localPos = target.editMesh->GetVertex((VertexID)target.selectedVertex);
-        return LocalVertexToWorld(localPos, *target.transform.pos, *target.transform.rot, *target.transform.scale);
+        return LocalVertexToWorld(localPos, target.transform);
     }
 
-    return *target.transform.pos;
+    return ParentPointToWorld(*target.transform.pos, target.transform);
 }
 
 bool Gizmo::ComputeAxisScreenDirection(HWND hwnd, EditorCamera& camera, const GizmoTarget& target, int axis, XMFLOAT2& outDir) const {
@@ -413,9 +432,9 @@ void Gizmo::Update(const GizmoUpdateArgs& args) {
 
             if (selectedVertex != -1) {
                 XMFLOAT3 localPos = editMesh->GetVertex((VertexID)selectedVertex);
-                m_startPos = LocalVertexToWorld(localPos, objectPos, objectRot, objectScale);
+                m_startPos = LocalVertexToWorld(localPos, target.transform);
             } else {
-                m_startPos = objectPos;
+                m_startPos = ParentPointToWorld(objectPos, target.transform);
             }
 
             m_startScale = objectScale;
@@ -468,11 +487,11 @@ void Gizmo::Update(const GizmoUpdateArgs& args) {
                     );
 
                     if (selectedVertex != -1) {
-                        XMFLOAT3 localPos = WorldPointToLocal(newPos, objectPos, objectRot, objectScale);
+                        XMFLOAT3 localPos = WorldPointToLocal(newPos, target.transform);
                         editMesh->SetVertex((VertexID)selectedVertex, localPos);
                         *args.outRenderMeshDirty = true;
                     } else {
-                        objectPos = newPos;
+                        objectPos = WorldPointToParent(newPos, target.transform);
                     }
                 } else if (m_mode == GizmoMode::Scale) {
                     const float minScale = 0.05f;
@@ -17,6 +17,7 @@ struct GizmoTransformRef {
     DirectX::XMFLOAT3* pos = nullptr;
     DirectX::XMFLOAT3* rot = nullptr;
     DirectX::XMFLOAT3* scale = nullptr;
+    const DirectX::XMFLOAT4X4* parentWorld = nullptr; //null for root objects; pos/rot/scale are local to it
 };
 
 struct GizmoTarget {
@@ -74,8 +75,10 @@ private:
     int m_dragStartMouseY = 0;
     DirectX::XMFLOAT2 m_rotateAxisScreenDir = { 1.0f, 0.0f };
 
-    DirectX::XMFLOAT3 LocalVertexToWorld(const DirectX::XMFLOAT3& point, const DirectX::XMFLOAT3& objectPos, const DirectX::XMFLOAT3& objectRot, const DirectX::XMFLOAT3& objectScale) const;
-    DirectX::XMFLOAT3 WorldPointToLocal(const DirectX::XMFLOAT3& point, const DirectX::XMFLOAT3& objectPos, const DirectX::XMFLOAT3& objectRot, const DirectX::XMFLOAT3& objectScale) const;
+    DirectX::XMFLOAT3 LocalVertexToWorld(const DirectX::XMFLOAT3& point, const GizmoTransformRef& transform) const;
+    DirectX::XMFLOAT3 WorldPointToLocal(const DirectX::XMFLOAT3& point, const GizmoTransformRef& transform) const;
+    DirectX::XMFLOAT3 ParentPointToWorld(const DirectX::XMFLOAT3& point, const GizmoTransformRef& transform) const;
+    DirectX::XMFLOAT3 WorldPointToParent(const DirectX::XMFLOAT3& point, const GizmoTransformRef& transform) const;
     DirectX::XMFLOAT3 GetOrigin(const GizmoTarget& target) const;
     bool ComputeAxisScreenDirection(HWND hwnd, EditorCamera& camera, const GizmoTarget& target, int axis, DirectX::XMFLOAT2& outDir) const;
     void BuildVertices(Vertex* gizmoVerts, HWND hwnd, EditorCamera& camera, const GizmoTarget& target);
@@ -0,0 +1,70 @@
+#include "editor/MeshAssets.h"
+
+MeshAssetID MeshAssetRegistry::Create() {
+    MeshAssetID id = kInvalidMeshAssetID;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = (MeshAssetID)m_slots.size();
+        m_slots.push_back(Slot{});
+        m_slots[id].asset.reset(new MeshAsset());
+    }
+
+    Slot& slot = m_slots[id];
+    slot.refCount = 0;
+    slot.alive = true;
+    m_aliveCount++;
+    return id;
+}
+
+void MeshAssetRegistry::AddRef(MeshAssetID id) {
+    if (!IsAlive(id)) { return; }
+    m_slots[id].refCount++;
+}
+
+void MeshAssetRegistry::Release(MeshAssetID id) {
+    if (!IsAlive(id)) { return; }
+
+    Slot& slot = m_slots[id];
+    if (slot.refCount > 0) { slot.refCount--; }
+    if (slot.refCount > 0) { return; }
+
+    // Drop the geometry but keep the MeshAsset object: pointers handed out earlier stay safe to
+    // touch (they just see an empty mesh) and the next Create reuses the allocation.
+    MeshAsset& asset = *slot.asset;
+    asset.editMesh.Clear();
+    asset.renderMesh.Clear();
+    asset.bvh.Clear();
+
+    slot.alive = false;
+    m_freeIds.push_back(id);
+    m_aliveCount--;
+}
+
+MeshAssetID MeshAssetRegistry::MakeUnique(MeshAssetID id) {
+    if (!IsAlive(id)) { return kInvalidMeshAssetID; }
+    if (m_slots[id].refCount <= 1) { return id; }
+
+    MeshAssetID copyId = Create();
+    const MeshAsset& source = *m_slots[id].asset;
+    MeshAsset& copy = *m_slots[copyId].asset;
+
+    copy.editMesh = source.editMesh;
+    copy.renderMesh = source.renderMesh;
+    copy.renderMesh.MarkAllDirty(); //new GPU buffers, so everything uploads once
+    copy.renderMesh.indicesDirty = true;
+    copy.bvh.Clear(); //rebuilt on the next pick (it is keyed on the mesh address)
+
+    m_slots[copyId].refCount = 1;
+    m_slots[id].refCount--;
+    return copyId;
+}
+
+size_t MeshAssetRegistry::MemoryBytes() const {
+    size_t bytes = m_slots.capacity() * sizeof(Slot) + m_freeIds.capacity() * sizeof(MeshAssetID);
+    for (const Slot& slot : m_slots) {
+        if (slot.asset) { bytes += sizeof(MeshAsset) + slot.asset->MemoryBytes(); }
+    }
+    return bytes;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "editor/modes/modeling/EditableMesh.h"
+#include "editor/modes/modeling/MeshBVH.h"
+#include "editor/modes/modeling/RenderMesh.h"
+
+using MeshAssetID = uint32_t;
+static constexpr MeshAssetID kInvalidMeshAssetID = 0xFFFFFFFFu;
+
+// One unique mesh: edit data, its draw data and the picking BVH derived from it.
+// Scene objects are instances that reference an asset by id, so geometry exists once per unique mesh.
+struct MeshAsset {
+    EditableMesh editMesh;
+    RenderMesh renderMesh;
+    MeshBVH bvh; //local space, built lazily from editMesh
+
+    size_t MemoryBytes() const { return editMesh.MemoryBytes() + renderMesh.MemoryBytes(); }
+};
+
+// Reference-counted MeshAsset storage. Each instance holds one reference; an asset is freed when
+// its last reference goes away and its id is reused by the next Create.
+// Sharing is copy-on-write: call MakeUnique before editing an asset through one instance.
+// Assets are heap-allocated per slot, so pointers from Get stay valid while the id is alive.
+class MeshAssetRegistry {
+public:
+    // New empty asset with no references. Fill it through Get, then AddRef once per user.
+    MeshAssetID Create();
+
+    void AddRef(MeshAssetID id);
+    void Release(MeshAssetID id);
+    uint32_t RefCount(MeshAssetID id) const { return IsAlive(id) ? m_slots[id].refCount : 0; }
+
+    // Returns an id the caller holds alone: id itself when it is not shared, otherwise a copy.
+    // The caller's reference moves from id to the returned asset.
+    MeshAssetID MakeUnique(MeshAssetID id);
+
+    bool IsAlive(MeshAssetID id) const { return id < m_slots.size() && m_slots[id].alive; }
+    MeshAsset* Get(MeshAssetID id) { return IsAlive(id) ? m_slots[id].asset.get() : nullptr; }
+    const MeshAsset* Get(MeshAssetID id) const { return IsAlive(id) ? m_slots[id].asset.get() : nullptr; }
+
+    // Ids are dense slot indices; iterate [0, SlotCount()) and skip ids that are not alive.
+    uint32_t SlotCount() const { return (uint32_t)m_slots.size(); }
+    uint32_t AliveCount() const { return m_aliveCount; }
+    size_t MemoryBytes() const;
+
+private:
+    struct Slot {
+        std::unique_ptr<MeshAsset> asset; // kept after free so the allocation is reused
+        uint32_t refCount = 0;
+        bool alive = false;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<MeshAssetID> m_freeIds;
+    uint32_t m_aliveCount = 0;
+};
@@ -0,0 +1,351 @@
+#include "editor/Scene.h"
+#include "engine/core/JobSystem.h"
+
+#include <algorithm>
+
+// Below this many matrices a parallel rebuild costs more in scheduling than it saves.
+static const uint32_t kParallelRebuildMinimum = 4096;
+
+void Scene::Clear() {
+    // Slots are kept (and their generations bumped) so handles from before the clear stay invalid.
+    m_freeSlot = kInvalidIndex;
+    for (uint32_t i = (uint32_t)m_slots.size(); i-- > 0;) {
+        Slot& slot = m_slots[i];
+        if (slot.alive) {
+            slot.alive = false;
+            slot.generation = (slot.generation == 0xFFFFFFFFu) ? 1 : slot.generation + 1;
+        }
+        slot.dense = m_freeSlot;
+        m_freeSlot = i;
+    }
+
+    m_transforms.clear();
+    m_colors.clear();
+    m_meshes.clear();
+    m_denseToSlot.clear();
+    m_parents.clear();
+    m_subtreeSizes.clear();
+    m_orderPos.clear();
+    m_order.clear();
+    m_worlds.clear();
+    m_inverseWorlds.clear();
+    m_dirty.clear();
+    m_dirtyList.clear();
+}
+
+void Scene::Reserve(uint32_t count) {
+    m_slots.reserve(count);
+    m_transforms.reserve(count);
+    m_colors.reserve(count);
+    m_meshes.reserve(count);
+    m_denseToSlot.reserve(count);
+    m_parents.reserve(count);
+    m_subtreeSizes.reserve(count);
+    m_orderPos.reserve(count);
+    m_order.reserve(count);
+    m_worlds.reserve(count);
+    m_inverseWorlds.reserve(count);
+    m_dirty.reserve(count);
+}
+
+ObjectHandle Scene::Add(const ObjectTransform& transform, const DirectX::XMFLOAT4& color, uint32_t mesh) {
+    uint32_t slotIndex = m_freeSlot;
+    if (slotIndex != kInvalidIndex) {
+        m_freeSlot = m_slots[slotIndex].dense;
+    } else {
+        slotIndex = (uint32_t)m_slots.size();
+        m_slots.push_back(Slot{});
+    }
+
+    uint32_t dense = (uint32_t)m_transforms.size();
+    m_transforms.push_back(transform);
+    m_colors.push_back(color);
+    m_meshes.push_back(mesh);
+    m_denseToSlot.push_back(slotIndex);
+    m_parents.push_back(kInvalidIndex);
+    m_subtreeSizes.push_back(1);
+    m_orderPos.push_back((uint32_t)m_order.size());
+    m_order.push_back(dense);
+    m_worlds.push_back(DirectX::XMFLOAT4X4());
+    m_inverseWorlds.push_back(DirectX::XMFLOAT4X4());
+    m_dirty.push_back(0);
+    MarkDirty(dense);
+
+    Slot& slot = m_slots[slotIndex];
+    slot.dense = dense;
+    slot.alive = true;
+
+    return ObjectHandle{ slotIndex, slot.generation };
+}
+
+bool Scene::Remove(ObjectHandle handle) {
+    uint32_t dense = IndexOf(handle);
+    if (dense == kInvalidIndex) { return false; }
+
+    // Children move up to the removed object's parent. In preorder they already sit inside the
+    // grandparent's range, so taking the object out of m_order keeps every subtree contiguous.
+    uint32_t parent = m_parents[dense];
+    uint32_t pos = m_orderPos[dense];
+    uint32_t end = pos + m_subtreeSizes[dense];
+    for (uint32_t p = pos + 1; p < end; ++p) {
+        uint32_t child = m_order[p];
+        if (m_parents[child] == dense) {
+            m_parents[child] = parent;
+            MarkDirty(child);
+        }
+    }
+    for (uint32_t a = parent; a != kInvalidIndex; a = m_parents[a]) { m_subtreeSizes[a]--; }
+    uint32_t hole = pos;
+    if (parent == kInvalidIndex && end == pos + 1) {
+        // A root without children. Roots may come in any order, so the last root without children takes
+        // its place and only the subtrees behind that one shift (usually none), not everything after pos.
+        uint32_t fill = (uint32_t)m_order.size() - 1;
+        while (fill > pos) {
+            uint32_t root = m_order[fill];
+            while (m_parents[root] != kInvalidIndex) { root = m_parents[root]; }
+            if (m_subtreeSizes[root] == 1) { break; }
+            fill = m_orderPos[root] - 1;
+        }
+        m_order[pos] = m_order[fill];
+        m_orderPos[m_order[pos]] = pos;
+        hole = fill;
+    }
+    m_order.erase(m_order.begin() + hole);
+    UpdateOrderPositions(hole, (uint32_t)m_order.size());
+
+    // Swap the last object into the hole and repoint its slot, its order entry and its children.
+    uint32_t last = Count() - 1;
+    if (dense != last) {
+        m_transforms[dense] = m_transforms[last];
+        m_colors[dense] = m_colors[last];
+        m_meshes[dense] = m_meshes[last];
+        m_denseToSlot[dense] = m_denseToSlot[last];
+        m_slots[m_denseToSlot[dense]].dense = dense;
+
+        m_parents[dense] = m_parents[last];
+        m_subtreeSizes[dense] = m_subtreeSizes[last];
+        m_orderPos[dense] = m_orderPos[last];
+        m_order[m_orderPos[dense]] = dense;
+        for (uint32_t p = m_orderPos[dense] + 1; p < m_orderPos[dense] + m_subtreeSizes[dense]; ++p) {
+            if (m_parents[m_order[p]] == last) { m_parents[m_order[p]] = dense; }
+        }
+
+        m_worlds[dense] = m_worlds[last];
+        m_inverseWorlds[dense] = m_inverseWorlds[last];
+        m_dirty[dense] = 0;
+        MarkDirty(dense); //same matrix, but consumers keyed by dense index must see the move
+    }
+
+    m_transforms.pop_back();
+    m_colors.pop_back();
+    m_meshes.pop_back();
+    m_denseToSlot.pop_back();
+    m_parents.pop_back();
+    m_subtreeSizes.pop_back();
+    m_orderPos.pop_back();
+    m_worlds.pop_back();
+    m_inverseWorlds.pop_back();
+    m_dirty.pop_back();
+
+    Slot& slot = m_slots[handle.index];
+    slot.alive = false;
+    slot.generation = (slot.generation == 0xFFFFFFFFu) ? 1 : slot.generation + 1; // 0 is reserved for invalid
+    slot.dense = m_freeSlot;
+    m_freeSlot = handle.index;
+    return true;
+}
+
+uint32_t Scene::IndexOf(ObjectHandle handle) const {
+    if (handle.index >= m_slots.size()) { return kInvalidIndex; }
+
+    const Slot& slot = m_slots[handle.index];
+    if (!slot.alive || slot.generation != handle.generation) { return kInvalidIndex; }
+    return slot.dense;
+}
+
+ObjectHandle Scene::HandleAt(uint32_t index) const {
+    if (index >= Count()) { return ObjectHandle{}; }
+
+    uint32_t slotIndex = m_denseToSlot[index];
+    return ObjectHandle{ slotIndex, m_slots[slotIndex].generation };
+}
+
+void Scene::SetTransform(uint32_t index, const ObjectTransform& transform) {
+    m_transforms[index] = transform;
+    MarkDirty(index);
+}
+
+void Scene::MarkDirty(uint32_t index) {
+    if (m_dirty[index]) { return; }
+    m_dirty[index] = 1;
+    m_dirtyList.push_back(index);
+}
+
+void Scene::UpdateOrderPositions(uint32_t begin, uint32_t end) {
+    for (uint32_t p = begin; p < end; ++p) { m_orderPos[m_order[p]] = p; }
+}
+
+bool Scene::SetParent(uint32_t index, uint32_t parent) {
+    if (index >= Count()) { return false; }
+    if (parent != kInvalidIndex && parent >= Count()) { return false; }
+    if (m_parents[index] == parent) { return true; }
+
+    uint32_t pos = m_orderPos[index];
+    uint32_t size = m_subtreeSizes[index];
+    if (parent != kInvalidIndex && m_orderPos[parent] >= pos && m_orderPos[parent] < pos + size) { return false; } //would make a cycle
+
+    // The subtree goes right after the new parent's current range (the end of m_order for roots).
+    // Sizes are read before any are changed, so a new parent that already contains the subtree still
+    // ends past it and the rotate just moves the subtree behind its siblings.
+    uint32_t end = (parent == kInvalidIndex) ? Count() : m_orderPos[parent] + m_subtreeSizes[parent];
+
+    for (uint32_t a = m_parents[index]; a != kInvalidIndex; a = m_parents[a]) { m_subtreeSizes[a] -= size; }
+    for (uint32_t a = parent; a != kInvalidIndex; a = m_parents[a]) { m_subtreeSizes[a] += size; }
+    m_parents[index] = parent;
+
+    if (pos < end) {
+        std::rotate(m_order.begin() + pos, m_order.begin() + pos + size, m_order.begin() + end);
+        UpdateOrderPositions(pos, end);
+    } else {
+        std::rotate(m_order.begin() + end, m_order.begin() + pos, m_order.begin() + pos + size);
+        UpdateOrderPositions(end, pos + size);
+    }
+
+    MarkDirty(index);
+    return true;
+}
+
+void Scene::BuildHierarchyOrder(uint32_t count, uint32_t* parents, std::vector<uint32_t>& order) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parents[i] >= count || parents[i] == i) { parents[i] = kInvalidIndex; }
+    }
+
+    // Each object has one parent, so every cycle is found by walking up from some object into its own
+    // path. In index order SetParent accepts every link of a cycle but the one of its highest index.
+    std::vector<uint8_t> state(count, 0); //0 unvisited, 1 on the current path, 2 done
+    std::vector<uint32_t> path;
+    for (uint32_t i = 0; i < count; ++i) {
+        path.clear();
+        uint32_t at = i;
+        while (at != kInvalidIndex && state[at] == 0) {
+            state[at] = 1;
+            path.push_back(at);
+            at = parents[at];
+        }
+        if (at != kInvalidIndex && state[at] == 1) {
+            uint32_t highest = at;
+            for (uint32_t a = parents[at]; a != at; a = parents[a]) { highest = (std::max)(highest, a); }
+            parents[highest] = kInvalidIndex;
+        }
+        for (uint32_t a : path) { state[a] = 2; }
+    }
+
+    // Children grouped by parent (counting sort), then a preorder walk from the roots.
+    std::vector<uint32_t> childStart(count + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parents[i] != kInvalidIndex) { childStart[parents[i] + 1]++; }
+    }
+    for (uint32_t i = 0; i < count; ++i) { childStart[i + 1] += childStart[i]; }
+    std::vector<uint32_t> children(childStart[count]);
+    std::vector<uint32_t> cursor(childStart.begin(), childStart.end() - 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parents[i] != kInvalidIndex) { children[cursor[parents[i]]++] = i; }
+    }
+
+    order.clear();
+    order.reserve(count);
+    std::vector<uint32_t> stack;
+    for (uint32_t root = 0; root < count; ++root) {
+        if (parents[root] != kInvalidIndex) { continue; }
+        stack.push_back(root);
+        while (!stack.empty()) {
+            uint32_t object = stack.back();
+            stack.pop_back();
+            order.push_back(object);
+            for (uint32_t c = childStart[object + 1]; c-- > childStart[object];) { stack.push_back(children[c]); }
+        }
+    }
+}
+
+void Scene::SetParents(const uint32_t* parents) {
+    const uint32_t count = Count();
+    m_parents.assign(parents, parents + count);
+    BuildHierarchyOrder(count, m_parents.data(), m_order);
+    UpdateOrderPositions(0, count);
+
+    // Children follow their parent in m_order, so sizes add up back to front.
+    for (uint32_t i = 0; i < count; ++i) { m_subtreeSizes[i] = 1; }
+    for (uint32_t p = count; p-- > 0;) {
+        uint32_t object = m_order[p];
+        if (m_parents[object] != kInvalidIndex) { m_subtreeSizes[m_parents[object]] += m_subtreeSizes[object]; }
+    }
+
+    for (uint32_t i = 0; i < count; ++i) { MarkDirty(i); }
+}
+
+void Scene::RebuildWorld(uint32_t index) const {
+    const ObjectTransform& transform = m_transforms[index];
+    DirectX::XMMATRIX S = DirectX::XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z);
+    DirectX::XMMATRIX R = DirectX::XMMatrixRotationRollPitchYaw(transform.rot.x, transform.rot.y, transform.rot.z);
+    DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(transform.pos.x, transform.pos.y, transform.pos.z);
+    DirectX::XMMATRIX W = S * R * T;
+
+    // The parent comes earlier in m_order, so its matrix is already current.
+    uint32_t parent = m_parents[index];
+    if (parent != kInvalidIndex) { W = W * DirectX::XMLoadFloat4x4(&m_worlds[parent]); }
+
+    DirectX::XMStoreFloat4x4(&m_worlds[index], W);
+    DirectX::XMStoreFloat4x4(&m_inverseWorlds[index], DirectX::XMMatrixInverse(nullptr, W));
+
+    m_dirty[index] = 0;
+}
+
+void Scene::PropagateWorldMatrices(JobSystem* jobs) const {
+    m_dirtyPositions.clear();
+    for (uint32_t index : m_dirtyList) {
+        if (index < Count() && m_dirty[index]) { m_dirtyPositions.push_back(m_orderPos[index]); }
+    }
+    m_dirtyList.clear();
+
+    // Each flagged object rebuilds its whole subtree range. Sorted front to back, a flagged object
+    // inside a range that is already listed is covered by it, so the ranges come out disjoint and
+    // clean subtrees are never visited.
+    std::sort(m_dirtyPositions.begin(), m_dirtyPositions.end());
+    m_rebuildRanges.clear();
+    uint32_t rebuildCount = 0;
+    for (uint32_t pos : m_dirtyPositions) {
+        if (!m_rebuildRanges.empty() && pos < m_rebuildRanges.back().second) { continue; }
+
+        uint32_t end = pos + m_subtreeSizes[m_order[pos]];
+        m_rebuildRanges.push_back(std::make_pair(pos, end));
+        rebuildCount += end - pos;
+    }
+
+    // A range only reads its root's parent, which is outside every range, so ranges are independent.
+    auto rebuildRanges = [this](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; ++r) {
+            for (uint32_t p = m_rebuildRanges[r].first; p < m_rebuildRanges[r].second; ++p) { RebuildWorld(m_order[p]); }
+        }
+    };
+
+    if (jobs && rebuildCount >= kParallelRebuildMinimum && m_rebuildRanges.size() > 1) {
+        jobs->ParallelFor((uint32_t)m_rebuildRanges.size(), 16, rebuildRanges);
+    } else {
+        rebuildRanges(0, (uint32_t)m_rebuildRanges.size());
+    }
+
+    for (const auto& range : m_rebuildRanges) {
+        m_changed.insert(m_changed.end(), m_order.begin() + range.first, m_order.begin() + range.second);
+    }
+    m_matrixRebuildCount += rebuildCount;
+}
+
+uint32_t Scene::UpdateWorldMatrices(JobSystem* jobs) {
+    uint64_t before = m_matrixRebuildCount;
+    if (!m_dirtyList.empty()) { PropagateWorldMatrices(jobs); }
+    return uint32_t(m_matrixRebuildCount - before);
+}
+
+void Scene::ClearChanged() {
+    m_changed.clear();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+
+// Local to the object's parent (world space for root objects).
+struct ObjectTransform {
+    DirectX::XMFLOAT3 pos = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+    DirectX::XMFLOAT3 rot = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+    DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+};
+
+// Stable object identity. index picks a slot, generation tells whether the slot still holds the
+// object the handle was made for, so handles to deleted objects fail instead of aliasing a new one.
+// generation 0 is never issued, which makes a default-constructed handle invalid.
+struct ObjectHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return generation != 0; }
+    bool operator==(const ObjectHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
+
+// Scene object storage: dense structure-of-arrays (transforms, colors, mesh refs) plus a slot table
+// mapping handles to dense indices. Removal swaps the last object into the hole, so the dense arrays
+// stay packed for per-frame loops. Dense indices are NOT stable; handles are.
+// No platform or GPU types here, so this is usable from tools and headless code.
+//
+// Each object caches its world matrix (S * R * T * parent world) and the inverse. Transforms are only
+// written through SetTransform, which flags the object; the matrices are rebuilt on the next World /
+// InverseWorld / UpdateWorldMatrices, so a static scene rebuilds nothing.
+//
+// Hierarchy: every object has a parent dense index (kInvalidIndex for roots). m_order lists the
+// objects in preorder, so parents come before children and every subtree is one contiguous range.
+// Propagation walks only the ranges of flagged objects, front to back, in one linear pass.
+// Reparenting moves one subtree range with std::rotate instead of re-sorting the array.
+class Scene {
+public:
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    void Clear();
+    void Reserve(uint32_t count);
+
+    // mesh is the object's MeshAssetID. The Scene only stores it; reference counting is up to the caller.
+    // New objects are roots. Removing an object moves its children up to its parent; their local
+    // transforms are kept. Removal is O(1) for the dense arrays plus a shift of the hierarchy order behind
+    // the object; a root without children only shifts the subtrees that follow the last childless root.
+    ObjectHandle Add(const ObjectTransform& transform, const DirectX::XMFLOAT4& color, uint32_t mesh = 0);
+    bool Remove(ObjectHandle handle);
+
+    bool IsAlive(ObjectHandle handle) const { return IndexOf(handle) != kInvalidIndex; }
+    uint32_t IndexOf(ObjectHandle handle) const;
+    ObjectHandle HandleAt(uint32_t index) const;
+
+    uint32_t Count() const { return (uint32_t)m_transforms.size(); }
+
+    const ObjectTransform& Transform(uint32_t index) const { return m_transforms[index]; }
+    void SetTransform(uint32_t index, const ObjectTransform& transform);
+    DirectX::XMFLOAT4& Color(uint32_t index) { return m_colors[index]; }
+    const DirectX::XMFLOAT4& Color(uint32_t index) const { return m_colors[index]; }
+    uint32_t Mesh(uint32_t index) const { return m_meshes[index]; }
+    void SetMesh(uint32_t index, uint32_t mesh) { m_meshes[index] = mesh; }
+
+    const std::vector<ObjectTransform>& Transforms() const { return m_transforms; }
+    const std::vector<DirectX::XMFLOAT4>& Colors() const { return m_colors; }
+    const std::vector<uint32_t>& Meshes() const { return m_meshes; }
+
+    // parent = kInvalidIndex makes the object a root. Fails (returns false) if parent is the object
+    // itself or one of its descendants. The local transform is kept, so the object follows its new parent.
+    bool SetParent(uint32_t index, uint32_t parent);
+    // Sets every object's parent at once (parents[i] for dense index i, kInvalidIndex for roots) and
+    // rebuilds the hierarchy order in O(n), where a SetParent per object moves O(n) entries each.
+    // Links out of range, and links SetParent in index order would reject as cycles, leave a root.
+    void SetParents(const uint32_t* parents);
+    // The hierarchy SetParents builds, for count objects outside a Scene: bad links in parents are
+    // replaced by kInvalidIndex and order gets a preorder of [0, count) (parents before children).
+    static void BuildHierarchyOrder(uint32_t count, uint32_t* parents, std::vector<uint32_t>& order);
+    uint32_t Parent(uint32_t index) const { return m_parents[index]; }
+    uint32_t SubtreeSize(uint32_t index) const { return m_subtreeSizes[index]; } //the object plus all descendants
+    const std::vector<uint32_t>& HierarchyOrder() const { return m_order; }
+
+    // Any pending change is propagated first, so these are always current.
+    const DirectX::XMFLOAT4X4& World(uint32_t index) const { if (!m_dirtyList.empty()) { PropagateWorldMatrices(); } return m_worlds[index]; }
+    const DirectX::XMFLOAT4X4& InverseWorld(uint32_t index) const { if (!m_dirtyList.empty()) { PropagateWorldMatrices(); } return m_inverseWorlds[index]; }
+
+    // Rebuilds every flagged object and its descendants. Returns how many matrices were rebuilt.
+    // With a job system, large updates rebuild independent subtrees in parallel.
+    uint32_t UpdateWorldMatrices(JobSystem* jobs = nullptr);
+
+    // Dense indices whose matrices were rebuilt since ClearChanged (call once per frame, first).
+    // An object moved by a swap-remove also shows up here, since its index changed.
+    void ClearChanged();
+    const std::vector<uint32_t>& ChangedThisFrame() const { return m_changed; }
+    uint32_t MatrixRebuildsThisFrame() const { return (uint32_t)m_changed.size(); }
+    uint64_t MatrixRebuildCount() const { return m_matrixRebuildCount; }
+
+private:
+    struct Slot {
+        uint32_t dense = kInvalidIndex; // dense index while alive, next free slot while free
+        uint32_t generation = 1;
+        bool alive = false;
+    };
+
+    std::vector<Slot> m_slots;
+    uint32_t m_freeSlot = kInvalidIndex;
+
+    // Dense, parallel arrays. m_denseToSlot lets a swap-remove fix the moved object's slot.
+    std::vector<ObjectTransform> m_transforms;
+    std::vector<DirectX::XMFLOAT4> m_colors;
+    std::vector<uint32_t> m_meshes;
+    std::vector<uint32_t> m_denseToSlot;
+
+    // Hierarchy, parallel to the dense arrays except m_order (preorder list of dense indices).
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_subtreeSizes;
+    std::vector<uint32_t> m_orderPos; //position of each object in m_order
+    std::vector<uint32_t> m_order;
+
+    // World matrix cache, parallel to the dense arrays. m_dirtyList may hold stale or repeated
+    // indices; m_dirty is the truth. A flag means "this object and its whole subtree".
+    mutable std::vector<DirectX::XMFLOAT4X4> m_worlds;
+    mutable std::vector<DirectX::XMFLOAT4X4> m_inverseWorlds;
+    mutable std::vector<uint8_t> m_dirty;
+    mutable std::vector<uint32_t> m_dirtyList;
+    mutable std::vector<uint32_t> m_dirtyPositions; //scratch: order positions of flagged objects
+    mutable std::vector<std::pair<uint32_t, uint32_t>> m_rebuildRanges; //scratch: disjoint [begin, end) of m_order
+    mutable std::vector<uint32_t> m_changed;
+    mutable uint64_t m_matrixRebuildCount = 0;
+
+    void MarkDirty(uint32_t index);
+    void PropagateWorldMatrices(JobSystem* jobs = nullptr) const;
+    void RebuildWorld(uint32_t index) const;
+    void UpdateOrderPositions(uint32_t begin, uint32_t end);
+};
@@ -0,0 +1,254 @@
+#include "editor/SceneBVH.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace DirectX;
+
+static SceneAabb Union(const SceneAabb& a, const SceneAabb& b) {
+    SceneAabb out;
+    out.min = XMFLOAT3((std::min)(a.min.x, b.min.x), (std::min)(a.min.y, b.min.y), (std::min)(a.min.z, b.min.z));
+    out.max = XMFLOAT3((std::max)(a.max.x, b.max.x), (std::max)(a.max.y, b.max.y), (std::max)(a.max.z, b.max.z));
+    return out;
+}
+
+static float HalfArea(const SceneAabb& box) {
+    float dx = box.max.x - box.min.x;
+    float dy = box.max.y - box.min.y;
+    float dz = box.max.z - box.min.z;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static bool Overlaps(const SceneAabb& a, const SceneAabb& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+        a.min.y <= b.max.y && b.min.y <= a.max.y &&
+        a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+bool SceneBVH::RayHitsBox(const XMFLOAT3& origin, const XMFLOAT3& invDir, const SceneAabb& box, float maxT, float& tEnter) {
+    float tx0 = (box.min.x - origin.x) * invDir.x;
+    float tx1 = (box.max.x - origin.x) * invDir.x;
+    float tmin = (std::min)(tx0, tx1);
+    float tmax = (std::max)(tx0, tx1);
+
+    float ty0 = (box.min.y - origin.y) * invDir.y;
+    float ty1 = (box.max.y - origin.y) * invDir.y;
+    tmin = (std::max)(tmin, (std::min)(ty0, ty1));
+    tmax = (std::min)(tmax, (std::max)(ty0, ty1));
+
+    float tz0 = (box.min.z - origin.z) * invDir.z;
+    float tz1 = (box.max.z - origin.z) * invDir.z;
+    tmin = (std::max)(tmin, (std::min)(tz0, tz1));
+    tmax = (std::min)(tmax, (std::max)(tz0, tz1));
+
+    tEnter = (std::max)(tmin, 0.0f); // origin inside the box enters at 0
+    return tmax >= tEnter && tEnter <= maxT;
+}
+
+void SceneBVH::Clear() {
+    m_nodes.clear();
+    m_root = kNull;
+    m_freeList = kNull;
+    m_proxyCount = 0;
+}
+
+int32_t SceneBVH::AllocateNode() {
+    if (m_freeList == kNull) {
+        m_nodes.push_back(Node{});
+        return int32_t(m_nodes.size() - 1);
+    }
+
+    int32_t node = m_freeList;
+    m_freeList = m_nodes[node].parent;
+    m_nodes[node] = Node{};
+    return node;
+}
+
+void SceneBVH::FreeNode(int32_t node) {
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+int32_t SceneBVH::CreateProxy(const SceneAabb& box, uint32_t userData) {
+    int32_t proxy = AllocateNode();
+    m_nodes[proxy].box = box;
+    m_nodes[proxy].userData = userData;
+    m_nodes[proxy].height = 0;
+
+    InsertLeaf(proxy);
+    m_proxyCount++;
+    return proxy;
+}
+
+void SceneBVH::DestroyProxy(int32_t proxy) {
+    if (proxy < 0 || proxy >= int32_t(m_nodes.size()) || !m_nodes[proxy].IsLeaf()) { return; }
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_proxyCount--;
+}
+
+void SceneBVH::MoveProxy(int32_t proxy, const SceneAabb& box) {
+    if (proxy < 0 || proxy >= int32_t(m_nodes.size()) || !m_nodes[proxy].IsLeaf()) { return; }
+
+    bool farMove = !Overlaps(m_nodes[proxy].box, box);
+    if (farMove) {
+        RemoveLeaf(proxy);
+        m_nodes[proxy].box = box;
+        InsertLeaf(proxy);
+        return;
+    }
+
+    m_nodes[proxy].box = box;
+    for (int32_t node = m_nodes[proxy].parent; node != kNull; node = m_nodes[node].parent) {
+        const Node& n = m_nodes[node];
+        m_nodes[node].box = Union(m_nodes[n.child1].box, m_nodes[n.child2].box);
+    }
+}
+
+void SceneBVH::InsertLeaf(int32_t leaf) {
+    if (m_root == kNull) {
+        m_root = leaf;
+        m_nodes[leaf].parent = kNull;
+        return;
+    }
+
+    // Descend towards the cheapest sibling: at each node compare making the leaf its sibling here
+    // against the cheapest possible cost of pushing it further down either child.
+    const SceneAabb leafBox = m_nodes[leaf].box;
+    int32_t index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+
+        float area = HalfArea(node.box);
+        float combinedArea = HalfArea(Union(node.box, leafBox));
+
+        float cost = 2.0f * combinedArea;                 // new parent here
+        float inheritance = 2.0f * (combinedArea - area); // growth every ancestor below pays
+
+        float childCost[2];
+        int32_t children[2] = { node.child1, node.child2 };
+        for (int c = 0; c < 2; ++c) {
+            const Node& child = m_nodes[children[c]];
+            float grown = HalfArea(Union(child.box, leafBox));
+            childCost[c] = child.IsLeaf() ? grown + inheritance : (grown - HalfArea(child.box)) + inheritance;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1]) { break; }
+        index = (childCost[0] < childCost[1]) ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = m_nodes[sibling].parent;
+
+    int32_t newParent = AllocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].box = Union(leafBox, m_nodes[sibling].box);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == kNull) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    FixUpwards(m_nodes[leaf].parent);
+}
+
+void SceneBVH::RemoveLeaf(int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = kNull;
+        return;
+    }
+
+    int32_t parent = m_nodes[leaf].parent;
+    int32_t grandParent = m_nodes[parent].parent;
+    int32_t sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent == kNull) {
+        m_root = sibling;
+        m_nodes[sibling].parent = kNull;
+        FreeNode(parent);
+        return;
+    }
+
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    m_nodes[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    FixUpwards(grandParent);
+}
+
+// Rebalances and refits every node from `node` up to the root.
+void SceneBVH::FixUpwards(int32_t node) {
+    while (node != kNull) {
+        node = Balance(node);
+
+        Node& n = m_nodes[node];
+        n.height = 1 + (std::max)(m_nodes[n.child1].height, m_nodes[n.child2].height);
+        n.box = Union(m_nodes[n.child1].box, m_nodes[n.child2].box);
+
+        node = n.parent;
+    }
+}
+
+// If one child of A is more than one level taller, rotate it up. Returns the node now at A's position.
+int32_t SceneBVH::Balance(int32_t iA) {
+    Node* A = &m_nodes[iA];
+    if (A->IsLeaf() || A->height < 2) { return iA; }
+
+    int32_t iB = A->child1;
+    int32_t iC = A->child2;
+    int32_t balance = m_nodes[iC].height - m_nodes[iB].height;
+
+    if (balance > 1 || balance < -1) {
+        // Rotate the taller child (iUp) above A; A keeps the shorter child (iKeep).
+        int32_t iUp = (balance > 1) ? iC : iB;
+        int32_t iKeep = (balance > 1) ? iB : iC;
+
+        Node* up = &m_nodes[iUp];
+        int32_t iF = up->child1;
+        int32_t iG = up->child2;
+
+        up->child1 = iA;
+        up->parent = A->parent;
+        A->parent = iUp;
+
+        if (up->parent == kNull) {
+            m_root = iUp;
+        } else if (m_nodes[up->parent].child1 == iA) {
+            m_nodes[up->parent].child1 = iUp;
+        } else {
+            m_nodes[up->parent].child2 = iUp;
+        }
+
+        // The taller grandchild stays under `up`, the shorter one moves down to A.
+        int32_t iTall = (m_nodes[iF].height > m_nodes[iG].height) ? iF : iG;
+        int32_t iShort = (iTall == iF) ? iG : iF;
+
+        up->child2 = iTall;
+        A->child1 = iKeep;
+        A->child2 = iShort;
+        m_nodes[iShort].parent = iA;
+
+        A->box = Union(m_nodes[iKeep].box, m_nodes[iShort].box);
+        A->height = 1 + (std::max)(m_nodes[iKeep].height, m_nodes[iShort].height);
+
+        up->box = Union(A->box, m_nodes[iTall].box);
+        up->height = 1 + (std::max)(A->height, m_nodes[iTall].height);
+        return iUp;
+    }
+
+    return iA;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+struct SceneAabb {
+    DirectX::XMFLOAT3 min = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 max = { 0.0f, 0.0f, 0.0f };
+};
+
+// Dynamic AABB tree over world-space object bounds (one leaf per object).
+// Insertions pick the sibling that grows the tree's surface area least and AVL-style rotations keep
+// it balanced, so objects can be added, removed and moved every frame without full rebuilds.
+class SceneBVH {
+public:
+    static const int32_t kNull = -1;
+
+    void Clear();
+
+    int32_t CreateProxy(const SceneAabb& box, uint32_t userData);
+    void DestroyProxy(int32_t proxy);
+
+    // Small moves refit the leaf's ancestors; a box that no longer overlaps its old one is reinserted
+    // so the tree does not degrade when objects jump far away.
+    void MoveProxy(int32_t proxy, const SceneAabb& box);
+
+    void SetUserData(int32_t proxy, uint32_t userData) { m_nodes[proxy].userData = userData; }
+    uint32_t UserData(int32_t proxy) const { return m_nodes[proxy].userData; }
+    const SceneAabb& Bounds(int32_t proxy) const { return m_nodes[proxy].box; }
+
+    uint32_t ProxyCount() const { return m_proxyCount; }
+    int32_t Height() const { return m_root == kNull ? 0 : m_nodes[m_root].height; }
+
+    // Visits leaves whose box the ray enters before maxT, nearer boxes first.
+    // visit(userData, tEnter) returns the new maxT, so a precise hit prunes everything behind it.
+    template <typename Visit>
+    void Raycast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir, float maxT, Visit&& visit) const;
+
+private:
+    struct Node {
+        SceneAabb box;
+        int32_t parent = kNull; // next free node while on the free list
+        int32_t child1 = kNull;
+        int32_t child2 = kNull;
+        int32_t height = 0;     // leaf = 0, free = -1
+        uint32_t userData = 0;
+
+        bool IsLeaf() const { return child1 == kNull; }
+    };
+
+    std::vector<Node> m_nodes;
+    int32_t m_root = kNull;
+    int32_t m_freeList = kNull;
+    uint32_t m_proxyCount = 0;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    void FixUpwards(int32_t node);
+    int32_t Balance(int32_t a);
+
+    static bool RayHitsBox(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& invDir, const SceneAabb& box, float maxT, float& tEnter);
+};
+
+template <typename Visit>
+void SceneBVH::Raycast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir, float maxT, Visit&& visit) const {
+    if (m_root == kNull) { return; }
+
+    DirectX::XMFLOAT3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+    struct Entry {
+        int32_t node;
+        float tEnter;
+    };
+
+    std::vector<Entry> stack;
+    stack.reserve(64);
+
+    float tRoot = 0.0f;
+    if (!RayHitsBox(origin, invDir, m_nodes[m_root].box, maxT, tRoot)) { return; }
+    stack.push_back(Entry{ m_root, tRoot });
+
+    while (!stack.empty()) {
+        Entry entry = stack.back();
+        stack.pop_back();
+
+        if (entry.tEnter > maxT) { continue; } // something closer was hit since this was pushed
+
+        const Node& node = m_nodes[entry.node];
+        if (node.IsLeaf()) {
+            maxT = visit(node.userData, entry.tEnter);
+            continue;
+        }
+
+        float t1 = 0.0f;
+        float t2 = 0.0f;
+        bool hit1 = RayHitsBox(origin, invDir, m_nodes[node.child1].box, maxT, t1);
+        bool hit2 = RayHitsBox(origin, invDir, m_nodes[node.child2].box, maxT, t2);
+
+        // Push the farther child first so the nearer one is popped next.
+        if (hit1 && hit2) {
+            if (t1 <= t2) {
+                stack.push_back(Entry{ node.child2, t2 });
+                stack.push_back(Entry{ node.child1, t1 });
+            } else {
+                stack.push_back(Entry{ node.child1, t1 });
+                stack.push_back(Entry{ node.child2, t2 });
+            }
+        } else if (hit1) {
+            stack.push_back(Entry{ node.child1, t1 });
+        } else if (hit2) {
+            stack.push_back(Entry{ node.child2, t2 });
+        }
+    }
+}
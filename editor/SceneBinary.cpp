@@ -0,0 +1,159 @@
+#include "editor/SceneBinary.h"
+
+namespace {
+
+struct SectionSource {
+    SceneBinarySectionType type;
+    uint32_t elementBytes;
+    uint64_t count;
+    const void* data;
+};
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + kSceneBinaryAlignment - 1) & ~(uint64_t)(kSceneBinaryAlignment - 1);
+}
+
+bool Fail(std::string* error, const char* message) {
+    if (error) { *error = message; }
+    return false;
+}
+
+// Points out at the section's array. Missing sections fail, except empty ones, which a writer may drop.
+template <typename T>
+bool FindSection(const unsigned char* base, const SceneBinarySection* sections, uint32_t sectionCount,
+    SceneBinarySectionType type, uint64_t expectedCount, const T*& out, std::string* error) {
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        const SceneBinarySection& section = sections[i];
+        if (section.type != (uint32_t)type) { continue; }
+
+        if (section.elementBytes != sizeof(T)) { return Fail(error, "section element size does not match"); }
+        if (section.count != expectedCount) { return Fail(error, "section element count does not match"); }
+        out = reinterpret_cast<const T*>(base + section.offset);
+        return true;
+    }
+
+    if (expectedCount == 0) { out = nullptr; return true; }
+    return Fail(error, "required section is missing");
+}
+
+} // namespace
+
+bool WriteSceneBinary(FILE* out, const SceneBinaryContents& contents) {
+    const SectionSource sources[] = {
+        { SceneBinarySectionType::Positions, sizeof(DirectX::XMFLOAT3), contents.objectCount, contents.positions },
+        { SceneBinarySectionType::Rotations, sizeof(DirectX::XMFLOAT3), contents.objectCount, contents.rotations },
+        { SceneBinarySectionType::Scales, sizeof(DirectX::XMFLOAT3), contents.objectCount, contents.scales },
+        { SceneBinarySectionType::Colors, sizeof(DirectX::XMFLOAT4), contents.objectCount, contents.colors },
+        { SceneBinarySectionType::Parents, sizeof(int32_t), contents.objectCount, contents.parents },
+        { SceneBinarySectionType::ObjectMeshes, sizeof(uint32_t), contents.objectCount, contents.objectMeshes },
+        { SceneBinarySectionType::Meshes, sizeof(SceneBinaryMeshRange), contents.meshCount, contents.meshes },
+        { SceneBinarySectionType::MeshVertices, sizeof(DirectX::XMFLOAT3), contents.vertexCount, contents.vertices },
+        { SceneBinarySectionType::MeshTriangles, sizeof(EditTriangle), contents.triangleCount, contents.triangles },
+    };
+    const uint32_t sectionCount = (uint32_t)(sizeof(sources) / sizeof(sources[0]));
+
+    // Lay out first, so the header and table go out in one write ahead of the data.
+    SceneBinarySection sections[sizeof(sources) / sizeof(sources[0])];
+    uint64_t offset = AlignUp(sizeof(SceneBinaryHeader) + sectionCount * sizeof(SceneBinarySection));
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        sections[i].type = (uint32_t)sources[i].type;
+        sections[i].elementBytes = sources[i].elementBytes;
+        sections[i].count = sources[i].count;
+        sections[i].offset = offset;
+        offset = AlignUp(offset + sources[i].count * sources[i].elementBytes);
+    }
+
+    SceneBinaryHeader header;
+    header.sectionCount = sectionCount;
+    header.fileBytes = offset;
+    header.objectCount = contents.objectCount;
+    header.activeIndex = contents.activeIndex;
+    header.meshCount = contents.meshCount;
+
+    static const unsigned char kPadding[kSceneBinaryAlignment] = {};
+    uint64_t written = 0;
+    auto writeBytes = [&](const void* data, uint64_t bytes) {
+        if (bytes == 0) { return true; }
+        written += bytes;
+        return std::fwrite(data, 1, (size_t)bytes, out) == (size_t)bytes;
+    };
+    auto pad = [&](uint64_t to) { return writeBytes(kPadding, to - written); };
+
+    if (!writeBytes(&header, sizeof(header))) { return false; }
+    if (!writeBytes(sections, sizeof(sections))) { return false; }
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        if (!pad(sections[i].offset)) { return false; }
+        if (sources[i].count > 0 && !sources[i].data) { return false; }
+        if (!writeBytes(sources[i].data, sources[i].count * sources[i].elementBytes)) { return false; }
+    }
+    return pad(header.fileBytes);
+}
+
+bool OpenSceneBinary(const void* data, size_t bytes, SceneBinaryContents& contents, std::string* error) {
+    contents = SceneBinaryContents();
+
+    const unsigned char* base = static_cast<const unsigned char*>(data);
+    if (!base || ((uintptr_t)base % 16) != 0) { return Fail(error, "buffer is not aligned"); }
+    if (bytes < sizeof(SceneBinaryHeader)) { return Fail(error, "file is too small"); }
+
+    const SceneBinaryHeader& header = *reinterpret_cast<const SceneBinaryHeader*>(base);
+    if (header.magic != kSceneBinaryMagic) { return Fail(error, "not a binary scene file"); }
+    if (header.version != kSceneBinaryVersion) { return Fail(error, "unsupported binary scene version"); }
+    if (header.headerBytes != sizeof(SceneBinaryHeader)) { return Fail(error, "unexpected header size"); }
+    if (header.fileBytes != bytes) { return Fail(error, "file size does not match the header (truncated?)"); }
+
+    uint64_t tableEnd = sizeof(SceneBinaryHeader) + (uint64_t)header.sectionCount * sizeof(SceneBinarySection);
+    if (tableEnd > bytes) { return Fail(error, "section table runs past the end of the file"); }
+
+    const SceneBinarySection* sections = reinterpret_cast<const SceneBinarySection*>(base + sizeof(SceneBinaryHeader));
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        const SceneBinarySection& section = sections[i];
+        if (section.elementBytes == 0) { return Fail(error, "section has no element size"); }
+        if ((section.offset % kSceneBinaryAlignment) != 0) { return Fail(error, "section is not aligned"); }
+        if (section.offset < tableEnd || section.offset > bytes) { return Fail(error, "section starts outside the file"); }
+        if (section.count > (bytes - section.offset) / section.elementBytes) { return Fail(error, "section runs past the end of the file"); }
+    }
+
+    const uint32_t objects = header.objectCount;
+    SceneBinaryContents result;
+    result.objectCount = objects;
+    result.activeIndex = header.activeIndex;
+    result.meshCount = header.meshCount;
+
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::Positions, objects, result.positions, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::Rotations, objects, result.rotations, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::Scales, objects, result.scales, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::Colors, objects, result.colors, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::Parents, objects, result.parents, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::ObjectMeshes, objects, result.objectMeshes, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::Meshes, header.meshCount, result.meshes, error)) { return false; }
+
+    // Vertex and triangle counts are whatever the sections hold; the mesh ranges must fit in them.
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        if (sections[i].type == (uint32_t)SceneBinarySectionType::MeshVertices && sections[i].count <= UINT32_MAX) { result.vertexCount = (uint32_t)sections[i].count; }
+        if (sections[i].type == (uint32_t)SceneBinarySectionType::MeshTriangles && sections[i].count <= UINT32_MAX) { result.triangleCount = (uint32_t)sections[i].count; }
+    }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::MeshVertices, result.vertexCount, result.vertices, error)) { return false; }
+    if (!FindSection(base, sections, header.sectionCount, SceneBinarySectionType::MeshTriangles, result.triangleCount, result.triangles, error)) { return false; }
+
+    for (uint32_t i = 0; i < objects; ++i) {
+        if (result.parents[i] < -1 || result.parents[i] >= (int64_t)objects) { return Fail(error, "parent index out of range"); }
+        if (result.objectMeshes[i] >= header.meshCount) { return Fail(error, "mesh index out of range"); }
+    }
+    for (uint32_t m = 0; m < header.meshCount; ++m) {
+        const SceneBinaryMeshRange& mesh = result.meshes[m];
+        if ((uint64_t)mesh.firstVertex + mesh.vertexCount > result.vertexCount) { return Fail(error, "mesh vertex range out of bounds"); }
+        if ((uint64_t)mesh.firstTriangle + mesh.triangleCount > result.triangleCount) { return Fail(error, "mesh triangle range out of bounds"); }
+
+        const EditTriangle* triangles = result.triangles + mesh.firstTriangle;
+        for (uint32_t t = 0; t < mesh.triangleCount; ++t) {
+            if (triangles[t].a >= mesh.vertexCount || triangles[t].b >= mesh.vertexCount || triangles[t].c >= mesh.vertexCount) {
+                return Fail(error, "triangle index out of range");
+            }
+        }
+    }
+    if (objects > 0 && header.activeIndex >= objects) { return Fail(error, "active index out of range"); }
+
+    contents = result;
+    return true;
+}
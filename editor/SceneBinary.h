@@ -0,0 +1,95 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "editor/modes/modeling/EditableMesh.h"
+
+// Binary scene container (.aeb), the loadable counterpart of the .aem text format. Everything a
+// SceneDocument saves, including mesh geometry, as flat little-endian arrays:
+//
+//   SceneBinaryHeader
+//   SceneBinarySection[sectionCount]
+//   section data, each array starting on a kSceneBinaryAlignment boundary
+//
+// Objects are structure-of-arrays, one element per object in dense order: positions, rotations,
+// scales, colors, parents (dense index or -1) and mesh (index into the file's mesh table). Meshes are
+// one range each into shared vertex and triangle arrays; triangle indices are local to the mesh.
+//
+// Loading maps the file, checks the header and every section's bounds, size and alignment, and
+// points the arrays into the mapping (OpenSceneBinary). No field is parsed or converted, so a file
+// that passes validation can be read in place. Readers skip section types they do not know, so
+// later versions can add sections; a change to an existing one bumps kSceneBinaryVersion.
+static const uint32_t kSceneBinaryMagic = 0x31424541u; // "AEB1"
+static const uint32_t kSceneBinaryVersion = 1;
+static const uint32_t kSceneBinaryAlignment = 64;
+
+enum class SceneBinarySectionType : uint32_t {
+    Positions = 1,     // XMFLOAT3 per object
+    Rotations,         // XMFLOAT3 per object (euler, radians)
+    Scales,            // XMFLOAT3 per object
+    Colors,            // XMFLOAT4 per object
+    Parents,           // int32_t per object
+    ObjectMeshes,      // uint32_t per object
+    Meshes,            // SceneBinaryMeshRange per mesh
+    MeshVertices,      // XMFLOAT3
+    MeshTriangles,     // EditTriangle
+};
+
+struct SceneBinaryHeader {
+    uint32_t magic = kSceneBinaryMagic;
+    uint32_t version = kSceneBinaryVersion;
+    uint32_t headerBytes = sizeof(SceneBinaryHeader);
+    uint32_t sectionCount = 0;
+    uint64_t fileBytes = 0;
+    uint32_t objectCount = 0;
+    uint32_t activeIndex = 0;
+    uint32_t meshCount = 0;
+    uint32_t reserved[3] = {};
+};
+
+struct SceneBinarySection {
+    uint32_t type = 0;          // SceneBinarySectionType
+    uint32_t elementBytes = 0;
+    uint64_t count = 0;
+    uint64_t offset = 0;        // from the start of the file
+};
+
+struct SceneBinaryMeshRange {
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstTriangle = 0;
+    uint32_t triangleCount = 0;
+};
+
+static_assert(sizeof(SceneBinaryHeader) == 48, "SceneBinaryHeader layout is part of the file format");
+static_assert(sizeof(SceneBinarySection) == 24, "SceneBinarySection layout is part of the file format");
+static_assert(sizeof(EditTriangle) == 12, "EditTriangle is stored as is");
+
+// The arrays of one scene. WriteSceneBinary reads them; OpenSceneBinary points them into a loaded file.
+struct SceneBinaryContents {
+    uint32_t objectCount = 0;
+    uint32_t activeIndex = 0;
+    const DirectX::XMFLOAT3* positions = nullptr;
+    const DirectX::XMFLOAT3* rotations = nullptr;
+    const DirectX::XMFLOAT3* scales = nullptr;
+    const DirectX::XMFLOAT4* colors = nullptr;
+    const int32_t* parents = nullptr;
+    const uint32_t* objectMeshes = nullptr;
+
+    uint32_t meshCount = 0;
+    const SceneBinaryMeshRange* meshes = nullptr;
+    uint32_t vertexCount = 0;
+    const DirectX::XMFLOAT3* vertices = nullptr;
+    uint32_t triangleCount = 0;
+    const EditTriangle* triangles = nullptr;
+};
+
+bool WriteSceneBinary(FILE* out, const SceneBinaryContents& contents);
+
+// data must stay alive (and unchanged) while contents is used, and be aligned like a mapping or a
+// heap block (16 bytes at least). Also checks that every parent, mesh index and triangle index is in
+// range, so a caller can use the arrays without further checks. error says what failed.
+bool OpenSceneBinary(const void* data, size_t bytes, SceneBinaryContents& contents, std::string* error = nullptr);
@@ -0,0 +1,766 @@
+#include "editor/SceneDocument.h"
+#include "editor/SceneBinary.h"
+#include "editor/SceneFile.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cwctype>
+#include <string>
+
+// A mesh of a file being loaded, decoded by the loader thread. Geometry equal to the built-in
+// tetrahedron is not decoded; those objects become instances of it.
+struct LoadedMesh {
+    EditableMesh editMesh;
+    RenderMesh renderMesh;
+    bool isTetra = false;
+};
+
+// State of one BeginLoadScene, shared by the document and the task on its loader thread. A cancelled
+// load is dropped by the document at once; the task notices the flag and the last owner frees it.
+struct SceneLoad {
+    std::atomic<bool> cancel{ false };
+    std::atomic<bool> read{ false };               // the loader thread is done with the file (see ok)
+    std::atomic<uint32_t> meshesDecoded{ 0 };      // meshes[0, meshesDecoded) are ready
+    std::chrono::steady_clock::time_point start;
+
+    // Set before the task is posted.
+    std::wstring path;
+    EditableMesh tetra; //copy of the built-in mesh, compared against on the loader thread
+
+    // Written by the loader thread before read is set, then only read.
+    bool ok = false;
+    std::string error;
+    double readMs = 0.0;
+    SceneFileData file;
+    std::vector<uint32_t> parents;                 // file order, kInvalidIndex for roots (not checked yet)
+    std::vector<LoadedMesh> meshes;                // filled in order, behind meshesDecoded
+
+    // Main thread only.
+    bool started = false;                          // the scene has been replaced
+    uint32_t nextObject = 0;                       // objects are published in file order
+    uint32_t meshesPublished = 0;
+    std::vector<ObjectHandle> handles;             // per file object, once published
+    std::vector<MeshAssetID> meshAssets;           // per file mesh, once resident (the load holds a reference)
+    std::vector<std::vector<ObjectHandle>> waiting; // per file mesh: objects showing the placeholder
+    ObjectHandle autoActive;                       // active object picked by the load, not the user
+};
+
+static double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool SameGeometry(const EditableMesh& mesh, const DirectX::XMFLOAT3* vertices, uint32_t vertexCount, const EditTriangle* triangles, uint32_t triangleCount) {
+    if (mesh.vertexCount != vertexCount || mesh.triangleCount != triangleCount) { return false; }
+    if (vertexCount > 0 && std::memcmp(mesh.positions.data(), vertices, vertexCount * sizeof(DirectX::XMFLOAT3)) != 0) { return false; }
+    return triangleCount == 0 || std::memcmp(mesh.triangles.data(), triangles, triangleCount * sizeof(EditTriangle)) == 0;
+}
+
+// Replaces target's geometry. Clear bumps target's own version counters, so derived data built for
+// what the mesh held before (a reused asset's BVH) is never mistaken for current.
+static void SetGeometry(EditableMesh& target, const DirectX::XMFLOAT3* vertices, uint32_t vertexCount, const EditTriangle* triangles, uint32_t triangleCount) {
+    target.Clear();
+    target.positions.assign(vertices, vertices + vertexCount);
+    target.triangles.assign(triangles, triangles + triangleCount);
+    target.vertexCount = vertexCount;
+    target.triangleCount = triangleCount;
+}
+
+// Loader thread: read and check the file and its links, then decode meshes one at a time so UpdateSceneLoad
+// can swap each in as soon as it is ready.
+static void RunSceneLoad(SceneLoad& load) {
+    {
+        AE_PROFILE_ZONE("ReadScene");
+        load.ok = SceneDocument::IsBinaryScenePath(load.path.c_str())
+            ? ReadSceneBinary(load.path.c_str(), load.file, &load.error)
+            : ReadSceneAem(load.path.c_str(), load.file, nullptr, &load.cancel, &load.error); //this thread is not one of the job system's
+
+        if (load.ok) {
+            const SceneBinaryContents& contents = load.file.contents;
+            load.parents.resize(contents.objectCount);
+            for (uint32_t i = 0; i < contents.objectCount; ++i) { load.parents[i] = (uint32_t)contents.parents[i]; } //-1 becomes kInvalidIndex
+            load.meshes.resize(contents.meshCount);
+        }
+        load.readMs = MsSince(load.start);
+    }
+    load.read.store(true, std::memory_order_release);
+    if (!load.ok) { return; }
+
+    const SceneBinaryContents& contents = load.file.contents;
+    for (uint32_t m = 0; m < contents.meshCount; ++m) {
+        if (load.cancel.load(std::memory_order_relaxed)) { return; }
+
+        AE_PROFILE_ZONE("DecodeMesh");
+        const SceneBinaryMeshRange& range = contents.meshes[m];
+        const DirectX::XMFLOAT3* vertices = contents.vertices + range.firstVertex;
+        const EditTriangle* triangles = contents.triangles + range.firstTriangle;
+
+        LoadedMesh& mesh = load.meshes[m];
+        mesh.isTetra = SameGeometry(load.tetra, vertices, range.vertexCount, triangles, range.triangleCount);
+        if (!mesh.isTetra) {
+            SetGeometry(mesh.editMesh, vertices, range.vertexCount, triangles, range.triangleCount);
+            mesh.renderMesh.BuildFromEditable(mesh.editMesh);
+        }
+        load.meshesDecoded.store(m + 1, std::memory_order_release);
+    }
+}
+
+SceneDocument::SceneDocument() {
+    // Built-in tetrahedron asset. Objects the editor creates are instances of it.
+    m_tetraMesh = m_meshAssets.Create();
+    MeshAsset* tetra = m_meshAssets.Get(m_tetraMesh);
+    tetra->editMesh.BuildTetrahedron(0.8f);
+    tetra->renderMesh.BuildFromEditable(tetra->editMesh);
+    m_meshAssets.AddRef(m_tetraMesh);
+}
+
+SceneDocument::~SceneDocument() {
+    // The loader may still be reading; it sees the flag and stops before the thread is joined.
+    CancelSceneLoad();
+    m_loaderThread.Stop();
+}
+
+void SceneDocument::CreateDefaultScene() {
+    ResetAllObjects();
+
+    OnActiveObjectChanging();
+    ObjectTransform transform;
+    DirectX::XMFLOAT4 white(1.0f, 1.0f, 1.0f, 1.0f);
+    m_activeObject = SpawnObject(transform, white, m_tetraMesh);
+    transform.pos = DirectX::XMFLOAT3(2.0f, 0.0f, 0.0f);
+    SpawnObject(transform, white, m_tetraMesh);
+    OnActiveObjectChanged();
+}
+
+void SceneDocument::SyncSceneBvh() {
+    uint32_t objectCount = m_scene.Count();
+    while (m_objectProxies.size() > objectCount) {
+        m_sceneBvh.DestroyProxy(m_objectProxies.back());
+        m_objectProxies.pop_back();
+        m_proxyWorlds.pop_back();
+        m_proxyMeshes.pop_back();
+        m_proxyMeshVersions.pop_back();
+    }
+
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        const DirectX::XMFLOAT4X4& W = m_scene.World(i);
+        MeshAssetID mesh = m_scene.Mesh(i);
+        const MeshAsset* asset = m_meshAssets.Get(mesh);
+        uint64_t meshVersion = asset ? asset->editMesh.version : 0;
+
+        bool isNew = i >= m_objectProxies.size();
+        bool meshChanged = !isNew && (m_proxyMeshes[i] != mesh || m_proxyMeshVersions[i] != meshVersion);
+        if (!isNew && !meshChanged && std::memcmp(&m_proxyWorlds[i], &W, sizeof(W)) == 0) continue;
+
+        // Instances of one asset share its cached local bounds.
+        MeshBounds local;
+        if (asset) { local = asset->editMesh.GetBounds(); }
+
+        // World AABB of the transformed local box: center transformed, extents through |M|.
+
+        DirectX::XMFLOAT3 c((local.min.x + local.max.x) * 0.5f, (local.min.y + local.max.y) * 0.5f, (local.min.z + local.max.z) * 0.5f);
+        DirectX::XMFLOAT3 e((local.max.x - local.min.x) * 0.5f, (local.max.y - local.min.y) * 0.5f, (local.max.z - local.min.z) * 0.5f);
+
+        SceneAabb box;
+        float wc[3];
+        float we[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            wc[axis] = c.x * W.m[0][axis] + c.y * W.m[1][axis] + c.z * W.m[2][axis] + W.m[3][axis];
+            we[axis] = e.x * fabsf(W.m[0][axis]) + e.y * fabsf(W.m[1][axis]) + e.z * fabsf(W.m[2][axis]);
+        }
+        box.min = DirectX::XMFLOAT3(wc[0] - we[0], wc[1] - we[1], wc[2] - we[2]);
+        box.max = DirectX::XMFLOAT3(wc[0] + we[0], wc[1] + we[1], wc[2] + we[2]);
+
+        if (isNew) {
+            m_objectProxies.push_back(m_sceneBvh.CreateProxy(box, i));
+            m_proxyWorlds.push_back(W);
+            m_proxyMeshes.push_back(mesh);
+            m_proxyMeshVersions.push_back(meshVersion);
+        } else {
+            m_sceneBvh.MoveProxy(m_objectProxies[i], box);
+            m_proxyWorlds[i] = W;
+            m_proxyMeshes[i] = mesh;
+            m_proxyMeshVersions[i] = meshVersion;
+        }
+    }
+}
+
+int SceneDocument::PickObject(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir) {
+    SyncSceneBvh();
+
+    float bestDist = 1.0e30f;
+    int bestIndex = -1;
+
+    // The scene BVH only yields objects whose world box the ray enters, nearest box first.
+    // Each candidate gets an exact triangle test in its own space; a hit shrinks the search distance.
+    m_sceneBvh.Raycast(origin, dir, bestDist, [&](uint32_t index, float) {
+        MeshAssetID mesh = m_scene.Mesh(index);
+        MeshBVH* bvh = PickBvh(mesh);
+        if (!bvh) return bestDist;
+
+        DirectX::XMMATRIX invW = DirectX::XMLoadFloat4x4(&m_scene.InverseWorld(index));
+
+        DirectX::XMFLOAT3 localOrigin, localDir;
+        DirectX::XMStoreFloat3(&localOrigin, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&origin), invW));
+        DirectX::XMStoreFloat3(&localDir, DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&dir), invW));
+
+        TriangleID triangle = kInvalidTriangleID;
+        float t = 0.0f;
+        if (bvh->Raycast(m_meshAssets.Get(mesh)->editMesh, localOrigin, localDir, triangle, t) && t < bestDist) {
+            bestDist = t; //local dir is unnormalized, so t is still a world-space distance
+            bestIndex = (int)index;
+        }
+        return bestDist;
+    });
+
+    return bestIndex;
+}
+
+ObjectHandle SceneDocument::SpawnObject(const ObjectTransform& transform, const DirectX::XMFLOAT4& color, MeshAssetID mesh) {
+    m_meshAssets.AddRef(mesh);
+    return m_scene.Add(transform, color, mesh);
+}
+
+MeshBVH* SceneDocument::PickBvh(MeshAssetID mesh) {
+    MeshAsset* asset = m_meshAssets.Get(mesh);
+    if (!asset) return nullptr;
+
+    if (!asset->bvh.IsBuiltFor(asset->editMesh)) { asset->bvh.Build(asset->editMesh); }
+    return &asset->bvh;
+}
+
+bool SceneDocument::SaveSceneAem(const wchar_t* path) {
+    AE_PROFILE_ZONE("SaveSceneAem");
+
+    // File format:
+    //   AE_MODEL 2                                            //px py pz = object position x/y/z (local to the parent)
+    //   objects N                                             //rx ry rz = object rotation x/y/z
+    //   active I                                              //sx sy sz = object scale x/y/z
+    //   obj tetra px py pz rx ry rz sx sy sz cr cg cb ca P    //cr cg cb ca = object color red/green/blue/alpha
+    //                                                         //P = parent's position in the object list, -1 for none
+    // Version 1 files have no parent column and still load (every object is a root).
+    FILE* f = OpenSceneFile(path, true);
+    if (!f) return false;
+
+    std::fprintf(f, "AE_MODEL 2\n");
+    // Objects are written in dense order; "active" is a position in that order (handles are not saved).
+    uint32_t activeIndex = ActiveIndex();
+    std::fprintf(f, "objects %u\n", (unsigned)m_scene.Count());
+    std::fprintf(f, "active %u\n", (unsigned)(activeIndex == Scene::kInvalidIndex ? 0 : activeIndex));
+
+    for (uint32_t i = 0; i < m_scene.Count(); ++i) {
+        const ObjectTransform& transform = m_scene.Transform(i);
+        const DirectX::XMFLOAT4& color = m_scene.Color(i);
+        uint32_t parent = m_scene.Parent(i);
+        std::fprintf(f, "obj tetra %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %d\n",
+            transform.pos.x, transform.pos.y, transform.pos.z,
+            transform.rot.x, transform.rot.y, transform.rot.z,
+            transform.scale.x, transform.scale.y, transform.scale.z,
+            color.x, color.y, color.z, color.w,
+            parent == Scene::kInvalidIndex ? -1 : (int)parent
+        );
+    }
+
+    std::fclose(f);
+    return true;
+}
+
+bool SceneDocument::LoadSceneAem(const wchar_t* path) {
+    AE_PROFILE_ZONE("LoadSceneAem");
+    CancelSceneLoad();
+
+    // Read in full before the document is touched, so a bad file leaves the scene as it was.
+    SceneFileData file;
+    if (!ReadSceneAem(path, file, m_jobs, nullptr, &m_loadError)) return false;
+    m_loadError.clear();
+
+    ApplySceneFile(file.contents);
+    return true;
+}
+
+bool SceneDocument::IsBinaryScenePath(const wchar_t* path) {
+    size_t length = std::wcslen(path);
+    if (length < 4) { return false; }
+
+    const wchar_t* extension = path + length - 4;
+    return extension[0] == L'.' && std::towlower(extension[1]) == L'a' && std::towlower(extension[2]) == L'e' && std::towlower(extension[3]) == L'b';
+}
+
+bool SceneDocument::SaveSceneBinary(const wchar_t* path) {
+    AE_PROFILE_ZONE("SaveSceneBinary");
+
+    const uint32_t count = m_scene.Count();
+    std::vector<DirectX::XMFLOAT3> positions(count), rotations(count), scales(count);
+    std::vector<int32_t> parents(count);
+    std::vector<uint32_t> objectMeshes(count);
+
+    // Only meshes some object uses are written, numbered in order of first use.
+    std::vector<uint32_t> fileMesh(m_meshAssets.SlotCount(), UINT32_MAX);
+    std::vector<SceneBinaryMeshRange> meshes;
+    std::vector<DirectX::XMFLOAT3> vertices;
+    std::vector<EditTriangle> triangles;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const ObjectTransform& transform = m_scene.Transform(i);
+        positions[i] = transform.pos;
+        rotations[i] = transform.rot;
+        scales[i] = transform.scale;
+        uint32_t parent = m_scene.Parent(i);
+        parents[i] = (parent == Scene::kInvalidIndex) ? -1 : (int32_t)parent;
+
+        MeshAssetID id = m_scene.Mesh(i);
+        const MeshAsset* asset = m_meshAssets.Get(id);
+        if (!asset) return false;
+
+        if (fileMesh[id] == UINT32_MAX) {
+            const EditableMesh& mesh = asset->editMesh;
+            SceneBinaryMeshRange range;
+            range.firstVertex = (uint32_t)vertices.size();
+            range.vertexCount = mesh.vertexCount;
+            range.firstTriangle = (uint32_t)triangles.size();
+            range.triangleCount = mesh.triangleCount;
+            vertices.insert(vertices.end(), mesh.positions.begin(), mesh.positions.begin() + mesh.vertexCount);
+            triangles.insert(triangles.end(), mesh.triangles.begin(), mesh.triangles.begin() + mesh.triangleCount);
+
+            fileMesh[id] = (uint32_t)meshes.size();
+            meshes.push_back(range);
+        }
+        objectMeshes[i] = fileMesh[id];
+    }
+
+    uint32_t activeIndex = ActiveIndex();
+
+    SceneBinaryContents contents;
+    contents.objectCount = count;
+    contents.activeIndex = (activeIndex == Scene::kInvalidIndex) ? 0 : activeIndex;
+    contents.positions = positions.data();
+    contents.rotations = rotations.data();
+    contents.scales = scales.data();
+    contents.colors = m_scene.Colors().data();
+    contents.parents = parents.data();
+    contents.objectMeshes = objectMeshes.data();
+    contents.meshCount = (uint32_t)meshes.size();
+    contents.meshes = meshes.data();
+    contents.vertexCount = (uint32_t)vertices.size();
+    contents.vertices = vertices.data();
+    contents.triangleCount = (uint32_t)triangles.size();
+    contents.triangles = triangles.data();
+
+    FILE* f = OpenSceneFile(path, true);
+    if (!f) return false;
+
+    bool ok = WriteSceneBinary(f, contents);
+    if (std::fclose(f) != 0) { ok = false; }
+    return ok;
+}
+
+bool SceneDocument::LoadSceneBinary(const wchar_t* path) {
+    AE_PROFILE_ZONE("LoadSceneBinary");
+    CancelSceneLoad();
+
+    // Everything is checked before the document is touched, so a bad file leaves the scene as it was.
+    SceneFileData file;
+    if (!ReadSceneBinary(path, file, &m_loadError)) return false;
+    m_loadError.clear();
+
+    ApplySceneFile(file.contents);
+    return true;
+}
+
+void SceneDocument::ApplySceneFile(const SceneBinaryContents& contents) {
+    ResetAllObjects();
+    m_scene.Reserve(contents.objectCount);
+
+    // An asset per file mesh, created on first use. Geometry equal to the built-in tetrahedron stays an
+    // instance of it, as does every object of a text file (no mesh table).
+    std::vector<MeshAssetID> assets(contents.meshCount, kInvalidMeshAssetID);
+    for (uint32_t i = 0; i < contents.objectCount; ++i) {
+        MeshAssetID mesh = m_tetraMesh;
+        if (contents.objectMeshes) {
+            uint32_t meshIndex = contents.objectMeshes[i];
+            if (assets[meshIndex] == kInvalidMeshAssetID) {
+                const SceneBinaryMeshRange& range = contents.meshes[meshIndex];
+                const DirectX::XMFLOAT3* vertices = contents.vertices + range.firstVertex;
+                const EditTriangle* triangles = contents.triangles + range.firstTriangle;
+
+                if (SameGeometry(m_meshAssets.Get(m_tetraMesh)->editMesh, vertices, range.vertexCount, triangles, range.triangleCount)) {
+                    assets[meshIndex] = m_tetraMesh;
+                } else {
+                    MeshAssetID id = m_meshAssets.Create();
+                    MeshAsset* asset = m_meshAssets.Get(id);
+                    SetGeometry(asset->editMesh, vertices, range.vertexCount, triangles, range.triangleCount);
+                    asset->renderMesh.BuildFromEditable(asset->editMesh);
+                    assets[meshIndex] = id;
+                }
+            }
+            mesh = assets[meshIndex];
+        }
+
+        ObjectTransform transform;
+        transform.pos = contents.positions[i];
+        transform.rot = contents.rotations[i];
+        transform.scale = contents.scales[i];
+        SpawnObject(transform, contents.colors[i], mesh);
+    }
+
+    // Parents may come later in the file, so links are applied once every object exists. Nothing was
+    // removed, so dense indices still match the file order. Bad links (out of range or cycles) leave
+    // the object as a root; -1 reads as kInvalidIndex when taken as unsigned.
+    m_scene.SetParents(reinterpret_cast<const uint32_t*>(contents.parents));
+
+    m_activeObject = m_scene.HandleAt(contents.activeIndex);
+    OnActiveObjectChanged();
+}
+
+bool SceneDocument::BeginLoadScene(const wchar_t* path) {
+    CancelSceneLoad();
+
+    std::shared_ptr<SceneLoad> load = std::make_shared<SceneLoad>();
+    load->start = std::chrono::steady_clock::now();
+    load->path = path;
+    load->tetra = m_meshAssets.Get(m_tetraMesh)->editMesh;
+    m_load = load;
+
+    m_loadStats = SceneLoadStats();
+    m_loadStats.loading = true;
+
+    m_loaderThread.Post([load]() { RunSceneLoad(*load); });
+    return true;
+}
+
+void SceneDocument::CancelSceneLoad() {
+    if (!m_load) { return; }
+
+    // Objects already published stay, with their meshes; only the load's own references go.
+    m_load->cancel.store(true, std::memory_order_relaxed);
+    for (MeshAssetID id : m_load->meshAssets) {
+        if (id != kInvalidMeshAssetID && id != m_tetraMesh) { m_meshAssets.Release(id); }
+    }
+    m_load.reset();
+    m_loadStats.loading = false;
+}
+
+void SceneDocument::UpdateSceneLoad(double budgetSeconds) {
+    if (!m_load || !m_load->read.load(std::memory_order_acquire)) { return; }
+
+    AE_PROFILE_ZONE("PublishScene");
+    auto sliceStart = std::chrono::steady_clock::now();
+    SceneLoad& load = *m_load;
+
+    if (!load.ok) {
+        m_loadError = load.error;
+        m_load.reset();
+        m_loadStats.loading = false;
+        m_loadStats.failed = true;
+        return;
+    }
+
+    const SceneBinaryContents& contents = load.file.contents;
+    if (!load.started) {
+        load.started = true;
+        m_loadStats.objects = contents.objectCount;
+        m_loadStats.meshes = contents.meshCount;
+        m_loadStats.readMs = load.readMs;
+        m_loadError.clear();
+
+        ResetAllObjects();
+        m_scene.Reserve(contents.objectCount);
+        load.handles.assign(contents.objectCount, ObjectHandle{});
+        load.meshAssets.assign(contents.meshCount, kInvalidMeshAssetID);
+        load.waiting.resize(contents.meshCount);
+    }
+
+    // Meshes the loader finished since the last frame replace their placeholders.
+    uint32_t decoded = load.meshesDecoded.load(std::memory_order_acquire);
+    while (load.meshesPublished < decoded) { PublishLoadedMesh(load, load.meshesPublished++); }
+
+    // Objects in file order, so dense indices match the file as after a synchronous load. They come in
+    // as roots; the links are made together once the last one is in (see LinkLoadedObjects).
+    const uint32_t firstObject = load.nextObject;
+    const double budgetMs = budgetSeconds * 1000.0;
+    while (load.nextObject < contents.objectCount) {
+        if (load.nextObject != firstObject && ((load.nextObject - firstObject) & 15) == 0 && MsSince(sliceStart) >= budgetMs) { break; }
+
+        uint32_t i = load.nextObject++;
+        uint32_t meshIndex = contents.objectMeshes ? contents.objectMeshes[i] : 0;
+        MeshAssetID mesh = contents.objectMeshes ? load.meshAssets[meshIndex] : m_tetraMesh; //text files: every object is the tetrahedron
+        bool placeholder = (mesh == kInvalidMeshAssetID);
+        if (placeholder) { mesh = m_tetraMesh; }
+
+        ObjectTransform transform;
+        transform.pos = contents.positions[i];
+        transform.rot = contents.rotations[i];
+        transform.scale = contents.scales[i];
+        ObjectHandle handle = SpawnObject(transform, contents.colors[i], mesh);
+        load.handles[i] = handle;
+
+        if (placeholder) {
+            load.waiting[meshIndex].push_back(handle);
+            m_loadStats.placeholders++;
+        }
+    }
+    if (load.nextObject == contents.objectCount && load.nextObject > firstObject) { LinkLoadedObjects(load); }
+
+    if (load.nextObject > firstObject) {
+        if (firstObject == 0) {
+            // First slice: something to select until the file's active object is published.
+            OnActiveObjectChanging();
+            ObjectHandle fileActive = load.handles[contents.activeIndex];
+            m_activeObject = fileActive.IsValid() ? fileActive : load.handles[0];
+            load.autoActive = m_activeObject;
+            OnActiveObjectChanged();
+            m_loadStats.firstObjectsMs = MsSince(load.start);
+        }
+        m_loadStats.objectsPublished = load.nextObject;
+        m_loadStats.slices++;
+        if (load.nextObject == contents.objectCount) { m_loadStats.allObjectsMs = MsSince(load.start); }
+    }
+    m_loadStats.maxSliceMs = (std::max)(m_loadStats.maxSliceMs, MsSince(sliceStart));
+
+    if (load.nextObject == contents.objectCount && load.meshesPublished == contents.meshCount) { FinishSceneLoad(); }
+}
+
+// One SetParents over the whole scene, O(n), where a SetParent per link moved O(n) of the hierarchy
+// order each. Objects are matched by handle, as the user may have added or deleted some while loading.
+// Links made during the load stay; an object deleted meanwhile leaves its file children as roots.
+// With no edits the scene's indices are the file's, so this is exactly the synchronous SetParents.
+void SceneDocument::LinkLoadedObjects(const SceneLoad& load) {
+    AE_PROFILE_ZONE("LinkLoadedObjects");
+    std::vector<uint32_t> parents(m_scene.Count());
+    for (uint32_t index = 0; index < m_scene.Count(); ++index) { parents[index] = m_scene.Parent(index); }
+    for (uint32_t i = 0; i < (uint32_t)load.handles.size(); ++i) {
+        uint32_t index = m_scene.IndexOf(load.handles[i]);
+        uint32_t parent = load.parents[i];
+        if (index == Scene::kInvalidIndex || parents[index] != Scene::kInvalidIndex || parent >= load.handles.size()) { continue; }
+        parents[index] = m_scene.IndexOf(load.handles[parent]);
+    }
+    m_scene.SetParents(parents.data());
+}
+
+void SceneDocument::PublishLoadedMesh(SceneLoad& load, uint32_t mesh) {
+    LoadedMesh& loaded = load.meshes[mesh];
+    MeshAssetID id = m_tetraMesh;
+    if (!loaded.isTetra) {
+        id = m_meshAssets.Create();
+        MeshAsset* asset = m_meshAssets.Get(id);
+        // Clear first for fresh version counters (see SetGeometry), then take the decoded arrays.
+        asset->editMesh.Clear();
+        asset->editMesh.positions.swap(loaded.editMesh.positions);
+        asset->editMesh.triangles.swap(loaded.editMesh.triangles);
+        asset->editMesh.vertexCount = loaded.editMesh.vertexCount;
+        asset->editMesh.triangleCount = loaded.editMesh.triangleCount;
+        asset->renderMesh = std::move(loaded.renderMesh);
+        m_meshAssets.AddRef(id); //the load's reference, so the asset lives until every object is in
+    }
+    load.meshAssets[mesh] = id;
+    loaded = LoadedMesh();
+    m_loadStats.meshesResident++;
+
+    // Objects still on the placeholder switch over, unless they were deleted or given a mesh of their
+    // own (an edit makes the placeholder unique) in the meantime.
+    if (id != m_tetraMesh) {
+        for (ObjectHandle handle : load.waiting[mesh]) {
+            uint32_t index = m_scene.IndexOf(handle);
+            if (index == Scene::kInvalidIndex || m_scene.Mesh(index) != m_tetraMesh) { continue; }
+
+            bool active = (handle == m_activeObject);
+            if (active) { OnActiveObjectChanging(); }
+            m_meshAssets.AddRef(id);
+            m_scene.SetMesh(index, id);
+            m_meshAssets.Release(m_tetraMesh);
+            if (active) { OnActiveObjectChanged(); }
+        }
+    }
+    std::vector<ObjectHandle>().swap(load.waiting[mesh]);
+
+    if (load.meshesPublished == load.meshAssets.size() && load.meshAssets.size() > 0) { m_loadStats.allMeshesMs = MsSince(load.start); }
+}
+
+void SceneDocument::FinishSceneLoad() {
+    SceneLoad& load = *m_load;
+
+    // The file's active object, unless the user picked another one while loading.
+    ObjectHandle fileActive = load.handles[load.file.contents.activeIndex];
+    if (m_activeObject == load.autoActive && fileActive != m_activeObject && m_scene.IsAlive(fileActive)) { SetActiveObject(fileActive); }
+
+    for (MeshAssetID id : load.meshAssets) {
+        if (id != m_tetraMesh) { m_meshAssets.Release(id); }
+    }
+    if (load.meshAssets.empty()) { m_loadStats.allMeshesMs = m_loadStats.allObjectsMs; }
+
+    m_load.reset();
+    m_loadStats.loading = false;
+}
+
+bool SceneDocument::GetActiveObjectTransform(DirectX::XMFLOAT3& pos, DirectX::XMFLOAT3& rot, DirectX::XMFLOAT3& scale) const {
+    if (ActiveIndex() == Scene::kInvalidIndex)
+        return false;
+
+    const ObjectTransform& transform = m_scene.Transform(ActiveIndex());
+
+    pos = transform.pos;
+    rot = transform.rot;
+    scale = transform.scale;
+
+    return true;
+}
+
+bool SceneDocument::SetActiveObjectTransform(const DirectX::XMFLOAT3& pos, const DirectX::XMFLOAT3& rot, const DirectX::XMFLOAT3& scale) {
+    if (ActiveIndex() == Scene::kInvalidIndex)
+        return false;
+
+    DirectX::XMFLOAT3 safeScale = scale;
+    const float minScale = 0.001f;
+    if (fabsf(safeScale.x) < minScale) safeScale.x = (safeScale.x < 0.0f) ? -minScale : minScale;
+    if (fabsf(safeScale.y) < minScale) safeScale.y = (safeScale.y < 0.0f) ? -minScale : minScale;
+    if (fabsf(safeScale.z) < minScale) safeScale.z = (safeScale.z < 0.0f) ? -minScale : minScale;
+
+    ObjectTransform transform;
+    transform.pos = pos;
+    transform.rot = rot;
+    transform.scale = safeScale;
+    m_scene.SetTransform(ActiveIndex(), transform);
+
+    return true;
+}
+
+// An invalid handle makes the active object a root. Parenting under itself or a descendant fails.
+bool SceneDocument::SetActiveObjectParent(ObjectHandle parent) {
+    if (ActiveIndex() == Scene::kInvalidIndex)
+        return false;
+
+    uint32_t parentIndex = Scene::kInvalidIndex;
+    if (parent.IsValid()) {
+        parentIndex = m_scene.IndexOf(parent);
+        if (parentIndex == Scene::kInvalidIndex)
+            return false;
+    }
+
+    return m_scene.SetParent(ActiveIndex(), parentIndex);
+}
+
+void SceneDocument::SetActiveObject(ObjectHandle object) {
+    if (!m_scene.IsAlive(object))
+        return;
+
+    OnActiveObjectChanging();
+    m_activeObject = object;
+    OnActiveObjectChanged();
+}
+
+bool SceneDocument::AddObject(const DirectX::XMFLOAT3& pos) {
+    ObjectTransform transform;
+    transform.pos = pos;
+
+    OnActiveObjectChanging();
+    m_activeObject = SpawnObject(transform, DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f), m_tetraMesh);
+    OnActiveObjectChanged();
+    return true;
+}
+
+bool SceneDocument::DuplicateActiveObject() {
+    if (ActiveIndex() == Scene::kInvalidIndex)
+        return false;
+
+    const ObjectTransform& source = m_scene.Transform(ActiveIndex());
+
+    DirectX::XMFLOAT3 p = source.pos;
+    DirectX::XMFLOAT3 r = source.rot;
+    DirectX::XMFLOAT3 s = source.scale;
+    DirectX::XMFLOAT4 c = m_scene.Color(ActiveIndex());
+    MeshAssetID mesh = m_scene.Mesh(ActiveIndex());
+    uint32_t parent = m_scene.Parent(ActiveIndex());
+
+    p.x += 0.5f; // small offset so it’s visible
+
+    // O(1): the duplicate is another instance of the same asset, geometry is copied only if one of them is edited.
+    ObjectTransform transform;
+    transform.pos = p;
+    transform.rot = r;
+    transform.scale = s;
+
+    OnActiveObjectChanging();
+    m_activeObject = SpawnObject(transform, c, mesh);
+    m_scene.SetParent(ActiveIndex(), parent); //a sibling of the source, children are not duplicated
+    OnActiveObjectChanged();
+
+    return true;
+}
+
+bool SceneDocument::DeleteActiveObject() {
+    if (m_scene.Count() <= 1)
+        return false;
+
+    uint32_t index = ActiveIndex();
+    if (index == Scene::kInvalidIndex)
+        return false;
+
+    OnActiveObjectChanging();
+
+    // Swap-remove: the last object moves into this dense index and becomes active.
+    MeshAssetID mesh = m_scene.Mesh(index);
+    m_scene.Remove(m_activeObject);
+    m_meshAssets.Release(mesh);
+
+    if (index >= m_scene.Count())
+        index = m_scene.Count() - 1;
+    m_activeObject = m_scene.HandleAt(index);
+    OnActiveObjectChanged();
+
+    return true;
+}
+
+void SceneDocument::ResetAllObjects() {
+    OnActiveObjectChanging();
+
+    for (uint32_t i = 0; i < m_scene.Count(); ++i) {
+        m_meshAssets.Release(m_scene.Mesh(i));
+    }
+
+    m_scene.Clear();
+    m_activeObject = ObjectHandle{};
+    OnActiveObjectChanged();
+}
+
+bool SceneDocument::ExecuteCommand(const EditorCommand& command) {
+    switch (command.type) {
+    case EditorCommandType::AddObject:
+        return AddObject(command.pos);
+
+    case EditorCommandType::DuplicateActiveObject:
+        return DuplicateActiveObject();
+
+    case EditorCommandType::DeleteActiveObject:
+        return DeleteActiveObject();
+
+    case EditorCommandType::SaveScene:
+        if (!command.path) return false;
+        return IsBinaryScenePath(command.path) ? SaveSceneBinary(command.path) : SaveSceneAem(command.path);
+
+    case EditorCommandType::LoadScene:
+        if (!command.path) return false;
+        return IsBinaryScenePath(command.path) ? LoadSceneBinary(command.path) : LoadSceneAem(command.path);
+
+    case EditorCommandType::LoadSceneAsync:
+        if (!command.path) return false;
+        return BeginLoadScene(command.path);
+
+    case EditorCommandType::SetActiveObject:
+        if (!m_scene.IsAlive(command.object)) return false;
+        SetActiveObject(command.object);
+        return true;
+
+    case EditorCommandType::SetActiveTransform:
+        return SetActiveObjectTransform(command.pos, command.rot, command.scale);
+
+    case EditorCommandType::SetActiveParent:
+        return SetActiveObjectParent(command.object);
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "editor/EditorCommands.h"
+#include "editor/MeshAssets.h"
+#include "editor/Scene.h"
+#include "editor/SceneBVH.h"
+#include "engine/core/BackgroundThread.h"
+
+class JobSystem;
+struct SceneBinaryContents;
+struct SceneLoad;
+
+// Progress and timings of the last BeginLoadScene; times are ms since the request.
+struct SceneLoadStats {
+    bool loading = false;
+    bool failed = false;
+    uint32_t objects = 0;
+    uint32_t objectsPublished = 0;
+    uint32_t meshes = 0;            // in the file (text files have none)
+    uint32_t meshesResident = 0;
+    uint32_t placeholders = 0;      // objects first shown with the placeholder mesh
+    uint32_t slices = 0;            // UpdateSceneLoad calls that published something
+    double readMs = 0.0;            // loader thread: file read, checked and ordered
+    double firstObjectsMs = 0.0;    // the first frame with loaded objects in the scene
+    double allObjectsMs = 0.0;
+    double allMeshesMs = 0.0;       // the last placeholder replaced
+    double maxSliceMs = 0.0;        // longest single UpdateSceneLoad
+};
+
+// What the editor edits: scene objects, their mesh assets, the active object and the world bounds used
+// for picking, plus the operations EditorCommands perform on them. No platform, GPU or UI types, so the
+// windowed App and headless hosts (tools/replay) run the same code for every command.
+//
+// Derived classes get OnActiveObjectChanging before the active object (or the asset it points into)
+// goes away and OnActiveObjectChanged after, to drop and re-point any selection state they keep.
+class SceneDocument {
+public:
+    // Main thread time per frame spent publishing an asynchronous load.
+    static constexpr double kLoadSliceSeconds = 0.004;
+
+    SceneDocument();
+    virtual ~SceneDocument();
+
+    // The two tetrahedra the editor starts with.
+    void CreateDefaultScene();
+
+    // Spreads work such as text scene parsing over jobs; null runs it on the calling thread.
+    void SetJobSystem(JobSystem* jobs) { m_jobs = jobs; }
+
+    const Scene& GetScene() const { return m_scene; }
+    const MeshAssetRegistry& MeshAssets() const { return m_meshAssets; }
+    uint32_t ObjectCount() const { return m_scene.Count(); }
+    ObjectHandle ActiveObject() const { return m_activeObject; }
+    void SetActiveObject(ObjectHandle object);
+
+    bool AddObject(const DirectX::XMFLOAT3& pos);
+    bool DuplicateActiveObject();
+    bool DeleteActiveObject();
+    void ResetAllObjects();
+
+    bool SaveSceneAem(const wchar_t* path);
+    bool LoadSceneAem(const wchar_t* path);
+    // Binary container with mesh geometry, loaded from a memory mapping (see SceneBinary.h).
+    bool SaveSceneBinary(const wchar_t* path);
+    bool LoadSceneBinary(const wchar_t* path);
+    // SaveScene/LoadScene commands pick the format by extension: .aeb is binary, anything else text.
+    static bool IsBinaryScenePath(const wchar_t* path);
+
+    // Asynchronous load of either format. A loader thread reads and checks the file, then decodes its
+    // meshes; UpdateSceneLoad (once per frame) replaces the scene once the file has been read and
+    // publishes objects a slice at a time in file order, so indices end up as after a synchronous load.
+    // Objects arrive as roots and are linked to their parents when the last one is in.
+    // Until its mesh is decoded an object shows the built-in tetrahedron. A file that fails leaves the
+    // scene as it was. Cancelling keeps what was published. Any other load, synchronous or not, cancels
+    // a running one.
+    bool BeginLoadScene(const wchar_t* path);
+    void UpdateSceneLoad(double budgetSeconds);
+    void CancelSceneLoad();
+    bool IsLoadingScene() const { return m_load != nullptr; }
+    const SceneLoadStats& LoadStats() const { return m_loadStats; }
+    // Why the last load, synchronous or not, failed; empty once one succeeds.
+    const std::string& LastLoadError() const { return m_loadError; }
+
+    bool GetActiveObjectTransform(DirectX::XMFLOAT3& pos, DirectX::XMFLOAT3& rot, DirectX::XMFLOAT3& scale) const;
+    bool SetActiveObjectTransform(const DirectX::XMFLOAT3& pos, const DirectX::XMFLOAT3& rot, const DirectX::XMFLOAT3& scale);
+    bool SetActiveObjectParent(ObjectHandle parent);
+
+    // Runs the commands that only touch the document. Returns false for the ones that need a view
+    // (SetGizmoMode, FocusCamera) and for commands that fail.
+    bool ExecuteCommand(const EditorCommand& command);
+
+    // Nearest object whose mesh the world-space ray hits (dense index), or -1.
+    int PickObject(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir);
+
+protected:
+    // Meshes are shared assets; objects hold a reference each. m_tetraMesh is the built-in primitive
+    // (the document keeps one reference so it survives with no instances).
+    MeshAssetRegistry m_meshAssets;
+    MeshAssetID m_tetraMesh = kInvalidMeshAssetID;
+
+    Scene m_scene;
+    ObjectHandle m_activeObject;
+    uint32_t ActiveIndex() const { return m_scene.IndexOf(m_activeObject); } //Scene::kInvalidIndex if none
+
+    // World-space bounds of every object, one proxy per object index (userData = index).
+    SceneBVH m_sceneBvh;
+    std::vector<int32_t> m_objectProxies;
+    std::vector<DirectX::XMFLOAT4X4> m_proxyWorlds; //world matrix each proxy box was built from (parents move children too)
+    std::vector<MeshAssetID> m_proxyMeshes;          //mesh asset and its version each box was built from
+    std::vector<uint64_t> m_proxyMeshVersions;
+
+    virtual void OnActiveObjectChanging() {}
+    virtual void OnActiveObjectChanged() {}
+
+    // Loads run on m_loaderThread and share their state with it; see SceneDocument.cpp.
+    BackgroundThread m_loaderThread{ "Scene Loader" };
+    std::shared_ptr<SceneLoad> m_load;
+    SceneLoadStats m_loadStats;
+    std::string m_loadError;
+    JobSystem* m_jobs = nullptr;
+
+    ObjectHandle SpawnObject(const ObjectTransform& transform, const DirectX::XMFLOAT4& color, MeshAssetID mesh);
+    void ApplySceneFile(const SceneBinaryContents& contents);
+    void PublishLoadedMesh(SceneLoad& load, uint32_t mesh);
+    void LinkLoadedObjects(const SceneLoad& load);
+    void FinishSceneLoad();
+    MeshBVH* PickBvh(MeshAssetID mesh);
+    void SyncSceneBvh();
+};
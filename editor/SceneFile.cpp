@@ -0,0 +1,299 @@
+#include "editor/SceneFile.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/Profiler.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Lines parsed as one job. Small enough that a chunk the main thread picks up while it waits on other
+// jobs costs it well under a millisecond.
+constexpr size_t kAemChunkBytes = 64 * 1024;
+
+// Lines and columns count from 1.
+struct AemError {
+    uint32_t line = 0;
+    uint32_t column = 0;
+    const char* message = nullptr;
+};
+
+struct AemChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;            // just past a '\n', or the end of the text
+    const char* firstLineStart = nullptr; // before begin for the line the header ends on
+    uint32_t lines = 0;                   // '\n' in the chunk
+    uint32_t objects = 0;                 // lines that are not blank
+    uint32_t firstLine = 0;
+    uint32_t firstObject = 0;
+    AemError error;                       // first error in the chunk, if any
+};
+
+bool Fail(std::string* error, uint32_t line, uint32_t column, const char* message) {
+    if (error) {
+        char text[192];
+        std::snprintf(text, sizeof(text), "line %u, column %u: %s", line, column, message);
+        *error = text;
+    }
+    return false;
+}
+
+// Whitespace as fscanf skips it, minus '\n', which ends an object.
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) { ++p; }
+    return p;
+}
+
+const char* FieldEnd(const char* p, const char* end) {
+    while (p < end && !IsBlank(*p) && *p != '\n') { ++p; }
+    return p;
+}
+
+bool IsFieldEnd(const char* p, const char* end) {
+    return p == end || IsBlank(*p) || *p == '\n';
+}
+
+// fscanf accepts a leading '+', from_chars does not.
+const char* SkipPlus(const char* p, const char* last) {
+    return (last - p >= 2 && p[0] == '+' && p[1] != '-' && p[1] != '+') ? p + 1 : p;
+}
+
+// The field readers skip blanks, read one whole field and move p past it. On failure p is left at the
+// start of the field, for the error's column. Numbers are scanned once, by from_chars, which stops
+// where the field ends.
+bool ReadWord(const char*& p, const char* end, const char* word) {
+    p = SkipBlanks(p, end);
+    const char* last = FieldEnd(p, end);
+    size_t length = std::strlen(word);
+    if ((size_t)(last - p) != length || std::memcmp(p, word, length) != 0) { return false; }
+    p = last;
+    return true;
+}
+
+template <typename T>
+bool ReadInteger(const char*& p, const char* end, T& value) {
+    p = SkipBlanks(p, end);
+    std::from_chars_result result = std::from_chars(SkipPlus(p, end), end, value);
+    if (result.ec != std::errc() || !IsFieldEnd(result.ptr, end)) { return false; }
+    p = result.ptr;
+    return true;
+}
+
+// Same value as fscanf's %f: from_chars rounds correctly too, but leaves values out of float's range
+// untouched where strtof returns infinity or a denormal, so those go through strtof.
+bool ReadFloat(const char*& p, const char* end, float& value) {
+    p = SkipBlanks(p, end);
+    std::from_chars_result result = std::from_chars(SkipPlus(p, end), end, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        char field[64] = {};
+        if (result.ptr - p >= (ptrdiff_t)sizeof(field)) { return false; }
+        std::memcpy(field, p, result.ptr - p);
+        value = std::strtof(field, nullptr);
+    } else if (result.ec != std::errc()) {
+        return false;
+    }
+    if (!IsFieldEnd(result.ptr, end)) { return false; }
+    p = result.ptr;
+    return true;
+}
+
+void CountChunk(AemChunk& chunk) {
+    for (const char* p = chunk.begin; p < chunk.end;) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        const char* lineEnd = newline ? newline : chunk.end;
+        if (SkipBlanks(p, lineEnd) < lineEnd) { chunk.objects++; }
+        if (!newline) { break; }
+        chunk.lines++;
+        p = newline + 1;
+    }
+}
+
+// One object per line, written at its index in out; blank lines are skipped. Lines past objectCount
+// are not looked at, as fscanf never read them.
+void ParseChunk(AemChunk& chunk, uint32_t objectCount, bool hasParents, SceneFileData& out) {
+    uint32_t index = chunk.firstObject;
+    uint32_t line = chunk.firstLine;
+    const char* lineStart = chunk.firstLineStart;
+    for (const char* p = chunk.begin; p < chunk.end && index < objectCount; ++line) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        const char* lineEnd = newline ? newline : chunk.end;
+        const char* at = SkipBlanks(p, lineEnd);
+        auto fail = [&](const char* message) { chunk.error = AemError{ line, (uint32_t)(at - lineStart) + 1, message }; };
+
+        if (at < lineEnd) {
+            DirectX::XMFLOAT3& pos = out.positions[index];
+            DirectX::XMFLOAT3& rot = out.rotations[index];
+            DirectX::XMFLOAT3& scale = out.scales[index];
+            DirectX::XMFLOAT4& color = out.colors[index];
+            float* fields[] = {
+                &pos.x, &pos.y, &pos.z,
+                &rot.x, &rot.y, &rot.z,
+                &scale.x, &scale.y, &scale.z,
+                &color.x, &color.y, &color.z, &color.w
+            };
+
+            if (!ReadWord(at, lineEnd, "obj")) { fail("expected \"obj\""); return; }
+            if (!ReadWord(at, lineEnd, "tetra")) { fail("expected \"tetra\""); return; }
+            for (float* field : fields) {
+                if (!ReadFloat(at, lineEnd, *field)) { fail("expected a number"); return; }
+            }
+            int32_t parent = -1;
+            if (hasParents && !ReadInteger(at, lineEnd, parent)) { fail("expected a parent index"); return; }
+            out.parents[index] = parent; //range and cycles are checked when the links are applied
+
+            at = SkipBlanks(at, lineEnd);
+            if (at < lineEnd) { fail("unexpected text after the object"); return; }
+            index++;
+        }
+
+        if (!newline) { break; }
+        p = lineStart = newline + 1;
+    }
+}
+
+} // namespace
+
+FILE* OpenSceneFile(const wchar_t* path, bool write) {
+#ifdef _WIN32
+    FILE* f = nullptr;
+    if (_wfopen_s(&f, path, write ? L"wb" : L"rb") != 0) { return nullptr; }
+    return f;
+#else
+    return std::fopen(WidePathToUtf8(path).c_str(), write ? "wb" : "rb");
+#endif
+}
+
+bool ReadSceneAem(const wchar_t* path, SceneFileData& out, JobSystem* jobs, const std::atomic<bool>* cancel, std::string* error) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        if (error) { *error = "cannot open the file (missing or empty)"; }
+        return false;
+    }
+    return ParseSceneAem(static_cast<const char*>(file.Data()), file.Size(), out, jobs, cancel, error);
+}
+
+bool ParseSceneAem(const char* text, size_t bytes, SceneFileData& out, JobSystem* jobs, const std::atomic<bool>* cancel, std::string* error) {
+    // Format: see SceneDocument::SaveSceneAem.
+    AE_PROFILE_ZONE("ParseSceneAem");
+    const char* end = text + bytes;
+
+    // Header fields may be spread over lines, as fscanf allowed.
+    const char* at = text;
+    const char* lineStart = text;
+    uint32_t line = 1;
+    auto nextField = [&]() {
+        for (; at < end && (IsBlank(*at) || *at == '\n'); ++at) {
+            if (*at == '\n') { line++; lineStart = at + 1; }
+        }
+        return at;
+    };
+    auto failHere = [&](const char* message) { return Fail(error, line, (uint32_t)(at - lineStart) + 1, message); };
+
+    int32_t version = 0;
+    uint32_t n = 0;
+    uint32_t active = 0;
+    nextField();
+    if (!ReadWord(at, end, "AE_MODEL")) { return failHere("not a scene file (expected AE_MODEL)"); }
+    const char* versionField = nextField();
+    if (!ReadInteger(at, end, version)) { return failHere("expected a version number"); }
+    if (version < 1 || version > 2) { at = versionField; return failHere("unsupported version"); }
+    nextField();
+    if (!ReadWord(at, end, "objects")) { return failHere("expected \"objects\""); }
+    nextField();
+    if (!ReadInteger(at, end, n)) { return failHere("expected an object count"); }
+    nextField();
+    if (!ReadWord(at, end, "active")) { return failHere("expected \"active\""); }
+    nextField();
+    if (!ReadInteger(at, end, active)) { return failHere("expected an object index"); }
+
+    if (n == 0) n = 1;
+
+    // Objects: chunks of whole lines, counted first so each knows the index of its first object.
+    std::vector<AemChunk> chunks;
+    for (const char* begin = at; begin < end;) {
+        const char* split = ((size_t)(end - begin) > kAemChunkBytes) ? begin + kAemChunkBytes : end;
+        const char* newline = (split < end) ? static_cast<const char*>(std::memchr(split, '\n', end - split)) : nullptr;
+        AemChunk chunk;
+        chunk.begin = begin;
+        chunk.end = newline ? newline + 1 : end;
+        chunk.firstLineStart = chunks.empty() ? lineStart : begin;
+        chunks.push_back(chunk);
+        begin = chunk.end;
+    }
+
+    auto forEachChunk = [&](const JobSystem::RangeFunction& body) {
+        if (jobs) {
+            jobs->ParallelFor((uint32_t)chunks.size(), 4, body);
+        } else {
+            body(0, (uint32_t)chunks.size());
+        }
+    };
+
+    forEachChunk([&](uint32_t first, uint32_t last) {
+        for (uint32_t c = first; c < last; ++c) { CountChunk(chunks[c]); }
+    });
+
+    uint32_t objects = 0;
+    for (AemChunk& chunk : chunks) {
+        chunk.firstLine = line;
+        chunk.firstObject = objects;
+        line += chunk.lines;
+        objects += chunk.objects;
+    }
+    if (objects < n) {
+        char message[96];
+        std::snprintf(message, sizeof(message), "file ends after %u of %u objects", objects, n);
+        return Fail(error, line, 1, message);
+    }
+
+    // Sized only now that the file is known to hold n lines, so a bad count cannot allocate gigabytes.
+    out.positions.resize(n);
+    out.rotations.resize(n);
+    out.scales.resize(n);
+    out.colors.resize(n);
+    out.parents.resize(n);
+
+    forEachChunk([&](uint32_t first, uint32_t last) {
+        for (uint32_t c = first; c < last && chunks[c].firstObject < n; ++c) {
+            if (cancel && cancel->load(std::memory_order_relaxed)) { return; }
+            ParseChunk(chunks[c], n, version >= 2, out);
+        }
+    });
+
+    if (cancel && cancel->load(std::memory_order_relaxed)) {
+        if (error) { *error = "cancelled"; }
+        return false;
+    }
+    for (const AemChunk& chunk : chunks) {
+        if (chunk.error.message) { return Fail(error, chunk.error.line, chunk.error.column, chunk.error.message); }
+    }
+
+    SceneBinaryContents& contents = out.contents;
+    contents = SceneBinaryContents();
+    contents.objectCount = n;
+    contents.activeIndex = (active < n) ? active : 0;
+    contents.positions = out.positions.data();
+    contents.rotations = out.rotations.data();
+    contents.scales = out.scales.data();
+    contents.colors = out.colors.data();
+    contents.parents = out.parents.data();
+    return true;
+}
+
+bool ReadSceneBinary(const wchar_t* path, SceneFileData& out, std::string* error) {
+    if (!out.mapping.Open(path)) {
+        if (error) { *error = "cannot open the file (missing or empty)"; }
+        return false;
+    }
+    if (!OpenSceneBinary(out.mapping.Data(), out.mapping.Size(), out.contents, error)) return false;
+    if (out.contents.objectCount == 0) {
+        if (error) { *error = "file has no objects"; } //the editor always keeps one object
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "editor/SceneBinary.h"
+#include "engine/core/MappedFile.h"
+
+class JobSystem;
+
+// A scene file read into memory but not yet applied to a document, in file order. contents views the
+// arrays whichever format they came from: .aeb points into the mapping, .aem into the vectors below.
+// Text files carry no geometry: contents.objectMeshes is null and every object uses the built-in
+// tetrahedron. Reading touches no document state, so it can run on any thread.
+struct SceneFileData {
+    SceneBinaryContents contents;
+
+    MappedFile mapping;
+    std::vector<DirectX::XMFLOAT3> positions;
+    std::vector<DirectX::XMFLOAT3> rotations;
+    std::vector<DirectX::XMFLOAT3> scales;
+    std::vector<DirectX::XMFLOAT4> colors;
+    std::vector<int32_t> parents;
+};
+
+FILE* OpenSceneFile(const wchar_t* path, bool write);
+
+// Both fail on files that do not parse or validate, and error says why (for text: "line L, column C: ...").
+// cancel, when given, is polled between chunks of objects and makes the read fail once set.
+// Text is read from a mapping and parsed in chunks of whole lines, one object per line. With jobs the
+// chunks are parsed in parallel, so pass jobs only from a thread that takes part in it (the main thread).
+bool ReadSceneAem(const wchar_t* path, SceneFileData& out, JobSystem* jobs = nullptr, const std::atomic<bool>* cancel = nullptr, std::string* error = nullptr);
+bool ParseSceneAem(const char* text, size_t bytes, SceneFileData& out, JobSystem* jobs = nullptr, const std::atomic<bool>* cancel = nullptr, std::string* error = nullptr);
+bool ReadSceneBinary(const wchar_t* path, SceneFileData& out, std::string* error = nullptr);
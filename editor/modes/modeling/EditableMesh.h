@@ -1,6 +1,10 @@
 #pragma once
 #include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 using namespace DirectX;
 
@@ -16,20 +20,58 @@ struct EditTriangle {
     VertexID c = 0;
 };
 
+// Local-space bounds of a mesh. The sphere is centered on the box and just encloses every vertex,
+// which is tighter than the half diagonal for most shapes.
+struct MeshBounds {
+    XMFLOAT3 min = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    XMFLOAT3 max = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    XMFLOAT3 center = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    float radius = 0.0f;
+    bool empty = true;
+};
+
 // Authoritative mesh data for editing (CPU-side truth)
+// Storage is growable: positions/triangles are contiguous arrays that grow geometrically,
+// so AddVertex/AddTriangle are amortized O(1) with no per-element allocation. Clear() keeps
+// the capacity, so rebuilding a mesh of similar size does not touch the allocator again.
 struct EditableMesh {
-    static constexpr uint32_t kMaxVertices = 64;
-    static constexpr uint32_t kMaxTriangles = 128;
+    // IDs are 32-bit and the all-ones value is reserved for kInvalid*ID.
+    static constexpr uint32_t kMaxVertices = kInvalidVertexID;
+    static constexpr uint32_t kMaxTriangles = kInvalidTriangleID;
 
     uint32_t vertexCount = 0;
     uint32_t triangleCount = 0;
 
-    XMFLOAT3 positions[kMaxVertices] = {};
-    EditTriangle triangles[kMaxTriangles] = {};
+    // Change counters for derived data (BVHs, caches). version bumps on every edit,
+    // topologyVersion only when vertices/triangles are added, removed or rewired.
+    uint64_t version = 0;
+    uint64_t topologyVersion = 0;
+
+    std::vector<XMFLOAT3> positions;
+    std::vector<EditTriangle> triangles;
+
+    // Filled by GetBounds() and reused until version changes.
+    mutable MeshBounds cachedBounds;
+    mutable uint64_t cachedBoundsVersion = ~0ull;
 
     void Clear() {
         vertexCount = 0;
         triangleCount = 0;
+        positions.clear();
+        triangles.clear();
+        version++;
+        topologyVersion++;
+    }
+
+    // Pre-size storage for bulk builds (importers, generators) so growth never happens mid-build.
+    void Reserve(uint32_t vertices, uint32_t tris) {
+        positions.reserve(vertices);
+        triangles.reserve(tris);
+    }
+
+    // Heap bytes held by the mesh storage (capacity, not just the active counts).
+    size_t MemoryBytes() const {
+        return positions.capacity() * sizeof(XMFLOAT3) + triangles.capacity() * sizeof(EditTriangle);
     }
 
     bool IsValidVertex(VertexID v) const {
@@ -43,7 +85,9 @@ struct EditableMesh {
     VertexID AddVertex(const XMFLOAT3& p) {
         if (vertexCount >= kMaxVertices) { return kInvalidVertexID; }
         VertexID id = vertexCount++;
-        positions[id] = p;
+        positions.push_back(p);
+        version++;
+        topologyVersion++;
         return id;
     }
 
@@ -52,15 +96,16 @@ struct EditableMesh {
         if (!IsValidVertex(a) || !IsValidVertex(b) || !IsValidVertex(c)) { return kInvalidTriangleID; }
 
         TriangleID id = triangleCount++;
-        triangles[id].a = a;
-        triangles[id].b = b;
-        triangles[id].c = c;
+        triangles.push_back(EditTriangle{ a, b, c });
+        version++;
+        topologyVersion++;
         return id;
     }
 
     void SetVertex(VertexID v, const XMFLOAT3& p) {
         if (!IsValidVertex(v)) { return; }
         positions[v] = p;
+        version++;
     }
 
     XMFLOAT3 GetVertex(VertexID v) const {
@@ -75,6 +120,8 @@ struct EditableMesh {
         triangles[t].a = a;
         triangles[t].b = b;
         triangles[t].c = c;
+        version++;
+        topologyVersion++;
     }
 
     EditTriangle GetTriangle(TriangleID t) const {
@@ -91,8 +138,41 @@ struct EditableMesh {
         return tri.c;
     }
 
+    // O(1) while the mesh is unchanged, one pass over the vertices after an edit.
+    const MeshBounds& GetBounds() const {
+        if (cachedBoundsVersion == version) { return cachedBounds; }
+
+        MeshBounds bounds;
+        if (vertexCount > 0) {
+            bounds.min = positions[0];
+            bounds.max = positions[0];
+            for (uint32_t i = 1; i < vertexCount; ++i) {
+                const XMFLOAT3& p = positions[i];
+                bounds.min = XMFLOAT3((std::min)(bounds.min.x, p.x), (std::min)(bounds.min.y, p.y), (std::min)(bounds.min.z, p.z));
+                bounds.max = XMFLOAT3((std::max)(bounds.max.x, p.x), (std::max)(bounds.max.y, p.y), (std::max)(bounds.max.z, p.z));
+            }
+
+            bounds.center = XMFLOAT3((bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f);
+
+            float radiusSq = 0.0f;
+            for (uint32_t i = 0; i < vertexCount; ++i) {
+                float dx = positions[i].x - bounds.center.x;
+                float dy = positions[i].y - bounds.center.y;
+                float dz = positions[i].z - bounds.center.z;
+                radiusSq = (std::max)(radiusSq, dx * dx + dy * dy + dz * dz);
+            }
+            bounds.radius = std::sqrt(radiusSq);
+            bounds.empty = false;
+        }
+
+        cachedBounds = bounds;
+        cachedBoundsVersion = version;
+        return cachedBounds;
+    }
+
     void BuildTetrahedron(float s) {
         Clear();
+        Reserve(4, 4);
 
         VertexID top = AddVertex(XMFLOAT3(0.0f, 0.0f, s));
         VertexID right = AddVertex(XMFLOAT3(0.9428f * s, 0.0f, -0.3333f * s));
@@ -0,0 +1,426 @@
+#include "editor/modes/modeling/MeshBVH.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+
+using namespace DirectX;
+
+namespace {
+
+struct Aabb {
+    XMFLOAT3 mn = { FLT_MAX, FLT_MAX, FLT_MAX };
+    XMFLOAT3 mx = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    void Grow(const XMFLOAT3& p) {
+        mn.x = (std::min)(mn.x, p.x); mn.y = (std::min)(mn.y, p.y); mn.z = (std::min)(mn.z, p.z);
+        mx.x = (std::max)(mx.x, p.x); mx.y = (std::max)(mx.y, p.y); mx.z = (std::max)(mx.z, p.z);
+    }
+
+    void Grow(const Aabb& b) {
+        if (b.mn.x > b.mx.x) { return; }
+        Grow(b.mn);
+        Grow(b.mx);
+    }
+
+    float HalfArea() const {
+        if (mn.x > mx.x) { return 0.0f; }
+        float dx = mx.x - mn.x;
+        float dy = mx.y - mn.y;
+        float dz = mx.z - mn.z;
+        return dx * dy + dy * dz + dz * dx;
+    }
+};
+
+float Axis(const XMFLOAT3& p, int axis) {
+    return (axis == 0) ? p.x : (axis == 1) ? p.y : p.z;
+}
+
+struct BuildTask {
+    uint32_t node;
+    uint32_t first;
+    uint32_t count;
+    uint32_t depth;
+};
+
+// From this depth on, ranges are split at the median instead of by SAH. Halving reaches a leaf within
+// 31 levels for any 32-bit count, which keeps every leaf within MeshBVH::kMaxDepth.
+const uint32_t kMedianSplitDepth = MeshBVH::kMaxDepth - 31;
+
+// Turns task's node into an inner node over [first, mid) and [mid, first + count).
+void PushChildren(std::vector<MeshBVHNode>& nodes, std::vector<uint32_t>& parents, std::vector<BuildTask>& stack, const BuildTask& task, uint32_t mid) {
+    uint32_t left = (uint32_t)nodes.size();
+    nodes.push_back(MeshBVHNode{});
+    nodes.push_back(MeshBVHNode{});
+    parents.push_back(task.node);
+    parents.push_back(task.node);
+
+    MeshBVHNode& inner = nodes[task.node]; // re-fetch, push_back may have reallocated
+    inner.leftOrFirst = left;
+    inner.triangleCount = 0;
+
+    stack.push_back(BuildTask{ left, task.first, mid - task.first, task.depth + 1 });
+    stack.push_back(BuildTask{ left + 1, mid, task.first + task.count - mid, task.depth + 1 });
+}
+
+// Slab test. Returns entry distance in tNear, false if the box is missed or behind tMax.
+bool RayHitsBox(const XMFLOAT3& origin, const XMFLOAT3& invDir, const MeshBVHNode& node, float tMax, float& tNear) {
+    float tx0 = (node.boundsMin.x - origin.x) * invDir.x;
+    float tx1 = (node.boundsMax.x - origin.x) * invDir.x;
+    float tmin = (std::min)(tx0, tx1);
+    float tmax = (std::max)(tx0, tx1);
+
+    float ty0 = (node.boundsMin.y - origin.y) * invDir.y;
+    float ty1 = (node.boundsMax.y - origin.y) * invDir.y;
+    tmin = (std::max)(tmin, (std::min)(ty0, ty1));
+    tmax = (std::min)(tmax, (std::max)(ty0, ty1));
+
+    float tz0 = (node.boundsMin.z - origin.z) * invDir.z;
+    float tz1 = (node.boundsMax.z - origin.z) * invDir.z;
+    tmin = (std::max)(tmin, (std::min)(tz0, tz1));
+    tmax = (std::min)(tmax, (std::max)(tz0, tz1));
+
+    tNear = tmin;
+    return tmax >= (std::max)(tmin, 0.0f) && tmin < tMax;
+}
+
+} // namespace
+
+void MeshBVH::Clear() {
+    m_mesh = nullptr;
+    m_topologyVersion = 0;
+    m_depth = 0;
+    m_nodes.clear();
+    m_parents.clear();
+    m_triangleOrder.clear();
+    m_triangleLeaf.clear();
+    m_triangleSlot.clear();
+    m_batch.Clear();
+    m_vertexTriOffsets.clear();
+    m_vertexTriList.clear();
+}
+
+void MeshBVH::Build(const EditableMesh& mesh) {
+    Clear();
+
+    m_mesh = &mesh;
+    m_topologyVersion = mesh.topologyVersion;
+
+    const uint32_t triCount = mesh.triangleCount;
+    if (triCount == 0) { return; }
+
+    // Per-triangle bounds and centroids (build-time scratch only).
+    std::vector<Aabb> triBounds(triCount);
+    std::vector<XMFLOAT3> centroids(triCount);
+
+    for (uint32_t t = 0; t < triCount; ++t) {
+        const EditTriangle& tri = mesh.triangles[t];
+        const XMFLOAT3& a = mesh.positions[tri.a];
+        const XMFLOAT3& b = mesh.positions[tri.b];
+        const XMFLOAT3& c = mesh.positions[tri.c];
+
+        triBounds[t].Grow(a);
+        triBounds[t].Grow(b);
+        triBounds[t].Grow(c);
+        centroids[t] = XMFLOAT3((a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f);
+    }
+
+    m_triangleOrder.resize(triCount);
+    for (uint32_t t = 0; t < triCount; ++t) { m_triangleOrder[t] = t; }
+
+    m_nodes.reserve(size_t(triCount) * 2);
+    m_parents.reserve(size_t(triCount) * 2);
+    m_nodes.push_back(MeshBVHNode{});
+    m_parents.push_back(UINT32_MAX);
+
+    std::vector<BuildTask> stack;
+    stack.push_back(BuildTask{ 0, 0, triCount, 0 });
+
+    while (!stack.empty()) {
+        BuildTask task = stack.back();
+        stack.pop_back();
+
+        Aabb bounds;
+        Aabb centroidBounds;
+        for (uint32_t i = task.first; i < task.first + task.count; ++i) {
+            uint32_t t = m_triangleOrder[i];
+            bounds.Grow(triBounds[t]);
+            centroidBounds.Grow(centroids[t]);
+        }
+
+        MeshBVHNode& node = m_nodes[task.node];
+        node.boundsMin = bounds.mn;
+        node.boundsMax = bounds.mx;
+        node.leftOrFirst = task.first;
+        node.triangleCount = task.count;
+        m_depth = (std::max)(m_depth, task.depth);
+
+        if (task.count <= kMaxLeafTriangles) { continue; }
+
+        // Deep ranges (long thin or degenerate meshes): median split along the widest centroid axis.
+        if (task.depth >= kMedianSplitDepth) {
+            float extent[3] = {};
+            for (int axis = 0; axis < 3; ++axis) { extent[axis] = Axis(centroidBounds.mx, axis) - Axis(centroidBounds.mn, axis); }
+            int axis = (extent[0] >= extent[1] && extent[0] >= extent[2]) ? 0 : (extent[1] >= extent[2]) ? 1 : 2;
+
+            uint32_t* begin = m_triangleOrder.data() + task.first;
+            uint32_t mid = task.first + task.count / 2;
+            std::nth_element(begin, m_triangleOrder.data() + mid, begin + task.count, [&](uint32_t a, uint32_t b) {
+                return Axis(centroids[a], axis) < Axis(centroids[b], axis);
+            });
+            PushChildren(m_nodes, m_parents, stack, task, mid);
+            continue;
+        }
+
+        // Binned SAH: bin centroids along each axis and evaluate the kBinCount - 1 split planes.
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            float cmin = Axis(centroidBounds.mn, axis);
+            float cmax = Axis(centroidBounds.mx, axis);
+            if (cmax - cmin < 1e-12f) { continue; }
+
+            Aabb binBounds[kBinCount];
+            uint32_t binCounts[kBinCount] = {};
+            float scale = float(kBinCount) / (cmax - cmin);
+
+            for (uint32_t i = task.first; i < task.first + task.count; ++i) {
+                uint32_t t = m_triangleOrder[i];
+                uint32_t bin = (std::min)(kBinCount - 1, uint32_t((Axis(centroids[t], axis) - cmin) * scale));
+                binCounts[bin]++;
+                binBounds[bin].Grow(triBounds[t]);
+            }
+
+            float leftArea[kBinCount - 1];
+            uint32_t leftCount[kBinCount - 1];
+            Aabb acc;
+            uint32_t accCount = 0;
+            for (uint32_t b = 0; b < kBinCount - 1; ++b) {
+                acc.Grow(binBounds[b]);
+                accCount += binCounts[b];
+                leftArea[b] = acc.HalfArea();
+                leftCount[b] = accCount;
+            }
+
+            acc = Aabb();
+            accCount = 0;
+            for (uint32_t b = kBinCount - 1; b > 0; --b) {
+                acc.Grow(binBounds[b]);
+                accCount += binCounts[b];
+
+                float cost = leftArea[b - 1] * float(leftCount[b - 1]) + acc.HalfArea() * float(accCount);
+                if (leftCount[b - 1] > 0 && accCount > 0 && cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        // Keep as a leaf when no split beats intersecting every triangle in it.
+        float leafCost = bounds.HalfArea() * float(task.count);
+        if (bestAxis < 0 || (bestCost >= leafCost && task.count <= kMaxLeafTriangles * 4)) {
+            if (bestAxis < 0 && task.count > kMaxLeafTriangles) {
+                // All centroids coincide: split the range in half so leaves stay small.
+                bestAxis = 0;
+                bestSplit = 0;
+            } else {
+                continue;
+            }
+        }
+
+        uint32_t mid = 0;
+        if (bestSplit == 0) {
+            mid = task.first + task.count / 2;
+        } else {
+            float cmin = Axis(centroidBounds.mn, bestAxis);
+            float scale = float(kBinCount) / (Axis(centroidBounds.mx, bestAxis) - cmin);
+
+            uint32_t* begin = m_triangleOrder.data() + task.first;
+            uint32_t* end = begin + task.count;
+            uint32_t* split = std::partition(begin, end, [&](uint32_t t) {
+                uint32_t bin = (std::min)(kBinCount - 1, uint32_t((Axis(centroids[t], bestAxis) - cmin) * scale));
+                return bin < bestSplit;
+            });
+            mid = uint32_t(split - m_triangleOrder.data());
+        }
+
+        PushChildren(m_nodes, m_parents, stack, task, mid);
+    }
+
+    m_triangleLeaf.assign(triCount, 0);
+    for (uint32_t n = 0; n < (uint32_t)m_nodes.size(); ++n) {
+        const MeshBVHNode& node = m_nodes[n];
+        if (!node.IsLeaf()) { continue; }
+        for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+            m_triangleLeaf[m_triangleOrder[i]] = n;
+        }
+    }
+
+    m_triangleSlot.resize(triCount);
+    for (uint32_t slot = 0; slot < triCount; ++slot) { m_triangleSlot[m_triangleOrder[slot]] = slot; }
+    m_batch.Build(mesh, m_triangleOrder.data());
+
+    m_vertexTriOffsets.assign(size_t(mesh.vertexCount) + 1, 0);
+    for (uint32_t t = 0; t < triCount; ++t) {
+        const EditTriangle& tri = mesh.triangles[t];
+        m_vertexTriOffsets[tri.a + 1]++;
+        m_vertexTriOffsets[tri.b + 1]++;
+        m_vertexTriOffsets[tri.c + 1]++;
+    }
+    for (uint32_t v = 0; v < mesh.vertexCount; ++v) {
+        m_vertexTriOffsets[v + 1] += m_vertexTriOffsets[v];
+    }
+
+    m_vertexTriList.resize(size_t(triCount) * 3);
+    std::vector<uint32_t> cursor(m_vertexTriOffsets.begin(), m_vertexTriOffsets.end() - 1);
+    for (uint32_t t = 0; t < triCount; ++t) {
+        const EditTriangle& tri = mesh.triangles[t];
+        m_vertexTriList[cursor[tri.a]++] = t;
+        m_vertexTriList[cursor[tri.b]++] = t;
+        m_vertexTriList[cursor[tri.c]++] = t;
+    }
+}
+
+void MeshBVH::FitLeaf(const EditableMesh& mesh, MeshBVHNode& node) const {
+    Aabb bounds;
+    for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.triangleCount; ++i) {
+        const EditTriangle& tri = mesh.triangles[m_triangleOrder[i]];
+        bounds.Grow(mesh.positions[tri.a]);
+        bounds.Grow(mesh.positions[tri.b]);
+        bounds.Grow(mesh.positions[tri.c]);
+    }
+
+    node.boundsMin = bounds.mn;
+    node.boundsMax = bounds.mx;
+}
+
+void MeshBVH::FitInner(uint32_t nodeIndex) {
+    MeshBVHNode& node = m_nodes[nodeIndex];
+    const MeshBVHNode& left = m_nodes[node.leftOrFirst];
+    const MeshBVHNode& right = m_nodes[node.leftOrFirst + 1];
+
+    node.boundsMin = XMFLOAT3((std::min)(left.boundsMin.x, right.boundsMin.x), (std::min)(left.boundsMin.y, right.boundsMin.y), (std::min)(left.boundsMin.z, right.boundsMin.z));
+    node.boundsMax = XMFLOAT3((std::max)(left.boundsMax.x, right.boundsMax.x), (std::max)(left.boundsMax.y, right.boundsMax.y), (std::max)(left.boundsMax.z, right.boundsMax.z));
+}
+
+void MeshBVH::RefitVertex(const EditableMesh& mesh, VertexID v) {
+    if (!IsBuiltFor(mesh) || v + 1 >= (uint32_t)m_vertexTriOffsets.size()) { return; }
+
+    for (uint32_t i = m_vertexTriOffsets[v]; i < m_vertexTriOffsets[v + 1]; ++i) {
+        uint32_t tri = m_vertexTriList[i];
+        m_batch.UpdateSlot(mesh, m_triangleSlot[tri]);
+
+        uint32_t leaf = m_triangleLeaf[tri];
+        FitLeaf(mesh, m_nodes[leaf]);
+
+        // Walk up and stop as soon as an ancestor's bounds come out unchanged.
+        for (uint32_t n = m_parents[leaf]; n != UINT32_MAX; n = m_parents[n]) {
+            XMFLOAT3 oldMin = m_nodes[n].boundsMin;
+            XMFLOAT3 oldMax = m_nodes[n].boundsMax;
+            FitInner(n);
+
+            const MeshBVHNode& node = m_nodes[n];
+            if (node.boundsMin.x == oldMin.x && node.boundsMin.y == oldMin.y && node.boundsMin.z == oldMin.z &&
+                node.boundsMax.x == oldMax.x && node.boundsMax.y == oldMax.y && node.boundsMax.z == oldMax.z) {
+                break;
+            }
+        }
+    }
+}
+
+bool MeshBVH::Raycast(const EditableMesh& mesh, const XMFLOAT3& rayOrigin, const XMFLOAT3& rayDir, TriangleID& outTriangle, float& outT) const {
+    if (m_nodes.empty() || !IsBuiltFor(mesh)) { return false; }
+
+    // Division by a zero component gives +-inf, which the slab test handles.
+    XMFLOAT3 invDir(1.0f / rayDir.x, 1.0f / rayDir.y, 1.0f / rayDir.z);
+
+    float bestT = FLT_MAX;
+    uint32_t bestSlot = UINT32_MAX;
+
+    uint32_t stack[kMaxDepth + 1];
+    uint32_t stackSize = 0;
+
+    float rootNear = 0.0f;
+    if (!RayHitsBox(rayOrigin, invDir, m_nodes[0], bestT, rootNear)) { return false; }
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const MeshBVHNode& node = m_nodes[stack[--stackSize]];
+
+        if (node.IsLeaf()) {
+            IntersectRayBatch(m_batch, node.leftOrFirst, node.triangleCount, rayOrigin, rayDir, bestT, bestSlot);
+            continue;
+        }
+
+        uint32_t near = node.leftOrFirst;
+        uint32_t far = node.leftOrFirst + 1;
+        float tNear = 0.0f;
+        float tFar = 0.0f;
+        bool hitNear = RayHitsBox(rayOrigin, invDir, m_nodes[near], bestT, tNear);
+        bool hitFar = RayHitsBox(rayOrigin, invDir, m_nodes[far], bestT, tFar);
+
+        if (hitNear && hitFar && tFar < tNear) {
+            std::swap(near, far);
+            std::swap(tNear, tFar);
+        }
+
+        // Push far first so the nearer child is visited first and can shrink bestT.
+        assert(stackSize + 2 <= kMaxDepth + 1);
+        if (hitFar) { stack[stackSize++] = far; }
+        if (hitNear) { stack[stackSize++] = near; }
+    }
+
+    if (bestSlot == UINT32_MAX) { return false; }
+
+    outTriangle = m_batch.ids[bestSlot];
+    outT = bestT;
+    return true;
+}
+
+uint32_t MeshBVH::RaycastPacket(const EditableMesh& mesh, RayPacket& packet, TriangleID* outTriangles) const {
+    packet.ResetHits();
+    for (uint32_t r = 0; r < packet.count; ++r) { outTriangles[r] = kInvalidTriangleID; }
+
+    if (m_nodes.empty() || !IsBuiltFor(mesh) || packet.count == 0) { return 0; }
+
+    XMFLOAT3 invDirs[RayPacket::kMaxRays];
+    for (uint32_t r = 0; r < packet.count; ++r) {
+        invDirs[r] = XMFLOAT3(1.0f / packet.dirs[r].x, 1.0f / packet.dirs[r].y, 1.0f / packet.dirs[r].z);
+    }
+
+    uint32_t stack[kMaxDepth + 1];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const MeshBVHNode& node = m_nodes[stack[--stackSize]];
+
+        bool anyHit = false;
+        for (uint32_t r = 0; r < packet.count && !anyHit; ++r) {
+            float tNear = 0.0f;
+            anyHit = RayHitsBox(packet.origins[r], invDirs[r], node, packet.bestT[r], tNear);
+        }
+        if (!anyHit) { continue; }
+
+        if (node.IsLeaf()) {
+            IntersectPacketBatch(m_batch, node.leftOrFirst, node.triangleCount, packet);
+            continue;
+        }
+
+        assert(stackSize + 2 <= kMaxDepth + 1);
+        stack[stackSize++] = node.leftOrFirst + 1;
+        stack[stackSize++] = node.leftOrFirst;
+    }
+
+    uint32_t hits = 0;
+    for (uint32_t r = 0; r < packet.count; ++r) {
+        if (packet.bestSlot[r] == UINT32_MAX) { continue; }
+        outTriangles[r] = m_batch.ids[packet.bestSlot[r]];
+        hits++;
+    }
+    return hits;
+}
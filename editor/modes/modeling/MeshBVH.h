@@ -0,0 +1,70 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include "EditableMesh.h"
+#include "RayTriangleBatch.h"
+
+struct MeshBVHNode {
+    DirectX::XMFLOAT3 boundsMin = { 0.0f, 0.0f, 0.0f };
+    uint32_t leftOrFirst = 0; // inner: index of left child (right = left + 1), leaf: first entry in triangle order
+    DirectX::XMFLOAT3 boundsMax = { 0.0f, 0.0f, 0.0f };
+    uint32_t triangleCount = 0; // 0 = inner node
+
+    bool IsLeaf() const { return triangleCount != 0; }
+};
+
+// Local-space bounding volume hierarchy over one EditableMesh's triangles, for picking.
+// Built with binned SAH; vertex moves are handled by refitting only the affected leaves
+// and their ancestors (topology changes need a rebuild, see IsBuiltFor).
+class MeshBVH {
+public:
+    static const uint32_t kMaxLeafTriangles = 4;
+    static const uint32_t kBinCount = 12;
+    // Leaves are never deeper than this (the root is depth 0), so the traversal stacks, which hold at
+    // most one node per level plus one, fit in kMaxDepth + 1 entries.
+    static const uint32_t kMaxDepth = 63;
+
+    void Clear();
+    void Build(const EditableMesh& mesh);
+
+    // True when the BVH matches the mesh topology (vertex positions are kept in sync by RefitVertex).
+    bool IsBuiltFor(const EditableMesh& mesh) const { return m_mesh == &mesh && m_topologyVersion == mesh.topologyVersion; }
+
+    // Call after EditableMesh::SetVertex. Cost is O(triangles around v * tree depth).
+    void RefitVertex(const EditableMesh& mesh, VertexID v);
+
+    // Closest hit along a local-space ray. Returns false on miss.
+    bool Raycast(const EditableMesh& mesh, const DirectX::XMFLOAT3& rayOrigin, const DirectX::XMFLOAT3& rayDir, TriangleID& outTriangle, float& outT) const;
+
+    // Closest hit for every ray of a packet (one traversal, a node is entered if any ray hits it).
+    // outTriangles[i] is kInvalidTriangleID for rays that miss. Returns the number of rays that hit.
+    uint32_t RaycastPacket(const EditableMesh& mesh, RayPacket& packet, TriangleID* outTriangles) const;
+
+    uint32_t NodeCount() const { return (uint32_t)m_nodes.size(); }
+    uint32_t Depth() const { return m_depth; } //of the deepest leaf
+    const std::vector<MeshBVHNode>& Nodes() const { return m_nodes; }
+    const std::vector<uint32_t>& TriangleOrder() const { return m_triangleOrder; }
+
+private:
+    const EditableMesh* m_mesh = nullptr;
+    uint64_t m_topologyVersion = 0;
+    uint32_t m_depth = 0;
+
+    std::vector<MeshBVHNode> m_nodes;
+    std::vector<uint32_t> m_parents;         // per node, root = UINT32_MAX
+    std::vector<uint32_t> m_triangleOrder;   // leaf ranges index into this
+    std::vector<uint32_t> m_triangleLeaf;    // triangle -> leaf node
+    std::vector<uint32_t> m_triangleSlot;    // triangle -> slot in m_batch (= index in m_triangleOrder)
+
+    // Leaf triangles in SoA form, in m_triangleOrder order, so a leaf is one contiguous batch.
+    TriangleBatch m_batch;
+
+    // Vertex -> triangles (CSR) so RefitVertex can find the leaves a vertex touches.
+    std::vector<uint32_t> m_vertexTriOffsets;
+    std::vector<uint32_t> m_vertexTriList;
+
+    void FitLeaf(const EditableMesh& mesh, MeshBVHNode& node) const;
+    void FitInner(uint32_t nodeIndex);
+};
@@ -0,0 +1,309 @@
+#include "editor/modes/modeling/RayTriangleBatch.h"
+
+#include <cfloat>
+#include <cmath>
+
+#if AE_RAYTRI_LANES > 1
+#include <immintrin.h>
+#endif
+
+using namespace DirectX;
+
+static const float kDetEpsilon = 1e-9f;
+
+// Shared by RayIntersectsTriangle and the scalar batch path; the SIMD path repeats these ops lane-wise.
+static bool IntersectEdges(const XMFLOAT3& rayOrigin, const XMFLOAT3& rayDir, const XMFLOAT3& a, const XMFLOAT3& e1, const XMFLOAT3& e2, float& outT) {
+    XMFLOAT3 p( //p = dir x e2
+        rayDir.y * e2.z - rayDir.z * e2.y,
+        rayDir.z * e2.x - rayDir.x * e2.z,
+        rayDir.x * e2.y - rayDir.y * e2.x
+    );
+
+    float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+    if (fabsf(det) < kDetEpsilon) { return false; } //ray parallel to the triangle plane
+
+    float invDet = 1.0f / det;
+    XMFLOAT3 s(rayOrigin.x - a.x, rayOrigin.y - a.y, rayOrigin.z - a.z);
+
+    float u = (s.x * p.x + s.y * p.y + s.z * p.z) * invDet;
+    if (u < 0.0f || u > 1.0f) { return false; }
+
+    XMFLOAT3 q( //q = s x e1
+        s.y * e1.z - s.z * e1.y,
+        s.z * e1.x - s.x * e1.z,
+        s.x * e1.y - s.y * e1.x
+    );
+
+    float v = (rayDir.x * q.x + rayDir.y * q.y + rayDir.z * q.z) * invDet;
+    if (v < 0.0f || u + v > 1.0f) { return false; }
+
+    float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * invDet;
+    if (t < 0.0f) { return false; }
+
+    outT = t;
+    return true;
+}
+
+bool RayIntersectsTriangle(const XMFLOAT3& rayOrigin, const XMFLOAT3& rayDir, const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c, float& outT) {
+    XMFLOAT3 e1(b.x - a.x, b.y - a.y, b.z - a.z);
+    XMFLOAT3 e2(c.x - a.x, c.y - a.y, c.z - a.z);
+    return IntersectEdges(rayOrigin, rayDir, a, e1, e2, outT);
+}
+
+void TriangleBatch::Clear() {
+    count = 0;
+    v0x.clear(); v0y.clear(); v0z.clear();
+    e1x.clear(); e1y.clear(); e1z.clear();
+    e2x.clear(); e2y.clear(); e2z.clear();
+    ids.clear();
+}
+
+void TriangleBatch::Build(const EditableMesh& mesh, const uint32_t* order) {
+    count = mesh.triangleCount;
+    size_t padded = (size_t(count) + kPadding - 1) / kPadding * kPadding + kPadding;
+
+    // Padding slots are all-zero triangles: det == 0, so they never hit.
+    v0x.assign(padded, 0.0f); v0y.assign(padded, 0.0f); v0z.assign(padded, 0.0f);
+    e1x.assign(padded, 0.0f); e1y.assign(padded, 0.0f); e1z.assign(padded, 0.0f);
+    e2x.assign(padded, 0.0f); e2y.assign(padded, 0.0f); e2z.assign(padded, 0.0f);
+    ids.assign(padded, kInvalidTriangleID);
+
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        ids[slot] = order ? order[slot] : slot;
+        UpdateSlot(mesh, slot);
+    }
+}
+
+void TriangleBatch::UpdateSlot(const EditableMesh& mesh, uint32_t slot) {
+    if (slot >= count) { return; }
+
+    const EditTriangle& tri = mesh.triangles[ids[slot]];
+    const XMFLOAT3& a = mesh.positions[tri.a];
+    const XMFLOAT3& b = mesh.positions[tri.b];
+    const XMFLOAT3& c = mesh.positions[tri.c];
+
+    v0x[slot] = a.x; v0y[slot] = a.y; v0z[slot] = a.z;
+    e1x[slot] = b.x - a.x; e1y[slot] = b.y - a.y; e1z[slot] = b.z - a.z;
+    e2x[slot] = c.x - a.x; e2y[slot] = c.y - a.y; e2z[slot] = c.z - a.z;
+}
+
+void RayPacket::ResetHits() {
+    for (uint32_t i = 0; i < kMaxRays; ++i) {
+        bestT[i] = FLT_MAX;
+        bestSlot[i] = 0xFFFFFFFFu;
+    }
+}
+
+bool RayPacket::Add(const XMFLOAT3& origin, const XMFLOAT3& dir) {
+    if (count >= kMaxRays) { return false; }
+
+    origins[count] = origin;
+    dirs[count] = dir;
+    bestT[count] = FLT_MAX;
+    bestSlot[count] = 0xFFFFFFFFu;
+    count++;
+    return true;
+}
+
+namespace {
+
+#if AE_RAYTRI_LANES == 8
+
+struct Lanes {
+    using F = __m256;
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static F Set1(float f) { return _mm256_set1_ps(f); }
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F Lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static F Gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static F Or(F a, F b) { return _mm256_or_ps(a, b); }
+    static F AndNot(F a, F b) { return _mm256_andnot_ps(a, b); } // ~a & b
+    static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static F LaneIndex() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+    static uint32_t Mask(F a) { return (uint32_t)_mm256_movemask_ps(a); }
+    static void Store(float* p, F a) { _mm256_storeu_ps(p, a); }
+};
+
+#elif AE_RAYTRI_LANES == 4
+
+struct Lanes {
+    using F = __m128;
+    static F Load(const float* p) { return _mm_loadu_ps(p); }
+    static F Set1(float f) { return _mm_set1_ps(f); }
+    static F Add(F a, F b) { return _mm_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm_div_ps(a, b); }
+    static F Lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static F Gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+    static F Or(F a, F b) { return _mm_or_ps(a, b); }
+    static F AndNot(F a, F b) { return _mm_andnot_ps(a, b); } // ~a & b
+    static F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static F LaneIndex() { return _mm_setr_ps(0, 1, 2, 3); }
+    static uint32_t Mask(F a) { return (uint32_t)_mm_movemask_ps(a); }
+    static void Store(float* p, F a) { _mm_storeu_ps(p, a); }
+};
+
+#endif
+
+#if AE_RAYTRI_LANES > 1
+
+using F = Lanes::F;
+
+struct TriLanes {
+    F v0x, v0y, v0z, e1x, e1y, e1z, e2x, e2y, e2z;
+};
+
+struct RayLanes {
+    F ox, oy, oz, dx, dy, dz;
+};
+
+TriLanes LoadTriangles(const TriangleBatch& batch, uint32_t slot) {
+    TriLanes tri;
+    tri.v0x = Lanes::Load(&batch.v0x[slot]); tri.v0y = Lanes::Load(&batch.v0y[slot]); tri.v0z = Lanes::Load(&batch.v0z[slot]);
+    tri.e1x = Lanes::Load(&batch.e1x[slot]); tri.e1y = Lanes::Load(&batch.e1y[slot]); tri.e1z = Lanes::Load(&batch.e1z[slot]);
+    tri.e2x = Lanes::Load(&batch.e2x[slot]); tri.e2y = Lanes::Load(&batch.e2y[slot]); tri.e2z = Lanes::Load(&batch.e2z[slot]);
+    return tri;
+}
+
+RayLanes SplatRay(const XMFLOAT3& origin, const XMFLOAT3& dir) {
+    RayLanes ray;
+    ray.ox = Lanes::Set1(origin.x); ray.oy = Lanes::Set1(origin.y); ray.oz = Lanes::Set1(origin.z);
+    ray.dx = Lanes::Set1(dir.x); ray.dy = Lanes::Set1(dir.y); ray.dz = Lanes::Set1(dir.z);
+    return ray;
+}
+
+// Mirrors RayIntersectsTriangle op for op. Rejections are written as "not (reject test)" so
+// NaN lanes behave the same as the scalar early-outs. Returns a lane bit mask of hits closer than bestT.
+uint32_t TestLanes(const TriLanes& tri, const RayLanes& ray, F bestT, F laneValid, F& outT) {
+    const F zero = Lanes::Set1(0.0f);
+    const F one = Lanes::Set1(1.0f);
+
+    F px = Lanes::Sub(Lanes::Mul(ray.dy, tri.e2z), Lanes::Mul(ray.dz, tri.e2y));
+    F py = Lanes::Sub(Lanes::Mul(ray.dz, tri.e2x), Lanes::Mul(ray.dx, tri.e2z));
+    F pz = Lanes::Sub(Lanes::Mul(ray.dx, tri.e2y), Lanes::Mul(ray.dy, tri.e2x));
+
+    F det = Lanes::Add(Lanes::Add(Lanes::Mul(tri.e1x, px), Lanes::Mul(tri.e1y, py)), Lanes::Mul(tri.e1z, pz));
+    F reject = Lanes::Lt(Lanes::Abs(det), Lanes::Set1(kDetEpsilon));
+
+    F invDet = Lanes::Div(one, det);
+    F sx = Lanes::Sub(ray.ox, tri.v0x);
+    F sy = Lanes::Sub(ray.oy, tri.v0y);
+    F sz = Lanes::Sub(ray.oz, tri.v0z);
+
+    F u = Lanes::Mul(Lanes::Add(Lanes::Add(Lanes::Mul(sx, px), Lanes::Mul(sy, py)), Lanes::Mul(sz, pz)), invDet);
+    reject = Lanes::Or(reject, Lanes::Or(Lanes::Lt(u, zero), Lanes::Gt(u, one)));
+
+    F qx = Lanes::Sub(Lanes::Mul(sy, tri.e1z), Lanes::Mul(sz, tri.e1y));
+    F qy = Lanes::Sub(Lanes::Mul(sz, tri.e1x), Lanes::Mul(sx, tri.e1z));
+    F qz = Lanes::Sub(Lanes::Mul(sx, tri.e1y), Lanes::Mul(sy, tri.e1x));
+
+    F v = Lanes::Mul(Lanes::Add(Lanes::Add(Lanes::Mul(ray.dx, qx), Lanes::Mul(ray.dy, qy)), Lanes::Mul(ray.dz, qz)), invDet);
+    reject = Lanes::Or(reject, Lanes::Or(Lanes::Lt(v, zero), Lanes::Gt(Lanes::Add(u, v), one)));
+
+    F t = Lanes::Mul(Lanes::Add(Lanes::Add(Lanes::Mul(tri.e2x, qx), Lanes::Mul(tri.e2y, qy)), Lanes::Mul(tri.e2z, qz)), invDet);
+    reject = Lanes::Or(reject, Lanes::Lt(t, zero));
+
+    outT = t;
+    F closer = Lanes::Lt(t, bestT);
+    return Lanes::Mask(Lanes::AndNot(reject, closer)) & Lanes::Mask(laneValid);
+}
+
+// Sequential "strict less" over the hit lanes, so ties resolve to the lowest slot like the scalar loop.
+bool TakeClosest(uint32_t mask, F tLanes, uint32_t slot, float& bestT, uint32_t& bestSlot) {
+    if (!mask) { return false; }
+
+    float t[AE_RAYTRI_LANES];
+    Lanes::Store(t, tLanes);
+
+    bool improved = false;
+    for (uint32_t lane = 0; lane < AE_RAYTRI_LANES; ++lane) {
+        if ((mask & (1u << lane)) && t[lane] < bestT) {
+            bestT = t[lane];
+            bestSlot = slot + lane;
+            improved = true;
+        }
+    }
+    return improved;
+}
+
+#else
+
+bool IntersectSlotScalar(const TriangleBatch& batch, uint32_t slot, const XMFLOAT3& rayOrigin, const XMFLOAT3& rayDir, float& bestT, uint32_t& bestSlot) {
+    XMFLOAT3 a(batch.v0x[slot], batch.v0y[slot], batch.v0z[slot]);
+    XMFLOAT3 e1(batch.e1x[slot], batch.e1y[slot], batch.e1z[slot]);
+    XMFLOAT3 e2(batch.e2x[slot], batch.e2y[slot], batch.e2z[slot]);
+
+    float t = 0.0f;
+    if (!IntersectEdges(rayOrigin, rayDir, a, e1, e2, t) || !(t < bestT)) { return false; }
+
+    bestT = t;
+    bestSlot = slot;
+    return true;
+}
+
+#endif
+
+} // namespace
+
+bool IntersectRayBatch(const TriangleBatch& batch, uint32_t first, uint32_t slotCount, const XMFLOAT3& rayOrigin, const XMFLOAT3& rayDir, float& bestT, uint32_t& bestSlot) {
+    if (first >= batch.count) { return false; }
+    if (slotCount > batch.count - first) { slotCount = batch.count - first; }
+
+    bool improved = false;
+
+#if AE_RAYTRI_LANES > 1
+    RayLanes ray = SplatRay(rayOrigin, rayDir);
+    const F laneIndex = Lanes::LaneIndex();
+
+    // The padding past count keeps full loads inside the arrays; lanes past the range are masked off.
+    for (uint32_t slot = first; slot < first + slotCount; slot += AE_RAYTRI_LANES) {
+        F laneValid = Lanes::Lt(laneIndex, Lanes::Set1(float(first + slotCount - slot)));
+        F t;
+        uint32_t mask = TestLanes(LoadTriangles(batch, slot), ray, Lanes::Set1(bestT), laneValid, t);
+        improved |= TakeClosest(mask, t, slot, bestT, bestSlot);
+    }
+#else
+    for (uint32_t slot = first; slot < first + slotCount; ++slot) {
+        improved |= IntersectSlotScalar(batch, slot, rayOrigin, rayDir, bestT, bestSlot);
+    }
+#endif
+
+    return improved;
+}
+
+bool IntersectPacketBatch(const TriangleBatch& batch, uint32_t first, uint32_t slotCount, RayPacket& packet) {
+    if (first >= batch.count) { return false; }
+    if (slotCount > batch.count - first) { slotCount = batch.count - first; }
+
+    bool improved = false;
+
+#if AE_RAYTRI_LANES > 1
+    RayLanes rays[RayPacket::kMaxRays];
+    for (uint32_t r = 0; r < packet.count; ++r) { rays[r] = SplatRay(packet.origins[r], packet.dirs[r]); }
+
+    const F laneIndex = Lanes::LaneIndex();
+
+    for (uint32_t slot = first; slot < first + slotCount; slot += AE_RAYTRI_LANES) {
+        F laneValid = Lanes::Lt(laneIndex, Lanes::Set1(float(first + slotCount - slot)));
+        TriLanes tri = LoadTriangles(batch, slot);
+
+        for (uint32_t r = 0; r < packet.count; ++r) {
+            F t;
+            uint32_t mask = TestLanes(tri, rays[r], Lanes::Set1(packet.bestT[r]), laneValid, t);
+            improved |= TakeClosest(mask, t, slot, packet.bestT[r], packet.bestSlot[r]);
+        }
+    }
+#else
+    for (uint32_t slot = first; slot < first + slotCount; ++slot) {
+        for (uint32_t r = 0; r < packet.count; ++r) {
+            improved |= IntersectSlotScalar(batch, slot, packet.origins[r], packet.dirs[r], packet.bestT[r], packet.bestSlot[r]);
+        }
+    }
+#endif
+
+    return improved;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include "EditableMesh.h"
+
+// Batched Moller-Trumbore: one ray against several triangles per instruction.
+// Width is picked at compile time: 8 lanes with AVX2 (/arch:AVX2), 4 with SSE2 (always on x64),
+// otherwise a scalar loop. All paths do the same float ops in the same order as
+// RayIntersectsTriangle, so results (hit triangle and t) match the scalar test exactly.
+#if defined(__AVX2__)
+#define AE_RAYTRI_LANES 8
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define AE_RAYTRI_LANES 4
+#else
+#define AE_RAYTRI_LANES 1
+#endif
+
+// Scalar reference. Two-sided (the editor draws with culling off).
+// outT is in units of rayDir, so it is only comparable between hits of the same ray.
+bool RayIntersectsTriangle(const DirectX::XMFLOAT3& rayOrigin, const DirectX::XMFLOAT3& rayDir, const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c, float& outT);
+
+// Structure-of-arrays copy of triangles: first vertex plus the two edges, one array per component.
+// Slots are padded with degenerate triangles to a multiple of 8 plus 8 more, so a full-lane load at any
+// slot below count stays inside the arrays (leaf ranges start anywhere, not only on a lane boundary).
+struct TriangleBatch {
+    static constexpr uint32_t kPadding = 8;
+
+    uint32_t count = 0;
+
+    std::vector<float> v0x, v0y, v0z;
+    std::vector<float> e1x, e1y, e1z;
+    std::vector<float> e2x, e2y, e2z;
+    std::vector<TriangleID> ids; // slot -> mesh triangle
+
+    void Clear();
+
+    // order == nullptr keeps mesh order; otherwise slot i holds triangle order[i] (e.g. BVH leaf order).
+    void Build(const EditableMesh& mesh, const uint32_t* order = nullptr);
+
+    // Re-reads one slot from the mesh after its vertices moved.
+    void UpdateSlot(const EditableMesh& mesh, uint32_t slot);
+};
+
+// Closest hit among slots [first, first + slotCount). bestT is in/out: only hits closer than the
+// incoming value are taken, so it can be chained across leaves. Returns true if bestT improved.
+bool IntersectRayBatch(const TriangleBatch& batch, uint32_t first, uint32_t slotCount,
+    const DirectX::XMFLOAT3& rayOrigin, const DirectX::XMFLOAT3& rayDir, float& bestT, uint32_t& bestSlot);
+
+// A small bundle of rays tested together: each triangle block is loaded once and reused for every
+// ray, which is what multi-sample and marquee picks want (rays are close, so they visit the same leaves).
+struct RayPacket {
+    static constexpr uint32_t kMaxRays = 16;
+
+    uint32_t count = 0;
+    DirectX::XMFLOAT3 origins[kMaxRays];
+    DirectX::XMFLOAT3 dirs[kMaxRays];
+
+    float bestT[kMaxRays];
+    uint32_t bestSlot[kMaxRays];
+
+    // Resets every ray to "no hit yet".
+    void ResetHits();
+    bool Add(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir);
+};
+
+// Same as IntersectRayBatch for every ray in the packet. Returns true if any ray improved.
+bool IntersectPacketBatch(const TriangleBatch& batch, uint32_t first, uint32_t slotCount, RayPacket& packet);
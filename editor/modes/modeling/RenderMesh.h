@@ -2,25 +2,58 @@
 
 #include <DirectXMath.h>
 #include <cstdint>
+#include <vector>
 #include "EditableMesh.h"
 
-// Matches the existing vertex layout used by CreateVertexBuffer/Draw.
+// Matches the input layout of the mesh/grid/gizmo PSOs in EditorMain.
 struct Vertex {
     DirectX::XMFLOAT3 position;
     DirectX::XMFLOAT4 color;
 };
 
+enum class RenderMeshMode {
+    // 3 draw vertices per triangle, face color baked into every vertex.
+    Expanded = 0,
+    // 1 draw vertex per EditableMesh vertex plus an index buffer. Face colors come from
+    // SV_PrimitiveID in the pixel shader (same palette as FaceColor), so vertices stay shared.
+    // Vertex color is an overlay: rgb is blended over the face color by alpha (0 = face color).
+    Indexed
+};
+
 struct RenderMesh {
-    static constexpr uint32_t kMaxDrawVertexCount = EditableMesh::kMaxTriangles * 3;
+    // 16-bit indices are used while every draw vertex fits; larger meshes switch to 32-bit.
+    static constexpr uint32_t kMax16BitVertexCount = 0xFFFFu;
 
+    RenderMeshMode mode = RenderMeshMode::Indexed;
+
+    // dirty = something needs uploading. allDirty forces a full vertex upload; otherwise only the
+    // draw vertices in dirtyDrawVertices are refreshed and copied (see Engine::UpdateVertexBuffer).
+    // The consumer (Engine) clears these after uploading, RenderMesh never does.
     bool dirty = true;
+    bool allDirty = true;
+    bool indicesDirty = true;
     uint32_t drawVertexCount = 0;
+    uint32_t indexCount = 0;
+
+    // Each draw vertex references an EditableMesh vertex index.
+    // drawToTriangle is only filled in Expanded mode (Indexed draw vertices are shared by several triangles).
+    std::vector<uint32_t> drawToEdit;
+    std::vector<uint32_t> drawToTriangle;
 
-    // Each draw vertex references an EditableMesh vertex index and triangle index.
-    uint32_t drawToEdit[kMaxDrawVertexCount] = {};
-    uint32_t drawToTriangle[kMaxDrawVertexCount] = {};
+    // Reverse of drawToEdit in CSR form: the draw vertices of edit vertex v are
+    // editToDrawList[editToDrawOffsets[v] .. editToDrawOffsets[v + 1]).
+    std::vector<uint32_t> editToDrawOffsets;
+    std::vector<uint32_t> editToDrawList;
 
-    Vertex drawVertices[kMaxDrawVertexCount] = {};
+    std::vector<Vertex> drawVertices;
+
+    // One bit per draw vertex so a vertex is queued at most once per upload.
+    std::vector<uint64_t> dirtyBits;
+    std::vector<uint32_t> dirtyDrawVertices;
+
+    // Indexed mode only. Exactly one of these is filled, see Uses32BitIndices().
+    std::vector<uint16_t> indices16;
+    std::vector<uint32_t> indices32;
 
     static DirectX::XMFLOAT4 FaceColor(uint32_t face) {
         switch (face % 4) {
@@ -31,22 +64,140 @@ struct RenderMesh {
         }
     }
 
+    static DirectX::XMFLOAT4 HighlightColor() { return DirectX::XMFLOAT4(1, 1, 1, 1); }
+
+    bool IsIndexed() const { return mode == RenderMeshMode::Indexed; }
+    bool Uses32BitIndices() const { return drawVertexCount > kMax16BitVertexCount; }
+    uint32_t IndexStride() const { return Uses32BitIndices() ? 4u : 2u; }
+    const void* IndexData() const { return Uses32BitIndices() ? (const void*)indices32.data() : (const void*)indices16.data(); }
+
+    // Bytes a full upload of this mesh writes to the GPU (vertices + indices).
+    size_t UploadBytes() const {
+        size_t bytes = sizeof(Vertex) * size_t(drawVertexCount);
+        if (IsIndexed()) { bytes += size_t(IndexStride()) * indexCount; }
+        return bytes;
+    }
+
+    // CPU heap bytes held by the draw data (capacity, like EditableMesh::MemoryBytes).
+    size_t MemoryBytes() const {
+        return (drawToEdit.capacity() + drawToTriangle.capacity() + editToDrawOffsets.capacity() + editToDrawList.capacity() + dirtyDrawVertices.capacity() + indices32.capacity()) * sizeof(uint32_t) +
+            drawVertices.capacity() * sizeof(Vertex) + dirtyBits.capacity() * sizeof(uint64_t) + indices16.capacity() * sizeof(uint16_t);
+    }
+
+    void MarkAllDirty() {
+        dirty = true;
+        allDirty = true;
+    }
+
+    void MarkDrawVertexDirty(uint32_t draw) {
+        if (draw >= drawVertexCount) { return; }
+
+        dirty = true;
+        if (allDirty) { return; }
+
+        uint64_t bit = 1ull << (draw & 63u);
+        uint64_t& word = dirtyBits[draw >> 6];
+        if (word & bit) { return; }
+        word |= bit;
+        dirtyDrawVertices.push_back(draw);
+
+        // Past a quarter of the mesh one contiguous copy is cheaper than many small ones.
+        if (dirtyDrawVertices.size() > drawVertexCount / 4 + 64) { allDirty = true; }
+    }
+
+    // Marks every draw vertex that references EditableMesh vertex v (position or color changed).
+    void MarkEditVertexDirty(VertexID v) {
+        if (v + 1 >= (uint32_t)editToDrawOffsets.size()) { return; }
+
+        for (uint32_t i = editToDrawOffsets[v]; i < editToDrawOffsets[v + 1]; ++i) {
+            MarkDrawVertexDirty(editToDrawList[i]);
+        }
+    }
+
+    // Color a draw vertex has when nothing is highlighted.
+    DirectX::XMFLOAT4 BaseColor(uint32_t draw) const {
+        if (IsIndexed()) { return DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f); }
+        return FaceColor(drawToTriangle[draw]);
+    }
+
+    // Highlights (or restores) the draw vertices of one edit vertex. Touches only those entries.
+    void SetVertexHighlight(VertexID v, bool highlighted) {
+        if (v + 1 >= (uint32_t)editToDrawOffsets.size()) { return; }
+
+        for (uint32_t i = editToDrawOffsets[v]; i < editToDrawOffsets[v + 1]; ++i) {
+            uint32_t draw = editToDrawList[i];
+            drawVertices[draw].color = highlighted ? HighlightColor() : BaseColor(draw);
+            MarkDrawVertexDirty(draw);
+        }
+    }
+
+    void ClearDirty() {
+        for (uint32_t draw : dirtyDrawVertices) { dirtyBits[draw >> 6] = 0; }
+        if (allDirty) { dirtyBits.assign(dirtyBits.size(), 0); }
+
+        dirtyDrawVertices.clear();
+        dirty = false;
+        allDirty = false;
+    }
+
     void Clear() {
         dirty = true;
+        allDirty = true;
+        indicesDirty = true;
         drawVertexCount = 0;
+        indexCount = 0;
 
-        for (uint32_t i = 0; i < kMaxDrawVertexCount; ++i) {
-            drawToEdit[i] = 0;
-            drawToTriangle[i] = 0;
-            drawVertices[i] = Vertex{};
-        }
+        drawToEdit.clear();
+        drawToTriangle.clear();
+        drawVertices.clear();
+        indices16.clear();
+        indices32.clear();
+        dirtyBits.clear();
+        dirtyDrawVertices.clear();
+        editToDrawOffsets.clear();
+        editToDrawList.clear();
     }
 
     bool BuildFromEditable(const EditableMesh& mesh) {
         Clear();
 
-        uint32_t needed = mesh.triangleCount * 3;
-        if (needed > kMaxDrawVertexCount) { return false; }
+        bool ok = (mode == RenderMeshMode::Indexed) ? BuildIndexed(mesh) : BuildExpanded(mesh);
+        if (!ok) { return false; }
+
+        BuildEditToDraw(mesh.vertexCount);
+        dirtyBits.assign((drawVertexCount + 63) / 64, 0);
+        return true;
+    }
+
+private:
+    // Counting sort of drawToEdit into the CSR reverse map. O(vertices + draw vertices).
+    void BuildEditToDraw(uint32_t editVertexCount) {
+        editToDrawOffsets.assign(size_t(editVertexCount) + 1, 0);
+        editToDrawList.resize(drawVertexCount);
+
+        for (uint32_t draw = 0; draw < drawVertexCount; ++draw) {
+            uint32_t v = drawToEdit[draw];
+            if (v < editVertexCount) { editToDrawOffsets[v + 1]++; }
+        }
+
+        for (uint32_t v = 0; v < editVertexCount; ++v) {
+            editToDrawOffsets[v + 1] += editToDrawOffsets[v];
+        }
+
+        std::vector<uint32_t> cursor(editToDrawOffsets.begin(), editToDrawOffsets.end() - 1);
+        for (uint32_t draw = 0; draw < drawVertexCount; ++draw) {
+            uint32_t v = drawToEdit[draw];
+            if (v < editVertexCount) { editToDrawList[cursor[v]++] = draw; }
+        }
+    }
+
+    bool BuildExpanded(const EditableMesh& mesh) {
+        uint64_t needed = uint64_t(mesh.triangleCount) * 3;
+        if (needed > 0xFFFFFFFFull) { return false; }
+
+        drawToEdit.resize(size_t(needed));
+        drawToTriangle.resize(size_t(needed));
+        drawVertices.resize(size_t(needed));
 
         for (uint32_t face = 0; face < mesh.triangleCount; ++face) {
             DirectX::XMFLOAT4 color = FaceColor(face);
@@ -62,8 +213,46 @@ struct RenderMesh {
             }
         }
 
-        drawVertexCount = needed;
+        drawVertexCount = uint32_t(needed);
         dirty = true;
         return true;
     }
-};
\ No newline at end of file
+
+    bool BuildIndexed(const EditableMesh& mesh) {
+        uint64_t needed = uint64_t(mesh.triangleCount) * 3;
+        if (needed > 0xFFFFFFFFull) { return false; }
+
+        drawVertexCount = mesh.vertexCount;
+        drawToEdit.resize(mesh.vertexCount);
+        drawVertices.resize(mesh.vertexCount);
+
+        for (uint32_t v = 0; v < mesh.vertexCount; ++v) {
+            drawToEdit[v] = v;
+            drawVertices[v].position = mesh.positions[v];
+            drawVertices[v].color = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        indexCount = uint32_t(needed);
+        if (Uses32BitIndices()) {
+            indices32.resize(indexCount);
+            for (uint32_t face = 0; face < mesh.triangleCount; ++face) {
+                const EditTriangle& tri = mesh.triangles[face];
+                indices32[face * 3 + 0] = tri.a;
+                indices32[face * 3 + 1] = tri.b;
+                indices32[face * 3 + 2] = tri.c;
+            }
+        } else {
+            indices16.resize(indexCount);
+            for (uint32_t face = 0; face < mesh.triangleCount; ++face) {
+                const EditTriangle& tri = mesh.triangles[face];
+                indices16[face * 3 + 0] = (uint16_t)tri.a;
+                indices16[face * 3 + 1] = (uint16_t)tri.b;
+                indices16[face * 3 + 2] = (uint16_t)tri.c;
+            }
+        }
+
+        dirty = true;
+        indicesDirty = true;
+        return true;
+    }
+};
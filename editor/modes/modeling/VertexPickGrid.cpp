@@ -0,0 +1,141 @@
+#include "editor/modes/modeling/VertexPickGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+bool VertexPickGrid::Update(const EditableMesh& mesh, const XMFLOAT4X4& world, const XMFLOAT4X4& viewProj, float width, float height, float pickRadiusPx) {
+    bool same = m_valid &&
+        m_mesh == &mesh &&
+        m_meshVersion == mesh.version &&
+        m_width == width &&
+        m_height == height &&
+        m_cellSize == pickRadiusPx &&
+        std::memcmp(&m_world, &world, sizeof(world)) == 0 &&
+        std::memcmp(&m_viewProj, &viewProj, sizeof(viewProj)) == 0;
+    if (same) { return false; }
+
+    m_mesh = &mesh;
+    m_meshVersion = mesh.version;
+    m_world = world;
+    m_viewProj = viewProj;
+    m_width = width;
+    m_height = height;
+    m_cellSize = pickRadiusPx;
+
+    Rebuild(mesh);
+    return true;
+}
+
+bool VertexPickGrid::CellOf(float x, float y, int& cx, int& cy) const {
+    // Stay in float until the range check: points near the camera plane can project to huge values.
+    if (!(x == x) || !(y == y)) { cx = -2; cy = -2; return false; } //NaN
+    float fx = std::floor(x / m_cellSize) + 1.0f;
+    float fy = std::floor(y / m_cellSize) + 1.0f;
+    cx = int((std::min)((std::max)(fx, -2.0f), float(m_cellsX) + 1.0f));
+    cy = int((std::min)((std::max)(fy, -2.0f), float(m_cellsY) + 1.0f));
+    return fx >= 0.0f && fy >= 0.0f && fx < float(m_cellsX) && fy < float(m_cellsY);
+}
+
+void VertexPickGrid::Rebuild(const EditableMesh& mesh) {
+    m_valid = false;
+    m_entries.clear();
+    m_cellOffsets.clear();
+    m_cellsX = 0;
+    m_cellsY = 0;
+    m_rebuildCount++;
+
+    if (m_width <= 0.0f || m_height <= 0.0f || m_cellSize <= 0.0f) { return; }
+
+    m_cellsX = uint32_t(std::ceil(m_width / m_cellSize)) + 2;
+    m_cellsY = uint32_t(std::ceil(m_height / m_cellSize)) + 2;
+
+    // One matrix for the whole mesh; row-vector convention like XMVector4Transform.
+    XMFLOAT4X4 mvp;
+    XMStoreFloat4x4(&mvp, XMMatrixMultiply(XMLoadFloat4x4(&m_world), XMLoadFloat4x4(&m_viewProj)));
+
+    std::vector<Projected> projected;
+    std::vector<uint32_t> cellOf;
+    projected.reserve(mesh.vertexCount);
+    cellOf.reserve(mesh.vertexCount);
+
+    for (uint32_t i = 0; i < mesh.vertexCount; ++i) {
+        const XMFLOAT3& p = mesh.positions[i];
+
+        float cx = p.x * mvp.m[0][0] + p.y * mvp.m[1][0] + p.z * mvp.m[2][0] + mvp.m[3][0];
+        float cy = p.x * mvp.m[0][1] + p.y * mvp.m[1][1] + p.z * mvp.m[2][1] + mvp.m[3][1];
+        float cz = p.x * mvp.m[0][2] + p.y * mvp.m[1][2] + p.z * mvp.m[2][2] + mvp.m[3][2];
+        float cw = p.x * mvp.m[0][3] + p.y * mvp.m[1][3] + p.z * mvp.m[2][3] + mvp.m[3][3];
+
+        if (cw < 1e-6f) continue; //behind the camera (same rule as App::WorldToScreen)
+
+        Projected entry;
+        entry.x = (cx / cw * 0.5f + 0.5f) * m_width;
+        entry.y = (-cy / cw * 0.5f + 0.5f) * m_height;
+        entry.depth = cz / cw;
+        entry.vertex = i;
+
+        int gx = 0;
+        int gy = 0;
+        if (!CellOf(entry.x, entry.y, gx, gy)) continue; //too far off screen to ever be under the cursor
+
+        projected.push_back(entry);
+        cellOf.push_back(uint32_t(gy) * m_cellsX + uint32_t(gx));
+    }
+
+    // Counting sort into CSR so each cell's entries are contiguous.
+    uint32_t cellCount = m_cellsX * m_cellsY;
+    m_cellOffsets.assign(size_t(cellCount) + 1, 0);
+    for (uint32_t cell : cellOf) { m_cellOffsets[cell + 1]++; }
+    for (uint32_t c = 0; c < cellCount; ++c) { m_cellOffsets[c + 1] += m_cellOffsets[c]; }
+
+    m_entries.resize(projected.size());
+    std::vector<uint32_t> cursor(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+    for (size_t i = 0; i < projected.size(); ++i) {
+        m_entries[cursor[cellOf[i]]++] = projected[i];
+    }
+
+    m_valid = true;
+}
+
+int VertexPickGrid::Pick(float x, float y) const {
+    if (!m_valid) return -1;
+
+    const float radiusSq = m_cellSize * m_cellSize;
+    const float tieEpsilonSq = 1e-4f;
+
+    int cx = 0;
+    int cy = 0;
+    CellOf(x, y, cx, cy);
+
+    float bestDistSq = 1.0e30f;
+    float bestDepth = 1.0e30f;
+    int bestVertex = -1;
+
+    // Cells are pickRadius wide, so the 3x3 block around the cursor covers the whole pick circle.
+    for (int gy = (std::max)(cy - 1, 0); gy <= (std::min)(cy + 1, int(m_cellsY) - 1); ++gy) {
+        for (int gx = (std::max)(cx - 1, 0); gx <= (std::min)(cx + 1, int(m_cellsX) - 1); ++gx) {
+            uint32_t cell = uint32_t(gy) * m_cellsX + uint32_t(gx);
+
+            for (uint32_t i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i) {
+                const Projected& e = m_entries[i];
+                float dx = e.x - x;
+                float dy = e.y - y;
+                float distSq = dx * dx + dy * dy;
+                if (distSq > radiusSq) continue;
+
+                bool closer = distSq < bestDistSq - tieEpsilonSq;
+                bool tie = !closer && distSq <= bestDistSq + tieEpsilonSq;
+                if (closer || (tie && (e.depth < bestDepth || (e.depth == bestDepth && int(e.vertex) < bestVertex)))) {
+                    bestDistSq = distSq;
+                    bestDepth = e.depth;
+                    bestVertex = int(e.vertex);
+                }
+            }
+        }
+    }
+
+    return bestVertex;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include "EditableMesh.h"
+
+// Screen-space uniform grid over one mesh's projected vertices, for vertex picking.
+// Every vertex is projected once per (mesh edit, object transform, camera, viewport) change and
+// bucketed into square cells of pickRadius pixels, so a pick only scans the 3x3 cells around the
+// cursor. Nothing here touches the window: the caller passes the viewport size.
+class VertexPickGrid {
+public:
+    // Re-projects only when one of the inputs differs from the last call. Returns true if it rebuilt.
+    bool Update(const EditableMesh& mesh, const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4X4& viewProj, float width, float height, float pickRadiusPx);
+
+    // Closest vertex within the pick radius of (x, y), or -1. Screen distance wins; vertices at the
+    // same distance (stacked on screen) resolve to the one nearest the camera.
+    int Pick(float x, float y) const;
+
+    void Invalidate() { m_valid = false; }
+
+    uint32_t RebuildCount() const { return m_rebuildCount; }
+    uint32_t CellCount() const { return m_cellsX * m_cellsY; }
+
+private:
+    struct Projected {
+        float x;
+        float y;
+        float depth; // clip z / w
+        VertexID vertex;
+    };
+
+    bool m_valid = false;
+    const EditableMesh* m_mesh = nullptr;
+    uint64_t m_meshVersion = 0;
+    DirectX::XMFLOAT4X4 m_world = {};
+    DirectX::XMFLOAT4X4 m_viewProj = {};
+    float m_width = 0.0f;
+    float m_height = 0.0f;
+    float m_cellSize = 0.0f;
+
+    // The grid starts one cell left/above the viewport so vertices just off screen stay pickable.
+    uint32_t m_cellsX = 0;
+    uint32_t m_cellsY = 0;
+    std::vector<uint32_t> m_cellOffsets; // CSR: cell c owns m_entries[m_cellOffsets[c] .. m_cellOffsets[c + 1])
+    std::vector<Projected> m_entries;
+    uint32_t m_rebuildCount = 0;
+
+    void Rebuild(const EditableMesh& mesh);
+    bool CellOf(float x, float y, int& cx, int& cy) const;
+};
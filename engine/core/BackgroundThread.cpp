@@ -0,0 +1,40 @@
+#include "engine/core/BackgroundThread.h"
+#include "engine/core/Profiler.h"
+
+void BackgroundThread::Post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+        if (!m_thread.joinable()) {
+            m_stopping = false;
+            m_thread = std::thread(&BackgroundThread::ThreadMain, this);
+        }
+    }
+    m_wake.notify_one();
+}
+
+void BackgroundThread::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_thread.joinable()) { return; }
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void BackgroundThread::ThreadMain() {
+    Profiler::Get().SetThreadName(m_name);
+
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return !m_tasks.empty() || m_stopping; });
+            if (m_tasks.empty()) { return; }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
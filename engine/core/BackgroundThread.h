@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// One long-lived thread that runs posted tasks in order, for work that spans many frames (file
+// reads, decoding). Such work does not go to the JobSystem: a job that long could be picked up by
+// the main thread while it waits on other jobs, and stall a frame.
+// The thread starts on the first Post. Tasks cannot be cancelled from here; a task that should stop
+// early checks a flag of its own. No platform headers; usable from tools and headless code.
+class BackgroundThread {
+public:
+    // name is what the profiler calls the thread (kept, not copied).
+    explicit BackgroundThread(const char* name) : m_name(name) {}
+    ~BackgroundThread() { Stop(); }
+
+    BackgroundThread(const BackgroundThread&) = delete;
+    BackgroundThread& operator=(const BackgroundThread&) = delete;
+
+    void Post(std::function<void()> task);
+    // Runs the tasks already posted, then joins. Post starts the thread again.
+    void Stop();
+
+private:
+    const char* m_name;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+
+    void ThreadMain();
+};
@@ -1,62 +1,291 @@
 #include "engine/core/Engine.h"
+#include "engine/core/Profiler.h"
 #include "engine/gfx/GraphicsDevice.h"
+#include "engine/gfx/GpuQueue.h"
 #include "editor/modes/modeling/RenderMesh.h"
 #include "editor/modes/modeling/EditableMesh.h"
 #include <DirectXMath.h>
+#include <algorithm>
 #include "third_party/imgui/imgui.h"
 #include "third_party/imgui/imgui_impl_dx12.h"
 
-void Engine::SetRenderObjects(ID3D12CommandAllocator* commandAllocator, ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* rootSignature, ID3D12PipelineState* pipelineStateTriangles, ID3D12PipelineState* pipelineStateLines, ID3D12PipelineState* pipelineStateLinesOccluded, ID3D12PipelineState* pipelineStateGizmo, ID3D12PipelineState* pipelineStateGizmoOccluded, ID3D12Fence* fence, HANDLE fenceEvent, UINT64* fenceValue, ID3D12Resource* vertexBufferTetra, ID3D12Resource* vertexBufferGrid, uint32_t gridVertexCount, uint32_t width, uint32_t height) {
-    m_commandAllocator = commandAllocator;
-    m_commandList = commandList;
+bool Engine::InitializeFrames(IGpuQueue* queue, uint32_t frameCount) {
+    if (!m_gfx || !m_gfx->Device() || !queue) { return false; }
+
+    m_framesInFlight.Initialize(queue, frameCount);
+    for (uint32_t i = 0; i < m_framesInFlight.FrameCount(); ++i) {
+        HRESULT hr = m_gfx->Device()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_frames[i].commandAllocator));
+        if (FAILED(hr)) { return false; }
+    }
+
+    HRESULT hr = m_gfx->Device()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_frames[0].commandAllocator.Get(), nullptr, IID_PPV_ARGS(&m_commandList));
+    if (FAILED(hr)) { return false; }
+    m_commandList->Close();
+
+    return CreateUploadRing(kInitialUploadRingBytes);
+}
+
+void Engine::SetRenderObjects(ID3D12RootSignature* rootSignature, ID3D12PipelineState* pipelineStateTriangles, ID3D12PipelineState* pipelineStateLines, ID3D12PipelineState* pipelineStateLinesOccluded, ID3D12PipelineState* pipelineStateGizmo, ID3D12PipelineState* pipelineStateGizmoOccluded, ID3D12Resource* vertexBufferGrid, uint32_t gridVertexCount, uint32_t width, uint32_t height) {
     m_rootSignature = rootSignature;
     m_pipelineStateTriangles = pipelineStateTriangles;
     m_pipelineStateLines = pipelineStateLines;
     m_pipelineStateLinesOccluded = pipelineStateLinesOccluded;
     m_pipelineStateGizmo = pipelineStateGizmo;
     m_pipelineStateGizmoOccluded = pipelineStateGizmoOccluded;
-    m_fence = fence;
-    m_fenceEvent = fenceEvent;
-    m_fenceValue = fenceValue;
-    m_vertexBufferTetra = vertexBufferTetra;
     m_vertexBufferGrid = vertexBufferGrid;
     m_gridVertexCount = gridVertexCount;
-    m_gizmoVertexCount = 18;
-    m_gridBaseVertexCount = (gridVertexCount >= m_gizmoVertexCount) ? (gridVertexCount - m_gizmoVertexCount) : gridVertexCount;
     m_width = width;
     m_height = height;
 }
 
-void Engine::UpdateVertexBuffer(const EditableMesh* editMesh, RenderMesh* renderMesh, HWND hwnd) {
-    if (!m_vertexBufferTetra || !editMesh || !renderMesh) { return; }
+// One upload-heap buffer, mapped once for its lifetime (upload heaps may stay mapped while the GPU reads them).
+bool Engine::CreateUploadRing(uint64_t capacityBytes) {
+    if (!m_gfx || !m_gfx->Device()) { return false; }
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+    CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(capacityBytes);
+    HRESULT hr = m_gfx->Device()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&buffer));
+    if (FAILED(hr) || !buffer) { return false; }
+
+    UINT8* pData = nullptr;
+    D3D12_RANGE readRange = { 0, 0 };
+    hr = buffer->Map(0, &readRange, reinterpret_cast<void**>(&pData));
+    if (FAILED(hr) || !pData) {
+        wchar_t buf[256];
+        swprintf_s(buf, L"Upload ring Map failed. hr=0x%08X", (unsigned)hr);
+        MessageBox(m_hwnd.load(std::memory_order_relaxed), buf, L"Error", MB_OK);
+        return false;
+    }
+
+    // The old ring may still be read by this frame's copies and by frames in flight.
+    if (m_uploadRingBuffer) { m_frames[m_framesInFlight.CurrentSlot()].retired.push_back(m_uploadRingBuffer); }
+    m_uploadRingBuffer = buffer;
+    m_uploadRing.Initialize(pData, capacityBytes);
+    return true;
+}
+
+bool Engine::AllocateTransient(uint64_t size, uint64_t alignment, TransientAllocation& out) {
+    UploadAllocation allocation = m_uploadRing.Allocate(size, alignment);
+    if (!allocation.Valid()) {
+        // Frames in flight still hold the rest of the ring. Once the GPU has caught up only this
+        // frame's allocations remain; if even that is too full, this frame needs a bigger ring.
+        if (IGpuQueue* queue = m_framesInFlight.Queue()) {
+            WaitForGpu();
+            m_uploadRing.Reclaim(queue->CompletedValue());
+        }
+        allocation = m_uploadRing.Allocate(size, alignment);
+    }
+    if (!allocation.Valid()) {
+        uint64_t capacity = (std::max)(m_uploadRing.Capacity() * 2, size + alignment);
+        if (!CreateUploadRing(capacity)) { return false; }
+        m_uploadRingGrowCount++;
+        allocation = m_uploadRing.Allocate(size, alignment);
+        if (!allocation.Valid()) { return false; }
+    }
+
+    out.cpu = allocation.cpu;
+    out.buffer = m_uploadRingBuffer.Get();
+    out.offset = allocation.offset;
+    out.gpuAddress = m_uploadRingBuffer->GetGPUVirtualAddress() + allocation.offset;
+    return true;
+}
+
+// Mesh buffers live in the default heap (COMMON, promoted by the first copy or draw of each command list).
+bool Engine::EnsureMeshBuffer(Microsoft::WRL::ComPtr<ID3D12Resource>& buffer, uint64_t& capacityBytes, uint64_t neededBytes) {
+    if (buffer && capacityBytes >= neededBytes) { return true; }
+    if (!m_gfx || !m_gfx->Device()) { return false; }
+
+    // Grow geometrically so a mesh that keeps growing does not recreate the buffer every edit.
+    uint64_t newCapacity = (capacityBytes > 0) ? capacityBytes : 4096;
+    while (newCapacity < neededBytes) { newCapacity *= 2; }
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> newBuffer;
+    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_DEFAULT);
+    CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(newCapacity);
+    HRESULT hr = m_gfx->Device()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&newBuffer));
+    if (FAILED(hr) || !newBuffer) { return false; }
+
+    // Growing always comes with a full upload, so nothing needs to be carried over. Frames in flight
+    // may still draw from the old buffer.
+    if (buffer) { m_frames[m_framesInFlight.CurrentSlot()].retired.push_back(buffer); }
+    buffer = newBuffer;
+    capacityBytes = newCapacity;
+    return true;
+}
+
+// Copies this frame's instances into the upload ring and returns their GPU address.
+bool Engine::UploadInstances(D3D12_GPU_VIRTUAL_ADDRESS& instances) {
+    uint64_t bytes = sizeof(InstanceData) * uint64_t(m_drawList.instances.size());
+    if (bytes == 0) { return true; }
+
+    TransientAllocation allocation;
+    if (!AllocateTransient(bytes, 256, allocation)) { return false; }
+
+    memcpy(allocation.cpu, m_drawList.instances.data(), size_t(bytes));
+    instances = allocation.gpuAddress;
+    m_frameStats.instanceBytes += bytes;
+    return true;
+}
+
+void Engine::UpdateVertexBuffer(uint32_t mesh, const EditableMesh* editMesh, RenderMesh* renderMesh, HWND hwnd) {
+    if (!editMesh || !renderMesh) { return; }
+    if (mesh >= m_meshVersions.size()) {
+        m_meshVersions.resize(size_t(mesh) + 1, 0);
+        m_stagedVertexCounts.resize(size_t(mesh) + 1, 0xFFFFFFFFu);
+    }
+    m_hwnd.store(hwnd, std::memory_order_relaxed);
+    m_lastMeshUploadBytes = 0;
 
     uint32_t count = renderMesh->drawVertexCount;
-    if (count > RenderMesh::kMaxDrawVertexCount) { count = RenderMesh::kMaxDrawVertexCount; }
+    if (count > (uint32_t)renderMesh->drawVertices.size()) { count = (uint32_t)renderMesh->drawVertices.size(); }
+
+    MeshUpload upload;
+    upload.mesh = mesh;
+    upload.version = ++m_meshVersions[mesh];
+    upload.drawVertexCount = count;
+    upload.fullVertices = renderMesh->allDirty || m_stagedVertexCounts[mesh] != count;
+
+    if (upload.fullVertices) {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t ev = renderMesh->drawToEdit[i];
+            renderMesh->drawVertices[i].position = editMesh->GetVertex(ev);
+        }
+
+        upload.vertices.assign(renderMesh->drawVertices.begin(), renderMesh->drawVertices.begin() + count);
+    } else if (!renderMesh->dirtyDrawVertices.empty()) {
+        // Partial upload: refresh only the touched draw vertices and stage them as contiguous runs.
+        std::vector<uint32_t>& dirtyList = renderMesh->dirtyDrawVertices;
+        std::sort(dirtyList.begin(), dirtyList.end());
+
+        for (uint32_t draw : dirtyList) {
+            renderMesh->drawVertices[draw].position = editMesh->GetVertex(renderMesh->drawToEdit[draw]);
+        }
+
+        size_t runStart = 0;
+        while (runStart < dirtyList.size()) {
+            size_t runEnd = runStart + 1;
+            while (runEnd < dirtyList.size() && dirtyList[runEnd] == dirtyList[runEnd - 1] + 1) { ++runEnd; }
+
+            uint32_t first = dirtyList[runStart];
+            upload.runs.push_back(first);
+            upload.runs.push_back(uint32_t(runEnd - runStart));
+            upload.vertices.insert(upload.vertices.end(), renderMesh->drawVertices.begin() + first, renderMesh->drawVertices.begin() + first + (runEnd - runStart));
 
-    for (uint32_t i = 0; i < count; ++i) {
-        uint32_t ev = renderMesh->drawToEdit[i];
-        renderMesh->drawVertices[i].position = editMesh->GetVertex(ev);
+            runStart = runEnd;
+        }
+    }
+    m_lastMeshUploadBytes += sizeof(Vertex) * uint64_t(upload.vertices.size());
+
+    upload.indexed = renderMesh->IsIndexed();
+    if (upload.indexed && renderMesh->indicesDirty) {
+        size_t indexBytes = size_t(renderMesh->IndexStride()) * renderMesh->indexCount;
+        const uint8_t* indexData = (const uint8_t*)renderMesh->IndexData();
+        upload.indicesChanged = true;
+        upload.index32 = renderMesh->Uses32BitIndices();
+        upload.indexCount = renderMesh->indexCount;
+        upload.indices.assign(indexData, indexData + indexBytes);
+        m_lastMeshUploadBytes += indexBytes;
+        renderMesh->indicesDirty = false;
     }
 
-    UINT8* pVertexDataBegin = nullptr;
-    D3D12_RANGE readRange = { 0, 0 };
+    m_stagedVertexCounts[mesh] = count;
+    m_totalMeshUploadBytes += m_lastMeshUploadBytes;
+    renderMesh->ClearDirty();
 
-    HRESULT hr = m_vertexBufferTetra->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin));
-    if (FAILED(hr) || !pVertexDataBegin) {
-        wchar_t buf[256];
-        swprintf_s(buf, L"VertexBuffer Map failed. hr=0x%08X", (unsigned)hr);
-        MessageBox(hwnd, buf, L"Error", MB_OK);
-        return;
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    m_uploads.push_back(std::move(upload));
+}
+
+// Records the copies for the queued uploads the snapshot's frame was built with. Snapshots may be
+// skipped but uploads never are, so partial uploads always land on the data they were diffed against.
+// The copies run ahead of this frame's draws and after every earlier frame on the queue.
+void Engine::RecordMeshUploads(const RenderSnapshot& snapshot) {
+    std::vector<D3D12_RESOURCE_BARRIER> barriers;
+    for (;;) {
+        MeshUpload upload;
+        {
+            std::lock_guard<std::mutex> lock(m_uploadMutex);
+            if (m_uploads.empty()) { break; }
+
+            const MeshUpload& front = m_uploads.front();
+            if (front.mesh >= snapshot.meshVersions.size() || front.version > snapshot.meshVersions[front.mesh]) { break; } //staged for a later frame
+            upload = std::move(m_uploads.front());
+            m_uploads.pop_front();
+        }
+        RecordMeshUpload(upload, barriers);
+    }
+
+    // Copied buffers are left in COPY_DEST; one batch moves them to the state their draws read them in.
+    if (!barriers.empty()) { m_commandList->ResourceBarrier((UINT)barriers.size(), barriers.data()); }
+}
+
+void Engine::RecordMeshUpload(const MeshUpload& upload, std::vector<D3D12_RESOURCE_BARRIER>& barriers) {
+    if (upload.mesh >= m_meshes.size()) { m_meshes.resize(size_t(upload.mesh) + 1); }
+    MeshBuffers& buffers = m_meshes[upload.mesh];
+    m_frameStats.meshUploads++;
+    if (upload.fullVertices) { m_frameStats.fullMeshUploads++; }
+
+    auto transitionAfterCopy = [&barriers](ID3D12Resource* buffer, D3D12_RESOURCE_STATES state) {
+        for (const D3D12_RESOURCE_BARRIER& barrier : barriers) {
+            if (barrier.Transition.pResource == buffer) { return; }
+        }
+        barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(buffer, D3D12_RESOURCE_STATE_COPY_DEST, state));
+    };
+
+    uint64_t vertexBytes = sizeof(Vertex) * uint64_t(upload.vertices.size());
+    if (vertexBytes > 0 && (upload.fullVertices || buffers.vertexBuffer)) {
+        if (upload.fullVertices && !EnsureMeshBuffer(buffers.vertexBuffer, buffers.vertexBufferBytes, vertexBytes)) { return; }
+
+        TransientAllocation staging;
+        if (!AllocateTransient(vertexBytes, 16, staging)) { return; }
+        memcpy(staging.cpu, upload.vertices.data(), size_t(vertexBytes));
+        m_frameStats.meshUploadBytes += vertexBytes;
+
+        if (upload.fullVertices) {
+            m_commandList->CopyBufferRegion(buffers.vertexBuffer.Get(), 0, staging.buffer, staging.offset, vertexBytes);
+            m_frameStats.copyCommands++;
+        } else {
+            uint64_t sourceOffset = staging.offset;
+            for (size_t r = 0; r + 1 < upload.runs.size(); r += 2) {
+                uint64_t runBytes = sizeof(Vertex) * uint64_t(upload.runs[r + 1]);
+                m_commandList->CopyBufferRegion(buffers.vertexBuffer.Get(), sizeof(Vertex) * uint64_t(upload.runs[r]), staging.buffer, sourceOffset, runBytes);
+                sourceOffset += runBytes;
+                m_frameStats.copyCommands++;
+            }
+        }
+        transitionAfterCopy(buffers.vertexBuffer.Get(), D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    }
+
+    buffers.indexed = upload.indexed;
+    if (upload.indicesChanged && !upload.indices.empty()) {
+        if (!EnsureMeshBuffer(buffers.indexBuffer, buffers.indexBufferBytes, upload.indices.size())) { return; }
+
+        TransientAllocation staging;
+        if (!AllocateTransient(upload.indices.size(), 16, staging)) { return; }
+        memcpy(staging.cpu, upload.indices.data(), upload.indices.size());
+        m_commandList->CopyBufferRegion(buffers.indexBuffer.Get(), 0, staging.buffer, staging.offset, upload.indices.size());
+        m_frameStats.meshUploadBytes += upload.indices.size();
+        m_frameStats.copyCommands++;
+        transitionAfterCopy(buffers.indexBuffer.Get(), D3D12_RESOURCE_STATE_INDEX_BUFFER);
+
+        buffers.indexCount = upload.indexCount;
+        buffers.indexFormat = upload.index32 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
     }
 
-    memcpy(pVertexDataBegin, renderMesh->drawVertices, sizeof(Vertex) * count);
-    m_vertexBufferTetra->Unmap(0, nullptr);
-    m_meshDrawVertexCount = count;
+    buffers.drawVertexCount = upload.drawVertexCount;
 }
 
-void Engine::PopulateCommandList() {
-    m_commandAllocator->Reset();
-    m_commandList->Reset(m_commandAllocator, m_pipelineStateTriangles);
+void Engine::PopulateCommandList(RenderSnapshot& snapshot, uint32_t slot) {
+    AE_PROFILE_ZONE("PopulateCommandList");
+    m_frameStats = RenderFrameStats();
+    m_frameStats.frame = snapshot.frameIndex;
+
+    FrameResources& frame = m_frames[slot];
+    frame.commandAllocator->Reset();
+    m_commandList->Reset(frame.commandAllocator.Get(), m_pipelineStateTriangles);
+
+    RecordMeshUploads(snapshot);
 
     m_commandList->SetGraphicsRootSignature(m_rootSignature);
 
@@ -91,127 +320,403 @@ void Engine::PopulateCommandList() {
         m_commandList->IASetVertexBuffers(0, 1, &gridVBV);
 
         // World = identity so WVP = VP.
-        DirectX::XMMATRIX VP = DirectX::XMLoadFloat4x4(&m_viewProj);
-        DirectX::XMFLOAT4X4 wvp;
-        DirectX::XMStoreFloat4x4(&wvp, VP);
-        m_commandList->SetGraphicsRoot32BitConstants(0, 16, &wvp, 0);
+        m_commandList->SetGraphicsRoot32BitConstants(0, 16, &snapshot.viewProj, 0);
 
         // 1) Base grid (dim)
         DirectX::XMFLOAT4 tint = DirectX::XMFLOAT4(0.35f, 0.35f, 0.35f, 1.0f);
         m_commandList->SetGraphicsRoot32BitConstants(1, 4, &tint, 0);
 
-        uint32_t baseCount = (m_gridBaseVertexCount > 0 && m_gridBaseVertexCount <= m_gridVertexCount) ? m_gridBaseVertexCount : m_gridVertexCount;
-        m_commandList->DrawInstanced(baseCount, 1, 0, 0);
+        m_commandList->DrawInstanced(m_gridVertexCount, 1, 0, 0);
+
+        m_frameStats.pipelineSwitches++;
+        m_frameStats.rootConstantWrites += 2;
+        m_frameStats.drawCalls++;
+        m_frameStats.instances++;
+        m_frameStats.verticesSubmitted += m_gridVertexCount;
+    }
+
+    // Now draw the objects (triangles). The draws are recorded into m_drawList first (no D3D12 there),
+    // then replayed here. Buffers and PSO are only rebound when the mesh changes between draws.
+    // Indexed meshes share vertices between faces and need the SV_PrimitiveID face-color PSO.
+    DrawSubmitMode mode = snapshot.drawSubmitMode;
+    if (!m_pipelineStateInstanced || !m_pipelineStateInstancedIndexed) { mode = DrawSubmitMode::PerObject; }
+
+    DrawListInput input;
+    input.objectCount = (uint32_t)snapshot.worlds.size();
+    input.worlds = snapshot.worlds.data();
+    input.tints = snapshot.tints.data();
+    input.meshes = snapshot.meshes.data();
+    input.selectedObject = snapshot.selectedObject;
+    input.pivotObject = snapshot.pivotObject;
+    BuildDrawList(mode, input, m_drawList);
+
+    D3D12_GPU_VIRTUAL_ADDRESS instanceData = 0;
+    if (mode == DrawSubmitMode::Instanced && !UploadInstances(instanceData)) {
+        mode = DrawSubmitMode::PerObject;
+        BuildDrawList(mode, input, m_drawList);
     }
+    bool instanced = (mode == DrawSubmitMode::Instanced);
 
-    // Now draw the objects (triangles).
-    m_commandList->SetPipelineState(m_pipelineStateTriangles);
     m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    
-    D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
-        m_vertexBufferTetra->GetGPUVirtualAddress(),
-        sizeof(Vertex) * RenderMesh::kMaxDrawVertexCount,
-        sizeof(Vertex)
-    };
-    m_commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
-
-    // Draw each object with its own world transform.
-    // D3D12 layer note: this is fixed-function pipeline setup + programmable (root constants) per draw.
-    uint32_t count = (m_objectCount == 0) ? 1 : m_objectCount;
-    if (count > kMaxObjects) count = kMaxObjects;
-
-    for (uint32_t i = 0; i < count; ++i) {
-        DirectX::XMMATRIX W = DirectX::XMLoadFloat4x4(&m_world[i]);
-        DirectX::XMMATRIX VP = DirectX::XMLoadFloat4x4(&m_viewProj);
-        DirectX::XMMATRIX WVP = DirectX::XMMatrixMultiply(W, VP);
-
-        DirectX::XMFLOAT4X4 wvp;
-        DirectX::XMStoreFloat4x4(&wvp, WVP);
-        m_commandList->SetGraphicsRoot32BitConstants(0, 16, &wvp, 0);
-        DirectX::XMFLOAT4 tint = m_tint[i];
-        if (tint.w == 0.0f) { tint = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f); }
-        if (i == m_debugPivotIndex) {
-            tint = DirectX::XMFLOAT4(0.25f, 1.0f, 1.0f, 1.0f);
+
+    DirectX::XMMATRIX VP = DirectX::XMLoadFloat4x4(&snapshot.viewProj);
+    if (instanced) {
+        // Instanced VS applies each instance's world itself, so b0 is just the view-projection.
+        m_commandList->SetGraphicsRoot32BitConstants(0, 16, &snapshot.viewProj, 0);
+        m_frameStats.rootConstantWrites++;
+    }
+
+    uint32_t boundMesh = 0xFFFFFFFFu;
+    const MeshBuffers* buffers = nullptr;
+    bool drawIndexed = false;
+
+    for (const DrawCommand& draw : m_drawList.draws) {
+        if (draw.mesh != boundMesh) {
+            boundMesh = draw.mesh;
+            buffers = (draw.mesh < m_meshes.size()) ? &m_meshes[draw.mesh] : nullptr;
+            if (buffers && (!buffers->vertexBuffer || buffers->drawVertexCount == 0)) { buffers = nullptr; }
+            if (!buffers) { continue; }
+
+            drawIndexed = buffers->indexed && buffers->indexBuffer && m_pipelineStateIndexed;
+            if (instanced) {
+                m_commandList->SetPipelineState(drawIndexed ? m_pipelineStateInstancedIndexed : m_pipelineStateInstanced);
+            } else {
+                m_commandList->SetPipelineState(drawIndexed ? m_pipelineStateIndexed : m_pipelineStateTriangles);
+            }
+            m_frameStats.pipelineSwitches++;
+
+            D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
+                buffers->vertexBuffer->GetGPUVirtualAddress(),
+                (UINT)(sizeof(Vertex) * buffers->drawVertexCount),
+                sizeof(Vertex)
+            };
+            m_commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+
+            if (drawIndexed) {
+                UINT indexStride = (buffers->indexFormat == DXGI_FORMAT_R32_UINT) ? 4u : 2u;
+                D3D12_INDEX_BUFFER_VIEW indexBufferView{
+                    buffers->indexBuffer->GetGPUVirtualAddress(),
+                    indexStride * buffers->indexCount,
+                    buffers->indexFormat
+                };
+                m_commandList->IASetIndexBuffer(&indexBufferView);
+            }
         }
-        if (i == m_selectedObject) {
-            tint = DirectX::XMFLOAT4(1.0f, 0.35f, 0.35f, 1.0f);
+        if (!buffers) { continue; }
+
+        if (instanced) {
+            // SV_InstanceID restarts at 0 per draw, so the group's slice is selected by offsetting the root SRV.
+            D3D12_GPU_VIRTUAL_ADDRESS instances = instanceData + sizeof(InstanceData) * uint64_t(draw.firstInstance);
+            m_commandList->SetGraphicsRootShaderResourceView(2, instances);
+            m_frameStats.rootSrvWrites++;
+        } else {
+            // D3D12 layer note: this is fixed-function pipeline setup + programmable (root constants) per draw.
+            const InstanceData& instance = m_drawList.instances[draw.firstInstance];
+            DirectX::XMMATRIX W = DirectX::XMLoadFloat4x4(&instance.world);
+            DirectX::XMMATRIX WVP = DirectX::XMMatrixMultiply(W, VP);
+
+            DirectX::XMFLOAT4X4 wvp;
+            DirectX::XMStoreFloat4x4(&wvp, WVP);
+            m_commandList->SetGraphicsRoot32BitConstants(0, 16, &wvp, 0);
+            m_commandList->SetGraphicsRoot32BitConstants(1, 4, &instance.tint, 0);
+            m_frameStats.rootConstantWrites += 2;
         }
-        m_commandList->SetGraphicsRoot32BitConstants(1, 4, &tint, 0);
 
-        m_commandList->DrawInstanced(m_meshDrawVertexCount, 1, 0, 0);
+        if (drawIndexed) {
+            m_commandList->DrawIndexedInstanced(buffers->indexCount, draw.instanceCount, 0, 0, 0);
+        } else {
+            m_commandList->DrawInstanced(buffers->drawVertexCount, draw.instanceCount, 0, 0);
+        }
+        m_frameStats.drawCalls++;
+        m_frameStats.instances += draw.instanceCount;
+        m_frameStats.verticesSubmitted += uint64_t(drawIndexed ? buffers->indexCount : buffers->drawVertexCount) * draw.instanceCount;
     }
 
     // Draw gizmo last (so we can classify visible vs occluded using depth).
-    if (m_vertexBufferGrid && m_gridVertexCount >= 2 && m_gizmoVertexCount > 0 && m_pipelineStateLines && m_pipelineStateLinesOccluded) {
-        D3D12_VERTEX_BUFFER_VIEW gridVBV{
-            m_vertexBufferGrid->GetGPUVirtualAddress(),
-            sizeof(Vertex) * m_gridVertexCount,
+    // Its vertices change every frame, so they are drawn straight from the upload ring.
+    TransientAllocation gizmo;
+    uint32_t gizmoVertexCount = (uint32_t)snapshot.gizmoVertices.size();
+    if (gizmoVertexCount > 0 && m_pipelineStateGizmo && m_pipelineStateGizmoOccluded && AllocateTransient(sizeof(Vertex) * uint64_t(gizmoVertexCount), 16, gizmo)) {
+        memcpy(gizmo.cpu, snapshot.gizmoVertices.data(), sizeof(Vertex) * size_t(gizmoVertexCount));
+        m_frameStats.gizmoBytes += sizeof(Vertex) * uint64_t(gizmoVertexCount);
+
+        D3D12_VERTEX_BUFFER_VIEW gizmoVBV{
+            gizmo.gpuAddress,
+            (UINT)(sizeof(Vertex) * gizmoVertexCount),
             sizeof(Vertex)
         };
 
         // World = identity so WVP = VP.
-        DirectX::XMMATRIX VP = DirectX::XMLoadFloat4x4(&m_viewProj);
-        DirectX::XMFLOAT4X4 wvp;
-        DirectX::XMStoreFloat4x4(&wvp, VP);
-        m_commandList->SetGraphicsRoot32BitConstants(0, 16, &wvp, 0);
-
-        uint32_t baseCount = (m_gridBaseVertexCount > 0 && m_gridBaseVertexCount <= m_gridVertexCount) ? m_gridBaseVertexCount : m_gridVertexCount;
-        if ((baseCount + m_gizmoVertexCount) <= m_gridVertexCount) {
-            m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-            m_commandList->IASetVertexBuffers(0, 1, &gridVBV);
-
-            // Pass 1: visible part (depth func LESS_EQUAL) at full brightness.
-            m_commandList->SetPipelineState(m_pipelineStateGizmo);
-            DirectX::XMFLOAT4 tintVisible = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-            m_commandList->SetGraphicsRoot32BitConstants(1, 4, &tintVisible, 0);
-            m_commandList->DrawInstanced(m_gizmoVertexCount, 1, baseCount, 0);
-
-            // Pass 2: occluded part only (depth func GREATER) drawn darker.
-            m_commandList->SetPipelineState(m_pipelineStateGizmoOccluded);
-            DirectX::XMFLOAT4 tintOccluded = DirectX::XMFLOAT4(0.35f, 0.35f, 0.35f, 1.0f);
-            m_commandList->SetGraphicsRoot32BitConstants(1, 4, &tintOccluded, 0);
-            m_commandList->DrawInstanced(m_gizmoVertexCount, 1, baseCount, 0);
-        }
+        m_commandList->SetGraphicsRoot32BitConstants(0, 16, &snapshot.viewProj, 0);
+
+        m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        m_commandList->IASetVertexBuffers(0, 1, &gizmoVBV);
+
+        // Pass 1: visible part (depth func LESS_EQUAL) at full brightness.
+        m_commandList->SetPipelineState(m_pipelineStateGizmo);
+        DirectX::XMFLOAT4 tintVisible = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        m_commandList->SetGraphicsRoot32BitConstants(1, 4, &tintVisible, 0);
+        m_commandList->DrawInstanced(gizmoVertexCount, 1, 0, 0);
+
+        // Pass 2: occluded part only (depth func GREATER) drawn darker.
+        m_commandList->SetPipelineState(m_pipelineStateGizmoOccluded);
+        DirectX::XMFLOAT4 tintOccluded = DirectX::XMFLOAT4(0.35f, 0.35f, 0.35f, 1.0f);
+        m_commandList->SetGraphicsRoot32BitConstants(1, 4, &tintOccluded, 0);
+        m_commandList->DrawInstanced(gizmoVertexCount, 1, 0, 0);
+
+        m_frameStats.pipelineSwitches += 2;
+        m_frameStats.rootConstantWrites += 3;
+        m_frameStats.drawCalls += 2;
+        m_frameStats.instances += 2;
+        m_frameStats.verticesSubmitted += 2 * uint64_t(gizmoVertexCount);
     }
 
-    RenderFrameImGui();
+    {
+        std::lock_guard<std::mutex> lock(m_uiMutex);
+        RenderFrameImGui(snapshot.uiDrawData);
+    }
 
     barrier = CD3DX12_RESOURCE_BARRIER::Transition(m_gfx->CurrentBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
     m_commandList->ResourceBarrier(1, &barrier);
 
     m_commandList->Close();
 
-    ID3D12CommandList* ppCommandLists[] = { m_commandList };
+    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
     m_gfx->Queue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 }
 
 void Engine::WaitForGpu() {
-    const UINT64 fence = *m_fenceValue;
-    m_gfx->Queue()->Signal(m_fence, fence);
-    (*m_fenceValue)++;
+    m_framesInFlight.WaitForIdle();
+}
 
-    if (m_fence->GetCompletedValue() < fence) {
-        m_fence->SetEventOnCompletion(fence, m_fenceEvent);
-        WaitForSingleObject(m_fenceEvent, INFINITE);
-    }
+double Engine::NowMs() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_clockStart).count();
 }
 
-void Engine::MoveToNextFrame() {
-    const UINT64 fenceValue = ++(*m_fenceValue);
-    m_gfx->Queue()->Signal(m_fence, fenceValue);
+void Engine::MarkUpdateBegin() {
+    m_updateBeginMs = NowMs();
+}
+
+void Engine::RenderFrame() {
+    double publishMs = NowMs();
+
+    // Stay at most one snapshot ahead: while the render thread has not picked up the last one, the
+    // next would only replace it.
+    if (IsRenderThreadRunning()) {
+        ResetEvent(m_frameConsumedEvent);
+        if (m_snapshots.HasPending()) { WaitForSingleObject(m_frameConsumedEvent, INFINITE); }
+    }
+
+    RenderSnapshot& snapshot = m_snapshots.WriteSlot();
+    snapshot.frameIndex = m_submittedFrames++;
+    snapshot.viewProj = m_viewProj;
+
+    uint32_t objectCount = (uint32_t)(std::min)((size_t)m_objectCount, m_world.size());
+    snapshot.worlds.assign(m_world.begin(), m_world.begin() + objectCount);
+    snapshot.tints.assign(m_tint.begin(), m_tint.begin() + objectCount);
+    snapshot.meshes.assign(m_objectMesh.begin(), m_objectMesh.begin() + objectCount);
+    snapshot.selectedObject = m_selectedObject;
+    snapshot.pivotObject = m_debugPivotIndex;
+    snapshot.drawSubmitMode = m_drawSubmitMode;
+    snapshot.gizmoVertices = m_gizmoVertices;
+    snapshot.meshVersions = m_meshVersions;
+
+    // ImGui reuses its draw lists next frame, so the snapshot keeps copies.
+    snapshot.ReleaseUi();
+    if (ImGui::GetCurrentContext()) {
+        std::lock_guard<std::mutex> lock(m_uiMutex);
+        ImDrawData* drawData = ImGui::GetDrawData();
+        if (drawData && drawData->Valid) {
+            snapshot.uiDrawData = *drawData;
+            for (ImDrawList*& list : snapshot.uiDrawData.CmdLists) { list = list->CloneOutput(); }
+        }
+    }
+
+    m_updateTimings.push_back(TimingInterval{ snapshot.frameIndex, m_updateBeginMs, publishMs });
+    if (m_updateTimings.size() > kTimingFrames) { m_updateTimings.pop_front(); }
+
+    if (m_snapshots.Publish()) { m_droppedSnapshots++; }
 
-    if (m_fence->GetCompletedValue() < fenceValue) {
-        m_fence->SetEventOnCompletion(fenceValue, m_fenceEvent);
-        WaitForSingleObject(m_fenceEvent, INFINITE);
+    if (IsRenderThreadRunning()) {
+        SetEvent(m_frameReadyEvent);
+    } else {
+        RenderLatestSnapshot();
     }
+}
+
+bool Engine::RenderLatestSnapshot() {
+    AE_PROFILE_ZONE("RenderLatestSnapshot");
+    if (!m_snapshots.Acquire()) { return false; }
+    if (m_frameConsumedEvent) { SetEvent(m_frameConsumedEvent); }
+
+    RenderSnapshot& snapshot = m_snapshots.ReadSlot();
+    double beginMs = NowMs();
+
+    // Waits only if the GPU is still on the frame that last used this slot. Whatever that frame
+    // retired, and the ring space of every finished frame, can be reused from here on.
+    uint32_t slot = m_framesInFlight.BeginFrame();
+    m_frames[slot].retired.clear();
+    if (IGpuQueue* queue = m_framesInFlight.Queue()) { m_uploadRing.Reclaim(queue->CompletedValue()); }
 
+    PopulateCommandList(snapshot, slot);
+    {
+        AE_PROFILE_ZONE("Present");
+        m_gfx->SwapChain()->Present(1, 0);
+    }
+    m_uploadRing.EndFrame(m_framesInFlight.EndFrame());
     m_gfx->SetFrameIndexFromSwapChain();
+
+    m_lastDrawCallCount.store(m_drawList.DrawCallCount(), std::memory_order_relaxed);
+    m_lastInstanceCount.store((uint32_t)m_drawList.instances.size(), std::memory_order_relaxed);
+    m_uploadRingHighWater = (std::max)(m_uploadRingHighWater, m_uploadRing.HighWaterBytes());
+
+    std::lock_guard<std::mutex> lock(m_timingMutex);
+    m_uploadRingStats.capacityBytes = m_uploadRing.Capacity();
+    m_uploadRingStats.usedBytes = m_uploadRing.UsedBytes();
+    m_uploadRingStats.highWaterBytes = m_uploadRingHighWater;
+    m_uploadRingStats.lastFrameBytes = m_uploadRing.LastFrameBytes();
+    m_uploadRingStats.peakFrameBytes = (std::max)(m_uploadRingStats.peakFrameBytes, m_uploadRing.LastFrameBytes());
+    m_uploadRingStats.growCount = m_uploadRingGrowCount;
+    m_renderTimings.push_back(TimingInterval{ snapshot.frameIndex, beginMs, NowMs() });
+    if (m_renderTimings.size() > kTimingFrames) { m_renderTimings.pop_front(); }
+    m_frameStats.transientBytes = m_uploadRing.LastFrameBytes();
+    m_renderStats.push_back(m_frameStats);
+    if (m_renderStats.size() > kStatsFrames) { m_renderStats.pop_front(); }
+    return true;
 }
 
-void Engine::RenderFrame() {
-    PopulateCommandList();
-    m_gfx->SwapChain()->Present(1, 0);
-    MoveToNextFrame();
+void Engine::RenderThreadMain() {
+    Profiler::Get().SetThreadName("Render");
+    for (;;) {
+        WaitForSingleObject(m_frameReadyEvent, INFINITE);
+        if (m_renderThreadQuit.load(std::memory_order_acquire)) { return; }
+
+        RenderLatestSnapshot();
+    }
+}
+
+void Engine::StartRenderThread() {
+    if (IsRenderThreadRunning()) { return; }
+
+    m_frameReadyEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_frameConsumedEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!m_frameReadyEvent || !m_frameConsumedEvent) {
+        if (m_frameReadyEvent) { CloseHandle(m_frameReadyEvent); }
+        if (m_frameConsumedEvent) { CloseHandle(m_frameConsumedEvent); }
+        m_frameReadyEvent = nullptr;
+        m_frameConsumedEvent = nullptr;
+        return;
+    }
+
+    m_renderThreadQuit = false;
+    m_renderThread = std::thread([this]() { RenderThreadMain(); });
+}
+
+void Engine::StopRenderThread() {
+    if (!IsRenderThreadRunning()) { return; }
+
+    m_renderThreadQuit.store(true, std::memory_order_release);
+    SetEvent(m_frameReadyEvent);
+    m_renderThread.join();
+
+    CloseHandle(m_frameReadyEvent);
+    CloseHandle(m_frameConsumedEvent);
+    m_frameReadyEvent = nullptr;
+    m_frameConsumedEvent = nullptr;
+}
+
+// Render time spent inside each update interval, per render interval. Both lists are in time order and
+// neither overlaps itself, so one pass with two cursors finds every intersection.
+std::vector<double> Engine::RenderOverlaps(const std::deque<TimingInterval>& renders) const {
+    std::vector<double> overlaps(renders.size(), 0.0);
+    size_t u = 0;
+    for (size_t r = 0; r < renders.size(); ++r) {
+        while (u < m_updateTimings.size() && m_updateTimings[u].endMs <= renders[r].beginMs) { ++u; }
+        for (size_t k = u; k < m_updateTimings.size() && m_updateTimings[k].beginMs < renders[r].endMs; ++k) {
+            double begin = (std::max)(renders[r].beginMs, m_updateTimings[k].beginMs);
+            double end = (std::min)(renders[r].endMs, m_updateTimings[k].endMs);
+            if (end > begin) { overlaps[r] += end - begin; }
+        }
+    }
+    return overlaps;
+}
+
+UploadRingStats Engine::GetUploadRingStats() const {
+    std::lock_guard<std::mutex> lock(m_timingMutex);
+    return m_uploadRingStats;
+}
+
+FrameTimingSummary Engine::GetFrameTimingSummary() const {
+    std::deque<TimingInterval> renders;
+    {
+        std::lock_guard<std::mutex> lock(m_timingMutex);
+        renders = m_renderTimings;
+    }
+
+    FrameTimingSummary summary;
+    summary.droppedSnapshots = m_droppedSnapshots;
+    if (renders.empty() || m_updateTimings.empty()) { return summary; }
+
+    std::vector<double> overlaps = RenderOverlaps(renders);
+    for (size_t r = 0; r < renders.size(); ++r) {
+        summary.renderMs += renders[r].endMs - renders[r].beginMs;
+        summary.overlapMs += overlaps[r];
+    }
+    for (const TimingInterval& update : m_updateTimings) { summary.updateMs += update.endMs - update.beginMs; }
+
+    summary.frames = (uint32_t)renders.size();
+    summary.renderMs /= double(renders.size());
+    summary.overlapMs /= double(renders.size());
+    summary.updateMs /= double(m_updateTimings.size());
+    return summary;
+}
+
+void Engine::WriteFrameTimingReport(FILE* out) const {
+    if (!out) { return; }
+
+    std::deque<TimingInterval> renders;
+    {
+        std::lock_guard<std::mutex> lock(m_timingMutex);
+        renders = m_renderTimings;
+    }
+    std::vector<double> overlaps = RenderOverlaps(renders);
+
+    fprintf(out, "# render thread %s, times in ms since engine start\n", IsRenderThreadRunning() ? "on" : "off");
+    fprintf(out, "# frame update_begin update_end render_begin render_end render_ms overlap_ms\n");
+    size_t u = 0;
+    for (size_t r = 0; r < renders.size(); ++r) {
+        while (u < m_updateTimings.size() && m_updateTimings[u].frame < renders[r].frame) { ++u; }
+        double updateBegin = 0.0;
+        double updateEnd = 0.0;
+        if (u < m_updateTimings.size() && m_updateTimings[u].frame == renders[r].frame) {
+            updateBegin = m_updateTimings[u].beginMs;
+            updateEnd = m_updateTimings[u].endMs;
+        }
+        fprintf(out, "%llu %.3f %.3f %.3f %.3f %.3f %.3f\n", (unsigned long long)renders[r].frame, updateBegin, updateEnd, renders[r].beginMs, renders[r].endMs, renders[r].endMs - renders[r].beginMs, overlaps[r]);
+    }
+
+    FrameTimingSummary summary = GetFrameTimingSummary();
+    fprintf(out, "# frames %u, update %.3f ms, render %.3f ms, overlap %.3f ms, dropped snapshots %llu\n", summary.frames, summary.updateMs, summary.renderMs, summary.overlapMs, (unsigned long long)summary.droppedSnapshots);
+}
+
+std::vector<RenderFrameStats> Engine::GetRenderStatsHistory() const {
+    std::lock_guard<std::mutex> lock(m_timingMutex);
+    return std::vector<RenderFrameStats>(m_renderStats.begin(), m_renderStats.end());
+}
+
+void Engine::WriteRenderStatsCsv(FILE* out) const {
+    if (!out) { return; }
+
+    fprintf(out, "frame,draw_calls,instances,vertices,pipeline_switches,root_constant_writes,root_srv_writes,"
+        "mesh_uploads,full_mesh_uploads,copy_commands,mesh_upload_bytes,instance_bytes,gizmo_bytes,transient_bytes,ui_draw_calls,ui_vertices\n");
+    for (const RenderFrameStats& stats : GetRenderStatsHistory()) {
+        fprintf(out, "%llu,%u,%u,%llu,%u,%u,%u,%u,%u,%u,%llu,%llu,%llu,%llu,%u,%u\n",
+            (unsigned long long)stats.frame, stats.drawCalls, stats.instances, (unsigned long long)stats.verticesSubmitted,
+            stats.pipelineSwitches, stats.rootConstantWrites, stats.rootSrvWrites,
+            stats.meshUploads, stats.fullMeshUploads, stats.copyCommands,
+            (unsigned long long)stats.meshUploadBytes, (unsigned long long)stats.instanceBytes, (unsigned long long)stats.gizmoBytes,
+            (unsigned long long)stats.transientBytes, stats.uiDrawCalls, stats.uiVertices);
+    }
 }
 
 void Engine::SetViewProj(const DirectX::XMFLOAT4X4& viewProj) {
@@ -222,52 +727,45 @@ void Engine::SetObjectCount(uint32_t count) {
     m_objectCount = (count == 0) ? 1 : count;
 
     // Default worlds to identity so uninitialized objects don't explode.
-    uint32_t n = m_objectCount;
-    if (n > kMaxObjects) n = kMaxObjects;
-    for (uint32_t i = 0; i < n; ++i) {
-        DirectX::XMStoreFloat4x4(&m_world[i], DirectX::XMMatrixIdentity());
-        m_tint[i] = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-    }
+    DirectX::XMFLOAT4X4 identity;
+    DirectX::XMStoreFloat4x4(&identity, DirectX::XMMatrixIdentity());
+    m_world.assign(m_objectCount, identity);
+    m_tint.assign(m_objectCount, DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+    m_objectMesh.assign(m_objectCount, 0);
 }
 
 void Engine::SetObjectWorld(uint32_t index, const DirectX::XMFLOAT4X4& world) {
-    if (index >= kMaxObjects) return;
+    if (index >= m_world.size()) return;
     m_world[index] = world;
 }
 
 
 void Engine::SetObjectTint(uint32_t index, const DirectX::XMFLOAT4& tint) {
-    if (index >= kMaxObjects) return;
+    if (index >= m_tint.size()) return;
     m_tint[index] = tint;
 }
 
-void Engine::UpdateGizmoVertices(const Vertex* verts, uint32_t count, HWND hwnd) {
-    if (!m_vertexBufferGrid || !verts || count == 0) return;
-
-    // Clamp count so we don't write past the allocated tail.
-    if (count > m_gizmoVertexCount) count = m_gizmoVertexCount;
-    if (m_gridBaseVertexCount + count > m_gridVertexCount) return;
+void Engine::SetObjectMesh(uint32_t index, uint32_t mesh) {
+    if (index >= m_objectMesh.size()) return;
+    m_objectMesh[index] = mesh;
+}
 
-    UINT8* pData = nullptr;
-    D3D12_RANGE readRange = { 0, 0 };
+void Engine::UpdateGizmoVertices(const Vertex* verts, uint32_t count, HWND hwnd) {
+    if (!verts || count == 0) return;
 
-    HRESULT hr = m_vertexBufferGrid->Map(0, &readRange, reinterpret_cast<void**>(&pData));
-    if (FAILED(hr) || !pData) {
-        wchar_t buf[256];
-        swprintf_s(buf, L"Grid VertexBuffer Map failed (gizmo). hr=0x%08X", (unsigned)hr);
-        MessageBox(hwnd, buf, L"Error", MB_OK);
-        return;
-    }
+    m_hwnd.store(hwnd, std::memory_order_relaxed);
+    m_gizmoVertices.assign(verts, verts + count);
+}
 
-    size_t byteOffset = sizeof(Vertex) * size_t(m_gridBaseVertexCount);
-    memcpy(pData + byteOffset, verts, sizeof(Vertex) * count);
+// Caller holds m_uiMutex: the backend updates ImGui's textures while drawing.
+void Engine::RenderFrameImGui(ImDrawData& drawData) {
+    if (!drawData.Valid) { return; }
 
-    m_vertexBufferGrid->Unmap(0, nullptr);
-}
+    m_frameStats.uiVertices += (uint32_t)drawData.TotalVtxCount;
+    for (const ImDrawList* list : drawData.CmdLists) { m_frameStats.uiDrawCalls += (uint32_t)list->CmdBuffer.Size; }
 
-void Engine::RenderFrameImGui() {
     ID3D12DescriptorHeap* heaps[] = { m_gfx->SrvHeap() };
     m_commandList->SetDescriptorHeaps(1, heaps);
 
-    ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), m_commandList);
+    ImGui_ImplDX12_RenderDrawData(&drawData, m_commandList);
 }
\ No newline at end of file
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <windows.h>
+#include <wrl/client.h>
 #include <DirectXMath.h>
 
 #pragma warning(push)
@@ -10,75 +17,290 @@
 #include "third_party/d3dx12.h"
 #pragma warning(pop)
 
+#include "engine/core/RenderSnapshot.h"
+#include "engine/core/TripleBuffer.h"
+#include "engine/gfx/DrawList.h"
+#include "engine/gfx/FramesInFlight.h"
+#include "engine/gfx/UploadRing.h"
+
 class GraphicsDevice;
+class IGpuQueue;
 struct EditableMesh;
 struct RenderMesh;
 struct Vertex;
 
+// Averages over the frames kept for the timing report (see Engine::WriteFrameTimingReport).
+struct FrameTimingSummary {
+    uint32_t frames = 0;
+    double updateMs = 0.0;   // main thread: MarkUpdateBegin to RenderFrame
+    double renderMs = 0.0;   // render thread: record, present and fence wait
+    double overlapMs = 0.0;  // part of each render that ran while the main thread was updating
+    uint64_t droppedSnapshots = 0;
+};
+
+// Upload ring usage (see UploadRing), as of the last rendered frame.
+struct UploadRingStats {
+    uint64_t capacityBytes = 0;
+    uint64_t usedBytes = 0;       // frames the GPU has not finished yet, the last one included
+    uint64_t highWaterBytes = 0;  // most ever in use at once
+    uint64_t lastFrameBytes = 0;
+    uint64_t peakFrameBytes = 0;
+    uint32_t growCount = 0;       // times a frame did not fit and the ring was recreated larger
+};
+
+// Work recorded for one rendered frame, counted as the command list is built. ImGui's own draws are
+// only counted as uiDrawCalls/uiVertices (its backend records them).
+struct RenderFrameStats {
+    uint64_t frame = 0;
+    uint32_t drawCalls = 0;           // grid, objects and gizmo
+    uint32_t instances = 0;
+    uint64_t verticesSubmitted = 0;   // vertices (indices for indexed draws) times instances
+    uint32_t pipelineSwitches = 0;    // SetPipelineState calls
+    uint32_t rootConstantWrites = 0;  // SetGraphicsRoot32BitConstants calls
+    uint32_t rootSrvWrites = 0;       // SetGraphicsRootShaderResourceView calls (instanced draws)
+    uint32_t meshUploads = 0;         // staged UpdateVertexBuffer uploads recorded this frame
+    uint32_t fullMeshUploads = 0;     // of those, uploads of every vertex
+    uint32_t copyCommands = 0;        // CopyBufferRegion calls
+    uint64_t meshUploadBytes = 0;     // copied into the upload ring for mesh buffers
+    uint64_t instanceBytes = 0;
+    uint64_t gizmoBytes = 0;
+    uint64_t transientBytes = 0;      // everything the frame took from the upload ring, padding included
+    uint32_t uiDrawCalls = 0;
+    uint32_t uiVertices = 0;
+};
+
+// Threading: the Set*/Update* calls, MarkUpdateBegin and RenderFrame belong to the main thread and only
+// change main-thread state. RenderFrame copies that state into a RenderSnapshot and publishes it through
+// a triple buffer; the render thread (or RenderFrame itself when no render thread runs) records,
+// presents and waits for the GPU from the snapshot. D3D12 objects are only touched on the render side.
 class Engine {
 public:
+    ~Engine() { StopRenderThread(); }
+
     void SetGraphicsDevice(GraphicsDevice* gfx) { m_gfx = gfx; }
     GraphicsDevice* Gfx() const { return m_gfx; }
 
-    void SetRenderObjects(ID3D12CommandAllocator* commandAllocator, ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* rootSignature, ID3D12PipelineState* pipelineStateTriangles, ID3D12PipelineState* pipelineStateLines, ID3D12PipelineState* pipelineStateLinesOccluded, ID3D12PipelineState* pipelineStateGizmo, ID3D12PipelineState* pipelineStateGizmoOccluded, ID3D12Fence* fence, HANDLE fenceEvent, UINT64* fenceValue, ID3D12Resource* vertexBufferTetra, ID3D12Resource* vertexBufferGrid, uint32_t gridVertexCount, uint32_t width, uint32_t height);
-    void UpdateVertexBuffer(const EditableMesh* editMesh, RenderMesh* renderMesh, HWND hwnd);
+    // Creates one command allocator per frame slot (frameCount, clamped to FramesInFlight::kMaxFrames),
+    // the command list and the upload ring, and paces frames on queue. Call after SetGraphicsDevice,
+    // before rendering.
+    bool InitializeFrames(IGpuQueue* queue, uint32_t frameCount);
+    uint32_t FrameCount() const { return m_framesInFlight.FrameCount(); }
+    const FramesInFlight& Frames() const { return m_framesInFlight; }
+
+    void SetRenderObjects(ID3D12RootSignature* rootSignature, ID3D12PipelineState* pipelineStateTriangles, ID3D12PipelineState* pipelineStateLines, ID3D12PipelineState* pipelineStateLinesOccluded, ID3D12PipelineState* pipelineStateGizmo, ID3D12PipelineState* pipelineStateGizmoOccluded, ID3D12Resource* vertexBufferGrid, uint32_t gridVertexCount, uint32_t width, uint32_t height);
+    // PSO used for RenderMeshMode::Indexed meshes (face color from SV_PrimitiveID).
+    void SetIndexedPipeline(ID3D12PipelineState* pipelineStateIndexed) { m_pipelineStateIndexed = pipelineStateIndexed; }
+    // PSOs for DrawSubmitMode::Instanced (world and tint per instance from the root SRV at t0).
+    // Without them the engine draws per object.
+    void SetInstancedPipelines(ID3D12PipelineState* pipelineStateInstanced, ID3D12PipelineState* pipelineStateInstancedIndexed) {
+        m_pipelineStateInstanced = pipelineStateInstanced;
+        m_pipelineStateInstancedIndexed = pipelineStateInstancedIndexed;
+    }
+
+    void SetDrawSubmitMode(DrawSubmitMode mode) { m_drawSubmitMode = mode; }
+    DrawSubmitMode GetDrawSubmitMode() const { return m_drawSubmitMode; }
+    // Object draws recorded for the last rendered frame (see DrawList.h). Safe to read from any thread.
+    uint32_t LastDrawCallCount() const { return m_lastDrawCallCount.load(std::memory_order_relaxed); }
+    uint32_t LastInstanceCount() const { return m_lastInstanceCount.load(std::memory_order_relaxed); }
+
+    // Stages the render mesh for mesh slot `mesh` (one slot per mesh asset id). The changed draw
+    // vertices (all of them if the mesh is allDirty) and indices are copied into a queued upload. The
+    // render side puts it in the upload ring and copies it on the GPU into the mesh's default-heap
+    // buffers, growing them as needed.
+    // Clears the render mesh dirty state once staged.
+    void UpdateVertexBuffer(uint32_t mesh, const EditableMesh* editMesh, RenderMesh* renderMesh, HWND hwnd);
+    uint64_t LastMeshUploadBytes() const { return m_lastMeshUploadBytes; }
+    uint64_t TotalMeshUploadBytes() const { return m_totalMeshUploadBytes; }
 
-    void PopulateCommandList();
     void WaitForGpu();
-    void MoveToNextFrame();
+
+    // Without a render thread, RenderFrame records and presents inline (one thread, easier to debug).
+    void StartRenderThread();
+    void StopRenderThread();
+    bool IsRenderThreadRunning() const { return m_renderThread.joinable(); }
+
+    // Main-thread frame boundaries: call MarkUpdateBegin when Update starts; RenderFrame ends the frame
+    // and publishes its snapshot.
+    void MarkUpdateBegin();
     void RenderFrame();
 
+    // Held while ImGui builds a frame on the main thread and while the render thread draws ImGui output,
+    // since both touch ImGui's shared textures.
+    std::mutex& UiMutex() { return m_uiMutex; }
+
+    FrameTimingSummary GetFrameTimingSummary() const;
+    UploadRingStats GetUploadRingStats() const;
+    // One line per rendered frame (update, render and overlap times), then the averages.
+    void WriteFrameTimingReport(FILE* out) const;
+
+    // Render counters of the last kStatsFrames rendered frames, oldest first. Safe to call from any thread.
+    static const size_t kStatsFrames = 300;
+    std::vector<RenderFrameStats> GetRenderStatsHistory() const;
+    // The history as CSV, one row per frame.
+    void WriteRenderStatsCsv(FILE* out) const;
+
     void SetViewProj(const DirectX::XMFLOAT4X4& viewProj);
 
     // Simple scene support (multiple objects drawn with different world transforms).
     void SetObjectCount(uint32_t count);
     void SetObjectWorld(uint32_t index, const DirectX::XMFLOAT4X4& world);
     void SetObjectTint(uint32_t index, const DirectX::XMFLOAT4& tint);
+    void SetObjectMesh(uint32_t index, uint32_t mesh);
     void SetSelectedObject(uint32_t index) { m_selectedObject = index; }
 
-    // Update gizmo vertices written into the tail of the grid vertex buffer (upload heap).
+    // Gizmo vertices for this frame; the render side puts them in the upload ring.
     void UpdateGizmoVertices(const Vertex* verts, uint32_t count, HWND hwnd);
 
     // Debug helpers (editor-only visualization).
     // If set to a valid index, that object will be tinted cyan to visualize a pivot/marker.
     void SetDebugPivotIndex(uint32_t index) { m_debugPivotIndex = index; }
-    
-    void RenderFrameImGui();
+
 private:
     GraphicsDevice* m_gfx = nullptr;
 
-    ID3D12CommandAllocator* m_commandAllocator = nullptr;
-    ID3D12GraphicsCommandList* m_commandList = nullptr;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_commandList;
     ID3D12RootSignature* m_rootSignature = nullptr;
     ID3D12PipelineState* m_pipelineStateTriangles = nullptr;
     ID3D12PipelineState* m_pipelineStateLines = nullptr;
     ID3D12PipelineState* m_pipelineStateLinesOccluded = nullptr;
     ID3D12PipelineState* m_pipelineStateGizmo = nullptr;
     ID3D12PipelineState* m_pipelineStateGizmoOccluded = nullptr;
-    ID3D12Resource* m_vertexBufferTetra = nullptr;
+    ID3D12PipelineState* m_pipelineStateIndexed = nullptr;
+    ID3D12PipelineState* m_pipelineStateInstanced = nullptr;
+    ID3D12PipelineState* m_pipelineStateInstancedIndexed = nullptr;
     ID3D12Resource* m_vertexBufferGrid = nullptr;
     uint32_t m_gridVertexCount = 0;
-    uint32_t m_meshDrawVertexCount = 0;
 
-    ID3D12Fence* m_fence = nullptr;
-    HANDLE m_fenceEvent = nullptr;
-    UINT64* m_fenceValue = nullptr;
+    // Mesh buffers are owned by the engine so they can grow with the mesh. They live in the default
+    // heap and are only written by copies recorded ahead of the frame's draws, so frames in flight
+    // (earlier in the queue) never see a later edit.
+    // One entry per mesh slot; a slot keeps its buffers when its asset is freed and the next asset
+    // with that id reuses them.
+    struct MeshBuffers {
+        Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
+        Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+        uint64_t vertexBufferBytes = 0;
+        uint64_t indexBufferBytes = 0;
+        uint32_t drawVertexCount = 0;
+        uint32_t indexCount = 0;
+        DXGI_FORMAT indexFormat = DXGI_FORMAT_R16_UINT;
+        bool indexed = false;
+    };
+    std::vector<MeshBuffers> m_meshes;
+
+    // A staged mesh upload. Partial uploads carry the changed draw vertices as runs of consecutive indices.
+    struct MeshUpload {
+        uint32_t mesh = 0;
+        uint64_t version = 0;
+        uint32_t drawVertexCount = 0;
+        bool fullVertices = false;
+        std::vector<uint32_t> runs; //first, count pairs into the vertex buffer (partial uploads)
+        std::vector<Vertex> vertices;
+        bool indexed = false;
+        bool indicesChanged = false;
+        bool index32 = false;
+        uint32_t indexCount = 0;
+        std::vector<uint8_t> indices;
+    };
+
+    // Filled on the main thread, drained in order on the render side. Never skipped, unlike snapshots.
+    std::mutex m_uploadMutex;
+    std::deque<MeshUpload> m_uploads;
+
+    // Main-thread staging state.
+    std::vector<uint64_t> m_meshVersions;
+    std::vector<uint32_t> m_stagedVertexCounts;
+    uint64_t m_lastMeshUploadBytes = 0;
+    uint64_t m_totalMeshUploadBytes = 0;
+    std::atomic<HWND> m_hwnd{ nullptr }; //for error message boxes on the render side
+
+    // Per frame slot. A slot is only reused after FramesInFlight::BeginFrame has waited for its
+    // previous frame, which also releases the resources that frame retired.
+    struct FrameResources {
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
+        // Buffers replaced during the frame; frames in flight may still read them.
+        std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retired;
+    };
+    FrameResources m_frames[FramesInFlight::kMaxFrames];
+    FramesInFlight m_framesInFlight;
+
+    // Transient per-frame data (gizmo vertices, instances, mesh edits on their way to the default heap)
+    // is suballocated from one persistently mapped upload buffer and reclaimed by frame fence.
+    struct TransientAllocation {
+        uint8_t* cpu = nullptr;
+        ID3D12Resource* buffer = nullptr;
+        uint64_t offset = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+    };
+    static const uint64_t kInitialUploadRingBytes = 4ull << 20;
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_uploadRingBuffer;
+    UploadRing m_uploadRing;
+    uint32_t m_uploadRingGrowCount = 0;
+    uint64_t m_uploadRingHighWater = 0;
+
+    bool CreateUploadRing(uint64_t capacityBytes);
+    bool AllocateTransient(uint64_t size, uint64_t alignment, TransientAllocation& out);
+    bool EnsureMeshBuffer(Microsoft::WRL::ComPtr<ID3D12Resource>& buffer, uint64_t& capacityBytes, uint64_t neededBytes);
+    void RecordMeshUploads(const RenderSnapshot& snapshot);
+    void RecordMeshUpload(const MeshUpload& upload, std::vector<D3D12_RESOURCE_BARRIER>& barriers);
 
     uint32_t m_width = 0;
     uint32_t m_height = 0;
 
+    // Main-thread frame state, copied into the snapshot by RenderFrame.
     DirectX::XMFLOAT4X4 m_viewProj = {};
 
-    static const uint32_t kMaxObjects = 16;
+    // Per-object draw data, sized by SetObjectCount (no fixed object limit).
     uint32_t m_objectCount = 1;
-    DirectX::XMFLOAT4X4 m_world[kMaxObjects] = {};
-    DirectX::XMFLOAT4 m_tint[kMaxObjects] = {};
+    std::vector<DirectX::XMFLOAT4X4> m_world;
+    std::vector<DirectX::XMFLOAT4> m_tint;
+    std::vector<uint32_t> m_objectMesh;
 
-    // Grid buffer layout: [gridBase][gizmoTail]
-    uint32_t m_gridBaseVertexCount = 0;
-    uint32_t m_gizmoVertexCount = 0;
+    DrawSubmitMode m_drawSubmitMode = DrawSubmitMode::Instanced;
+    std::vector<Vertex> m_gizmoVertices;
 
     uint32_t m_selectedObject = 0;
 
     uint32_t m_debugPivotIndex = 0xFFFFFFFFu;
+
+    // Render side (render thread, or the main thread inside RenderFrame without one).
+    DrawList m_drawList;
+    RenderFrameStats m_frameStats; //the frame being recorded
+    std::atomic<uint32_t> m_lastDrawCallCount{ 0 };
+    std::atomic<uint32_t> m_lastInstanceCount{ 0 };
+
+    bool UploadInstances(D3D12_GPU_VIRTUAL_ADDRESS& instances);
+    void PopulateCommandList(RenderSnapshot& snapshot, uint32_t slot);
+    void RenderFrameImGui(ImDrawData& drawData);
+    bool RenderLatestSnapshot();
+    void RenderThreadMain();
+
+    // Snapshot handoff.
+    TripleBuffer<RenderSnapshot> m_snapshots;
+    uint64_t m_submittedFrames = 0;
+    uint64_t m_droppedSnapshots = 0;
+    std::thread m_renderThread;
+    std::atomic<bool> m_renderThreadQuit{ false };
+    HANDLE m_frameReadyEvent = nullptr;     //set by RenderFrame after each publish
+    HANDLE m_frameConsumedEvent = nullptr;  //set by the render thread after each acquire
+    std::mutex m_uiMutex;
+
+    // Frame timing. Update intervals are main-thread only; render intervals are written by the render
+    // side under m_timingMutex. Both keep the last kTimingFrames frames.
+    struct TimingInterval {
+        uint64_t frame = 0;
+        double beginMs = 0.0;
+        double endMs = 0.0;
+    };
+    static const size_t kTimingFrames = 240;
+    std::chrono::steady_clock::time_point m_clockStart = std::chrono::steady_clock::now();
+    double m_updateBeginMs = 0.0;
+    std::deque<TimingInterval> m_updateTimings;
+    mutable std::mutex m_timingMutex;
+    std::deque<TimingInterval> m_renderTimings;
+    UploadRingStats m_uploadRingStats; //also under m_timingMutex
+    std::deque<RenderFrameStats> m_renderStats; //also under m_timingMutex, last kStatsFrames frames
+
+    double NowMs() const;
+    std::vector<double> RenderOverlaps(const std::deque<TimingInterval>& renders) const;
 };
@@ -0,0 +1,83 @@
+#include "engine/core/FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Bounds for the spin margin: below the minimum the sleep itself is the error; above the maximum the
+// OS timer is too coarse to help and most of the wait is spent spinning anyway.
+static const std::chrono::microseconds kMinSpinMargin(100);
+static const std::chrono::microseconds kMaxSpinMargin(20000);
+
+void FramePacer::SetTargetFrameRate(double framesPerSecond) {
+    m_framesPerSecond = (framesPerSecond > 0.0) ? framesPerSecond : 0.0;
+    m_interval = (m_framesPerSecond > 0.0)
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_framesPerSecond))
+        : Clock::duration::zero();
+    m_started = false;
+    ResetStats();
+}
+
+void FramePacer::Wait() {
+    Clock::time_point now = Clock::now();
+
+    if (m_interval > Clock::duration::zero()) {
+        m_deadline = m_started ? m_deadline + m_interval : now + m_interval;
+
+        if (now >= m_deadline) {
+            m_missedDeadlines++;
+            if (now - m_deadline > m_interval) { m_deadline = now; } //too far behind: start over from here
+        } else {
+            Clock::time_point sleepUntil = m_deadline - m_spinMargin;
+            if (sleepUntil > now) {
+                std::this_thread::sleep_until(sleepUntil);
+
+                // Follow the overshoot up at once and back down slowly.
+                Clock::duration overshoot = Clock::now() - sleepUntil;
+                Clock::duration decayed = m_spinMargin - m_spinMargin / 64;
+                Clock::duration margin = (std::max)(overshoot + overshoot / 4, decayed);
+                m_spinMargin = (std::min)((std::max)(margin, std::chrono::duration_cast<Clock::duration>(kMinSpinMargin)), std::chrono::duration_cast<Clock::duration>(kMaxSpinMargin));
+            }
+            while (Clock::now() < m_deadline) { std::this_thread::yield(); }
+        }
+        now = Clock::now();
+    }
+
+    if (m_started) {
+        if (m_frameMs.size() != kHistoryFrames) { m_frameMs.assign(kHistoryFrames, 0.0); }
+        m_frameMs[m_frameCount % kHistoryFrames] = std::chrono::duration<double, std::milli>(now - m_lastFrame).count();
+        m_frameCount++;
+    }
+    m_lastFrame = now;
+    m_started = true;
+}
+
+FramePacingStats FramePacer::Stats() const {
+    FramePacingStats stats;
+    stats.targetMs = std::chrono::duration<double, std::milli>(m_interval).count();
+    stats.missedDeadlines = m_missedDeadlines;
+    stats.spinMarginMs = std::chrono::duration<double, std::milli>(m_spinMargin).count();
+
+    uint32_t frames = (uint32_t)(std::min)(m_frameCount, (uint64_t)kHistoryFrames);
+    if (frames == 0) { return stats; }
+
+    std::vector<double> deviations(m_frameMs.begin(), m_frameMs.begin() + frames);
+    double total = 0.0;
+    for (double ms : deviations) { total += ms; }
+    stats.frames = frames;
+    stats.meanMs = total / double(frames);
+
+    double reference = (stats.targetMs > 0.0) ? stats.targetMs : stats.meanMs; //unpaced: deviation from the mean
+    for (double& ms : deviations) { ms = std::fabs(ms - reference); }
+    std::sort(deviations.begin(), deviations.end());
+    stats.p50DeviationMs = deviations[frames / 2];
+    stats.p99DeviationMs = deviations[(std::min)(frames - 1, frames * 99 / 100)];
+    stats.maxDeviationMs = deviations.back();
+    return stats;
+}
+
+void FramePacer::ResetStats() {
+    m_frameMs.assign(kHistoryFrames, 0.0);
+    m_frameCount = 0;
+    m_missedDeadlines = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Frame-time jitter over the frames kept by a FramePacer (see FramePacer::Stats).
+struct FramePacingStats {
+    uint32_t frames = 0;
+    double targetMs = 0.0;          // 0 when unpaced
+    double meanMs = 0.0;            // frame start to frame start
+    double p50DeviationMs = 0.0;    // |frame time - target|, median
+    double p99DeviationMs = 0.0;
+    double maxDeviationMs = 0.0;
+    uint64_t missedDeadlines = 0;   // frames that ended after their deadline (since ResetStats)
+    double spinMarginMs = 0.0;      // current sleep-to-spin handover, see Wait
+};
+
+// Holds frames to a fixed rate. Deadlines advance by exactly one interval per frame, so a slightly late
+// frame is made up by the next one and the average rate stays exact; a frame more than an interval late
+// restarts the schedule instead of rushing frames to catch up.
+// Wait sleeps until shortly before the deadline and spins the rest: OS sleeps overshoot (tens of
+// microseconds on Linux, up to a scheduler tick on Windows), so the spin margin follows the largest
+// recent overshoot. No platform headers; steady_clock only.
+class FramePacer {
+public:
+    static const uint32_t kHistoryFrames = 600;
+
+    // 0 = unpaced: Wait returns at once but frame times are still recorded.
+    void SetTargetFrameRate(double framesPerSecond);
+    double TargetFrameRate() const { return m_framesPerSecond; }
+
+    // Call once per frame when the frame's work is done; returns at the frame's deadline.
+    void Wait();
+    // The next Wait starts a new schedule and records no frame time (after the host blocked on purpose).
+    void Restart() { m_started = false; }
+
+    // Frame times of the last kHistoryFrames frames against the target (p50/p99 sort a copy).
+    FramePacingStats Stats() const;
+    void ResetStats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double m_framesPerSecond = 0.0;
+    Clock::duration m_interval = Clock::duration::zero();
+    Clock::time_point m_deadline;
+    Clock::time_point m_lastFrame;
+    bool m_started = false;
+
+    Clock::duration m_spinMargin = std::chrono::milliseconds(1);
+
+    std::vector<double> m_frameMs; // ring of kHistoryFrames
+    uint64_t m_frameCount = 0;
+    uint64_t m_missedDeadlines = 0;
+};
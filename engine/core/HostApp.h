@@ -1,22 +1,38 @@
 #pragma once
 
-#include <windows.h>
 #include <cstdint>
 
+class RedrawPolicy;
+
 struct HostFrame {
     float dt = 0.0f;
     float rawDt = 0.0f;
     float totalTime = 0.0f;
     uint64_t frameIndex = 0;
+    // With a fixed simulation step (HostLoopConfig::fixedStepSeconds): how far this frame lies between
+    // the last simulation step and the next one, 0..1. Draw state as lerp(previous, current, interpolation).
+    float interpolation = 1.0f;
 };
 
+// One frame of a host loop (see HostRunner). No platform types, so windowed and headless hosts share it.
 class IHostApp {
 public:
     virtual ~IHostApp() {}
 
     virtual void BeginFrame() = 0;
-    virtual void PumpMessages(MSG& msg) = 0;
+    // Handles pending platform messages. Returns false once the app should quit; exitCode is then
+    // what HostRunner::Run returns.
+    virtual bool PumpMessages(int& exitCode) = 0;
+    // With a fixed simulation step, called zero or more times per frame before Update. step.dt is the
+    // fixed step, step.totalTime the simulated time and step.frameIndex the step number.
+    virtual void FixedUpdate(const HostFrame& step) { (void)step; }
     virtual void Update(const HostFrame& frame) = 0;
     virtual void BuildFrameUI() = 0;
     virtual void Render() = 0;
+
+    // Event-driven hosts return their policy: HostRunner then runs a frame only when it asks for one,
+    // and otherwise calls WaitForEvents. Without one every iteration runs a frame.
+    virtual RedrawPolicy* Redraw() { return nullptr; }
+    // Blocks until a platform event arrives or timeoutSeconds pass (negative: no timeout).
+    virtual void WaitForEvents(double timeoutSeconds) { (void)timeoutSeconds; }
 };
\ No newline at end of file
@@ -1,30 +1,55 @@
 #include "engine/core/HostRunner.h"
 #include "engine/core/HostApp.h"
+#include "engine/core/FramePacer.h"
+#include "engine/core/Profiler.h"
+#include "engine/core/RedrawPolicy.h"
 
-#include <windows.h>
+#include <chrono>
+#include <cmath>
 
-int HostRunner::Run(IHostApp& app) {
+int HostRunner::Run(IHostApp& app, const HostLoopConfig& config) {
     const float maxFrameDt = 0.25f; // Clamp huge stalls so editor motion/timers do not jump forward by seconds.
 
-    LARGE_INTEGER freq = {};
-    LARGE_INTEGER prev = {};
-    QueryPerformanceFrequency(&freq);
-    QueryPerformanceCounter(&prev);
+    auto start = std::chrono::steady_clock::now();
+    auto prev = start;
 
-    MSG msg = {};
+    int exitCode = 0;
     float totalTime = 0.0f;
     uint64_t frameIndex = 0;
 
-    while (msg.message != WM_QUIT) {
-        app.BeginFrame();
-        app.PumpMessages(msg);
+    double stepAccumulator = 0.0;
+    double simulatedTime = 0.0;
+    uint64_t stepIndex = 0;
 
-        if (msg.message == WM_QUIT) { break; }
+    Profiler::Get().SetThreadName("Main");
 
-        LARGE_INTEGER now = {};
-        QueryPerformanceCounter(&now);
+    for (;;) {
+        Profiler::Get().MarkFrame();
+        {
+            AE_PROFILE_ZONE("BeginFrame");
+            app.BeginFrame();
+        }
+        {
+            AE_PROFILE_ZONE("PumpMessages");
+            if (!app.PumpMessages(exitCode)) { break; }
+        }
 
-        float rawDt = float(double(now.QuadPart - prev.QuadPart) / double(freq.QuadPart));
+        auto now = std::chrono::steady_clock::now();
+
+        RedrawPolicy* redraw = app.Redraw();
+        double nowSeconds = std::chrono::duration<double>(now - start).count();
+        if (redraw && !redraw->ShouldRender(nowSeconds)) {
+            AE_PROFILE_ZONE("Idle");
+            app.WaitForEvents(redraw->WaitSeconds(nowSeconds));
+
+            // Time spent waiting is not frame time: the next frame's dt starts when the wait ends.
+            prev = std::chrono::steady_clock::now();
+            redraw->IdleWaited(std::chrono::duration<double>(prev - now).count());
+            if (config.pacer) { config.pacer->Restart(); }
+            continue;
+        }
+
+        float rawDt = std::chrono::duration<float>(now - prev).count();
         prev = now;
 
         float dt = rawDt;
@@ -37,10 +62,47 @@ int HostRunner::Run(IHostApp& app) {
         frame.totalTime = totalTime;
         frame.frameIndex = frameIndex++;
 
-        app.Update(frame);
-        app.BuildFrameUI();
-        app.Render();
+        if (config.fixedStepSeconds > 0.0) {
+            AE_PROFILE_ZONE("FixedUpdate");
+            const double step = config.fixedStepSeconds;
+            stepAccumulator += dt;
+
+            uint32_t steps = 0;
+            while (stepAccumulator >= step && steps < config.maxStepsPerFrame) {
+                HostFrame fixed = {};
+                fixed.dt = (float)step;
+                fixed.rawDt = (float)step;
+                fixed.totalTime = (float)simulatedTime;
+                fixed.frameIndex = stepIndex++;
+                app.FixedUpdate(fixed);
+
+                simulatedTime += step;
+                stepAccumulator -= step;
+                steps++;
+            }
+            if (stepAccumulator >= step) { stepAccumulator = std::fmod(stepAccumulator, step); } //too far behind to catch up
+
+            frame.interpolation = (float)(stepAccumulator / step);
+        }
+
+        {
+            AE_PROFILE_ZONE("Update");
+            app.Update(frame);
+        }
+        {
+            AE_PROFILE_ZONE("BuildFrameUI");
+            app.BuildFrameUI();
+        }
+        {
+            AE_PROFILE_ZONE("Render");
+            app.Render();
+        }
+        if (redraw) { redraw->FrameRendered(); }
+        if (config.pacer) {
+            AE_PROFILE_ZONE("Pace");
+            config.pacer->Wait();
+        }
     }
 
-    return static_cast<int>(msg.wParam);
-}
\ No newline at end of file
+    return exitCode;
+}
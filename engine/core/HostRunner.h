@@ -1,8 +1,21 @@
 #pragma once
 
+#include <cstdint>
+
+class FramePacer;
 class IHostApp;
 
+struct HostLoopConfig {
+    // > 0: the simulation advances in steps of exactly this length through IHostApp::FixedUpdate
+    // (1.0 / 24.0 for the game runtime), and frames get an interpolation factor between steps.
+    double fixedStepSeconds = 0.0;
+    // Steps run per frame at most; after a long stall the rest of the backlog is dropped.
+    uint32_t maxStepsPerFrame = 8;
+    // Set: every frame waits for its deadline after Render (see FramePacer).
+    FramePacer* pacer = nullptr;
+};
+
 class HostRunner {
 public:
-    static int Run(IHostApp& app);
+    static int Run(IHostApp& app, const HostLoopConfig& config = HostLoopConfig());
 };
\ No newline at end of file
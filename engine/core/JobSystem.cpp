@@ -0,0 +1,165 @@
+#include "engine/core/JobSystem.h"
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// Which queue the current thread owns. Threads that are not workers of this system use queue 0.
+static thread_local const JobSystem* t_owner = nullptr;
+static thread_local uint32_t t_queueIndex = 0;
+
+void JobSystem::Initialize(uint32_t threadCount) {
+    Shutdown();
+
+    if (threadCount == 0) { threadCount = (std::max)(1u, std::thread::hardware_concurrency()); }
+    m_threadCount = threadCount;
+
+    m_queues.clear();
+    for (uint32_t i = 0; i < threadCount; ++i) { m_queues.push_back(std::make_unique<Queue>()); }
+
+    m_running = true;
+    for (uint32_t i = 1; i < threadCount; ++i) {
+        m_workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+void JobSystem::Shutdown() {
+    if (!m_running) { return; }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers) { worker.join(); }
+    m_workers.clear();
+
+    // Without workers nothing else would drain queue 0.
+    Job job;
+    while (PopOrSteal(0, job)) { Execute(job); }
+}
+
+uint32_t JobSystem::CurrentQueue() const {
+    return (t_owner == this) ? t_queueIndex : 0;
+}
+
+void JobSystem::Run(JobCounter& counter, JobFunction job) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (IsSingleThreaded() || m_queues.empty()) {
+        Job inlineJob{ std::move(job), &counter };
+        Execute(inlineJob);
+        return;
+    }
+
+    // Counted before it becomes visible, so a thief can never take the count below zero.
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+    Queue& queue = *m_queues[CurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{ std::move(job), &counter });
+    }
+
+    // Taking the sleep mutex orders this against a worker that just checked m_queuedJobs.
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_wake.notify_one();
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    uint32_t self = CurrentQueue();
+    while (!counter.IsDone()) {
+        Job job;
+        if (PopOrSteal(self, job)) {
+            Execute(job);
+        } else {
+            std::this_thread::yield(); //the remaining jobs are running on other threads
+        }
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const RangeFunction& body) {
+    if (count == 0) { return; }
+    grainSize = (std::max)(grainSize, 1u);
+
+    if (IsSingleThreaded() || count <= grainSize) {
+        body(0, count);
+        return;
+    }
+
+    // A few chunks per thread so stealing can even out chunks that take longer than others.
+    uint32_t chunkCount = (std::min)((count + grainSize - 1) / grainSize, m_threadCount * 4);
+    uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    JobCounter counter;
+    for (uint32_t begin = chunkSize; begin < count; begin += chunkSize) {
+        uint32_t end = (std::min)(begin + chunkSize, count);
+        Run(counter, [&body, begin, end]() { body(begin, end); });
+    }
+
+    body(0, (std::min)(chunkSize, count));
+    Wait(counter);
+}
+
+bool JobSystem::PopOrSteal(uint32_t self, Job& out) {
+    if (m_queues.empty()) { return false; }
+
+    // Own queue from the back: the most recently pushed job, whose data is most likely still in cache.
+    {
+        Queue& queue = *m_queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            out = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // Other queues from the front, starting at the next thread so thieves spread out.
+    uint32_t queueCount = (uint32_t)m_queues.size();
+    for (uint32_t i = 1; i < queueCount; ++i) {
+        Queue& queue = *m_queues[(self + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            out = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            m_stealCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(Job& job) {
+    {
+        AE_PROFILE_ZONE("Job");
+        job.function();
+    }
+    m_jobCount.fetch_add(1, std::memory_order_relaxed);
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(uint32_t index) {
+    t_owner = this;
+    t_queueIndex = index;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "Worker %u", index);
+    Profiler::Get().SetThreadName(name);
+
+    for (;;) {
+        Job job;
+        if (PopOrSteal(index, job)) {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() { return !m_running || m_queuedJobs.load(std::memory_order_acquire) > 0; });
+        if (!m_running && m_queuedJobs.load(std::memory_order_acquire) == 0) { return; }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts unfinished jobs. Pass one counter to several Run calls, then Wait on it.
+// A job may Run more jobs on its own counter or wait on another one; that is how dependencies are expressed.
+struct JobCounter {
+    std::atomic<uint32_t> pending{ 0 };
+
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing job system. Every participating thread owns a deque (the thread that called Initialize
+// is thread 0): it pushes and pops its own jobs at the back, newest first, while idle threads steal
+// from the front of the other deques. Waiting threads run jobs instead of blocking, so a job can wait
+// on other jobs without starving the pool.
+// threadCount 1 starts no workers and runs every job on the caller, in submission order, so a run is
+// reproducible for debugging. No platform headers; usable from tools and headless code.
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+    using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+    JobSystem() = default;
+    ~JobSystem() { Shutdown(); }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // threadCount includes the calling thread; 0 = one per hardware thread.
+    void Initialize(uint32_t threadCount = 0);
+    // Runs whatever is still queued, then joins the workers.
+    void Shutdown();
+
+    uint32_t ThreadCount() const { return m_threadCount; }
+    bool IsSingleThreaded() const { return m_threadCount <= 1; }
+
+    void Run(JobCounter& counter, JobFunction job);
+    void Wait(JobCounter& counter);
+
+    // Splits [0, count) into chunks of at least grainSize and calls body(begin, end) for each.
+    // The caller runs the first chunk itself and returns once every chunk is done.
+    void ParallelFor(uint32_t count, uint32_t grainSize, const RangeFunction& body);
+
+    uint64_t JobCount() const { return m_jobCount.load(std::memory_order_relaxed); }
+    uint64_t StealCount() const { return m_stealCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    uint32_t m_threadCount = 1;
+
+    // Workers sleep on m_wake while m_queuedJobs is 0.
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<uint32_t> m_queuedJobs{ 0 };
+    std::atomic<bool> m_running{ false };
+
+    std::atomic<uint64_t> m_jobCount{ 0 };
+    std::atomic<uint64_t> m_stealCount{ 0 };
+
+    uint32_t CurrentQueue() const;
+    bool PopOrSteal(uint32_t self, Job& out);
+    void Execute(Job& job);
+    void WorkerLoop(uint32_t index);
+};
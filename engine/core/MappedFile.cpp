@@ -0,0 +1,95 @@
+#include "engine/core/MappedFile.h"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const wchar_t* path) {
+    Close();
+
+    HANDLE file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    m_file = file;
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) { Close(); return false; }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { Close(); return false; }
+    m_mapping = mapping;
+
+    m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_data) { Close(); return false; }
+    m_size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) { UnmapViewOfFile(m_data); }
+    if (m_mapping) { CloseHandle((HANDLE)m_mapping); }
+    if (m_file) { CloseHandle((HANDLE)m_file); }
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const wchar_t* path) {
+    Close();
+
+    m_fd = ::open(WidePathToUtf8(path).c_str(), O_RDONLY);
+    if (m_fd < 0) { return false; }
+
+    struct stat info = {};
+    if (::fstat(m_fd, &info) != 0 || info.st_size <= 0) { Close(); return false; }
+
+    void* data = ::mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED) { Close(); return false; }
+    m_data = data;
+    m_size = (size_t)info.st_size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) { ::munmap(const_cast<void*>(m_data), m_size); }
+    if (m_fd >= 0) { ::close(m_fd); }
+    m_data = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+
+#endif
+
+std::string WidePathToUtf8(const wchar_t* path) {
+    std::string narrow;
+    for (const wchar_t* c = path; *c; ++c) {
+        uint32_t cp = (uint32_t)*c;
+        if (cp < 0x80) {
+            narrow += (char)cp;
+        } else if (cp < 0x800) {
+            narrow += (char)(0xC0 | (cp >> 6));
+            narrow += (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            narrow += (char)(0xE0 | (cp >> 12));
+            narrow += (char)(0x80 | ((cp >> 6) & 0x3F));
+            narrow += (char)(0x80 | (cp & 0x3F));
+        } else {
+            narrow += (char)(0xF0 | (cp >> 18));
+            narrow += (char)(0x80 | ((cp >> 12) & 0x3F));
+            narrow += (char)(0x80 | ((cp >> 6) & 0x3F));
+            narrow += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+    return narrow;
+}
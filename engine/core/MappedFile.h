@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file mapped into memory (CreateFileMapping on Windows, mmap elsewhere).
+// The mapping starts on a page boundary, so data aligned within the file is aligned in memory too.
+// Pages are read on first touch; nothing is copied.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Fails for missing and empty files.
+    bool Open(const wchar_t* path);
+    void Close();
+
+    const void* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    void* m_file = nullptr;    // HANDLE
+    void* m_mapping = nullptr; // HANDLE
+#else
+    int m_fd = -1;
+#endif
+    const void* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// Paths stay wide like the editor's; this encodes one as UTF-8 for the C runtime and POSIX calls.
+std::string WidePathToUtf8(const wchar_t* path);
@@ -0,0 +1,171 @@
+#include "engine/core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+// The calling thread's buffer (a Profiler::ThreadBuffer) and how many of its zones are open.
+static thread_local void* t_buffer = nullptr;
+static thread_local uint32_t t_depth = 0;
+
+static void WriteJsonString(FILE* out, const char* text) {
+    std::fputc('"', out);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') { std::fputc('\\', out); }
+        if ((unsigned char)*c < 0x20) { continue; }
+        std::fputc(*c, out);
+    }
+    std::fputc('"', out);
+}
+
+Profiler& Profiler::Get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::NowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::ThreadBuffer& Profiler::CurrentThreadBuffer() {
+    if (t_buffer) { return *static_cast<ThreadBuffer*>(t_buffer); }
+
+    std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+    buffer->zones.reset(new ZoneSlot[kZonesPerThread]);
+
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    buffer->threadId = (uint32_t)m_buffers.size() + 1;
+    buffer->name = "Thread " + std::to_string(buffer->threadId);
+    t_buffer = buffer.get();
+    m_buffers.push_back(std::move(buffer));
+    return *m_buffers.back();
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer& buffer = CurrentThreadBuffer();
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    buffer.name = name;
+}
+
+void Profiler::MarkFrame() {
+    if (!IsEnabled()) { return; }
+
+    uint64_t now = NowNs();
+    std::lock_guard<std::mutex> lock(m_framesMutex);
+    m_frameStarts[m_frameCount % kFrameHistory] = now;
+    m_frameCount++;
+}
+
+void Profiler::RecentFrameStarts(uint32_t count, std::vector<uint64_t>& out) const {
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(m_framesMutex);
+    uint64_t available = (std::min)(m_frameCount, (uint64_t)kFrameHistory);
+    uint64_t first = m_frameCount - (std::min)((uint64_t)count, available);
+    for (uint64_t i = first; i < m_frameCount; ++i) {
+        out.push_back(m_frameStarts[i % kFrameHistory]);
+    }
+}
+
+void Profiler::RecordZone(const char* name, uint64_t beginNs, uint64_t endNs, uint32_t depth) {
+    ThreadBuffer& buffer = CurrentThreadBuffer();
+
+    // Only this thread writes the buffer; the release store publishes the slot to readers.
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    ZoneSlot& slot = buffer.zones[index % kZonesPerThread];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.beginNs.store(beginNs, std::memory_order_relaxed);
+    slot.endNs.store(endNs, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::CopyZones(const ThreadBuffer& buffer, uint64_t beginNs, uint64_t endNs, std::vector<ProfileZoneRecord>& out) const {
+    uint64_t written = buffer.written.load(std::memory_order_acquire);
+    uint64_t first = written - (std::min)(written, (uint64_t)kZonesPerThread);
+
+    size_t start = out.size();
+    for (uint64_t i = first; i < written; ++i) {
+        const ZoneSlot& slot = buffer.zones[i % kZonesPerThread];
+        ProfileZoneRecord zone;
+        zone.name = slot.name.load(std::memory_order_relaxed);
+        zone.beginNs = slot.beginNs.load(std::memory_order_relaxed);
+        zone.endNs = slot.endNs.load(std::memory_order_relaxed);
+        zone.depth = slot.depth.load(std::memory_order_relaxed);
+        if (zone.endNs > beginNs && zone.beginNs < endNs) { out.push_back(zone); }
+    }
+
+    // The thread keeps recording while we copy; drop whatever it may have overwritten meanwhile,
+    // including the slot it may be writing right now.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = buffer.written.load(std::memory_order_relaxed) + 1;
+    uint64_t stillValid = after - (std::min)(after, (uint64_t)kZonesPerThread);
+    if (stillValid > first) {
+        uint64_t lost = stillValid - first;
+        // Zones are stored in end order, so the overwritten ones are at the front of what we copied.
+        size_t copied = out.size() - start;
+        size_t drop = (size_t)(std::min)((uint64_t)copied, lost);
+        out.erase(out.begin() + start, out.begin() + start + drop);
+    }
+
+    // Stored when they end; views want them by start (parents before children).
+    std::sort(out.begin() + start, out.end(), [](const ProfileZoneRecord& a, const ProfileZoneRecord& b) {
+        return (a.beginNs != b.beginNs) ? a.beginNs < b.beginNs : a.depth < b.depth;
+    });
+}
+
+void Profiler::CollectZones(uint64_t beginNs, uint64_t endNs, std::vector<ProfileThreadZones>& out) const {
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+        ProfileThreadZones thread;
+        thread.threadId = buffer->threadId;
+        thread.threadName = buffer->name;
+        CopyZones(*buffer, beginNs, endNs, thread.zones);
+        if (!thread.zones.empty()) { out.push_back(std::move(thread)); }
+    }
+}
+
+void Profiler::WriteChromeTrace(FILE* out) const {
+    std::vector<ProfileThreadZones> threads;
+    CollectZones(0, UINT64_MAX, threads);
+
+    uint64_t originNs = UINT64_MAX;
+    for (const ProfileThreadZones& thread : threads) {
+        if (!thread.zones.empty()) { originNs = (std::min)(originNs, thread.zones.front().beginNs); }
+    }
+
+    // Complete ("X") events in microseconds, plus a thread_name metadata event per thread.
+    std::fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const ProfileThreadZones& thread : threads) {
+        std::fprintf(out, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", first ? "" : ",\n", thread.threadId);
+        WriteJsonString(out, thread.threadName.c_str());
+        std::fprintf(out, "}}");
+        first = false;
+
+        for (const ProfileZoneRecord& zone : thread.zones) {
+            std::fprintf(out, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                thread.threadId, double(zone.beginNs - originNs) / 1000.0, double(zone.endNs - zone.beginNs) / 1000.0);
+            WriteJsonString(out, zone.name);
+            std::fprintf(out, "}");
+        }
+    }
+    std::fprintf(out, "\n]}\n");
+}
+
+ProfileZone::ProfileZone(const char* name) {
+    if (!Profiler::Get().IsEnabled()) { return; }
+
+    m_name = name;
+    m_depth = t_depth++;
+    m_beginNs = Profiler::NowNs();
+}
+
+ProfileZone::~ProfileZone() {
+    if (!m_name) { return; }
+
+    uint64_t endNs = Profiler::NowNs();
+    t_depth--;
+    Profiler::Get().RecordZone(m_name, m_beginNs, endNs, m_depth);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped CPU profiling. AE_PROFILE_ZONE("Name") times the enclosing scope on the calling thread.
+// Each thread appends finished zones to its own ring buffer (no locks, no allocation after the
+// thread's first zone), so a zone costs two clock reads and a store while enabled, a branch while
+// disabled at runtime, and nothing when built with AE_PROFILER 0.
+// Names must be string literals (or otherwise outlive the profiler); only the pointer is kept.
+#ifndef AE_PROFILER
+#define AE_PROFILER 1
+#endif
+
+#define AE_PROFILE_CONCAT_INNER(a, b) a##b
+#define AE_PROFILE_CONCAT(a, b) AE_PROFILE_CONCAT_INNER(a, b)
+
+#if AE_PROFILER
+#define AE_PROFILE_ZONE(name) ProfileZone AE_PROFILE_CONCAT(aeProfileZone, __LINE__)(name)
+#else
+#define AE_PROFILE_ZONE(name) ((void)0)
+#endif
+
+struct ProfileZoneRecord {
+    const char* name = nullptr;
+    uint64_t beginNs = 0;
+    uint64_t endNs = 0;
+    uint32_t depth = 0; //zones open on the thread when this one began
+};
+
+// The zones one thread recorded inside a time range, oldest first.
+struct ProfileThreadZones {
+    uint32_t threadId = 0;
+    std::string threadName;
+    std::vector<ProfileZoneRecord> zones;
+};
+
+class Profiler {
+public:
+    // Zones each thread keeps; older ones are overwritten.
+    static const uint32_t kZonesPerThread = 1u << 16;
+    // Frame start times kept for frame-based views.
+    static const uint32_t kFrameHistory = 256;
+
+    static Profiler& Get();
+
+    // Nanoseconds on a steady clock shared by every thread.
+    static uint64_t NowNs();
+
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Names the calling thread in views and traces ("Thread N" otherwise).
+    void SetThreadName(const char* name);
+
+    // Call once per frame on the thread that drives frames, at the start of the frame.
+    void MarkFrame();
+    // Start times of the last count frames (fewer if not recorded yet), oldest first.
+    void RecentFrameStarts(uint32_t count, std::vector<uint64_t>& out) const;
+
+    void RecordZone(const char* name, uint64_t beginNs, uint64_t endNs, uint32_t depth);
+
+    // Zones that overlap [beginNs, endNs), per thread (threads without any are left out).
+    void CollectZones(uint64_t beginNs, uint64_t endNs, std::vector<ProfileThreadZones>& out) const;
+
+    // Every zone still buffered, as Chrome trace event JSON (chrome://tracing, Perfetto).
+    void WriteChromeTrace(FILE* out) const;
+
+private:
+    // A ProfileZoneRecord that readers may copy while its thread overwrites it. Relaxed atomics are
+    // plain loads and stores on x86/x64; a torn copy is detected and dropped, see CopyZones.
+    struct ZoneSlot {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> beginNs{ 0 };
+        std::atomic<uint64_t> endNs{ 0 };
+        std::atomic<uint32_t> depth{ 0 };
+    };
+
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::string name;
+        std::unique_ptr<ZoneSlot[]> zones;  //ring of kZonesPerThread
+        std::atomic<uint64_t> written{ 0 }; //zones ever recorded; the ring holds the last kZonesPerThread
+    };
+
+    std::atomic<bool> m_enabled{ true };
+
+    // Buffers are created on a thread's first zone and kept after the thread exits, so its zones stay
+    // readable. The mutex only guards the list, never a recording thread.
+    mutable std::mutex m_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    mutable std::mutex m_framesMutex;
+    uint64_t m_frameStarts[kFrameHistory] = {};
+    uint64_t m_frameCount = 0;
+
+    ThreadBuffer& CurrentThreadBuffer();
+    void CopyZones(const ThreadBuffer& buffer, uint64_t beginNs, uint64_t endNs, std::vector<ProfileZoneRecord>& out) const;
+};
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name = nullptr; //null while the profiler is disabled
+    uint64_t m_beginNs = 0;
+    uint32_t m_depth = 0;
+};
@@ -0,0 +1,48 @@
+#include "engine/core/RedrawPolicy.h"
+
+void RedrawPolicy::RequestAfter(double delaySeconds) {
+    double timeSeconds = m_nowSeconds + delaySeconds;
+    if (!m_hasTimer || timeSeconds < m_timerSeconds) { m_timerSeconds = timeSeconds; }
+    m_hasTimer = true;
+}
+
+bool RedrawPolicy::ShouldRender(double nowSeconds) {
+    m_nowSeconds = nowSeconds;
+    if (m_hasTimer && nowSeconds >= m_timerSeconds) {
+        m_hasTimer = false;
+        Request(RedrawReason::Timer);
+    }
+    if (m_animating) { Request(RedrawReason::Animation); }
+
+    if (m_idleEnabled && m_pending == 0 && m_settleFrames == 0) { return false; }
+
+    // Requests made while this frame runs (commands from the UI, say) are for the next one.
+    m_frameReasons = m_pending;
+    m_pending = 0;
+    return true;
+}
+
+double RedrawPolicy::WaitSeconds(double nowSeconds) const {
+    if (!m_hasTimer) { return -1.0; }
+    return (m_timerSeconds > nowSeconds) ? m_timerSeconds - nowSeconds : 0.0;
+}
+
+void RedrawPolicy::FrameRendered() {
+    m_stats.framesRendered++;
+    for (uint32_t reason = 0; reason < (uint32_t)RedrawReason::Count; ++reason) {
+        if (m_frameReasons & (1u << reason)) { m_stats.framesByReason[reason]++; }
+    }
+
+    if (m_frameReasons != 0) {
+        m_stats.framesRequested++;
+        m_settleFrames = kSettleFrames;
+    } else if (m_settleFrames > 0) {
+        m_settleFrames--;
+    }
+    m_frameReasons = 0;
+}
+
+void RedrawPolicy::IdleWaited(double seconds) {
+    m_stats.idleWaits++;
+    m_stats.idleSeconds += seconds;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+// Why a frame was asked for. A frame may have several reasons; they are kept as bits.
+enum class RedrawReason : uint32_t {
+    Input = 0,     // a platform message (input, resize, paint) was handled
+    Command,       // an editor command ran
+    Animation,     // something moves on its own (held keys, drags); see SetAnimating
+    Dirty,         // data changed outside of input (loads, external edits)
+    Timer,         // a scheduled redraw came due (see RequestAfter)
+    Count
+};
+
+// Idle mode counters since the last ResetStats.
+struct RedrawStats {
+    uint64_t framesRendered = 0;
+    uint64_t framesRequested = 0; // frames some reason asked for; the others are settle frames
+    uint64_t idleWaits = 0;    // times the host blocked instead of running a frame
+    double idleSeconds = 0.0;  // time spent blocked
+    uint64_t framesByReason[(uint32_t)RedrawReason::Count] = {}; // frames each reason asked for
+};
+
+// Decides, for an event-driven host, whether the next loop iteration runs a frame or blocks until an
+// event or a timer. Time is passed in (seconds on any monotonic clock), so the decisions are plain
+// functions of the calls made and can be driven from a headless host.
+//
+// With idle mode off every iteration renders, like a game loop. With it on a frame runs only when
+// something asked for one, plus kSettleFrames more: UI reacts to input one frame late (hover, a
+// command's result) and needs those to catch up.
+class RedrawPolicy {
+public:
+    static const uint32_t kSettleFrames = 3;
+
+    void SetIdleEnabled(bool enabled) { m_idleEnabled = enabled; }
+    bool IdleEnabled() const { return m_idleEnabled; }
+
+    void Request(RedrawReason reason) { m_pending |= 1u << (uint32_t)reason; }
+    // Frames keep running while animating, without requests.
+    void SetAnimating(bool animating) { m_animating = animating; }
+    // Schedules a redraw delaySeconds after the current frame began (the earliest of several wins).
+    void RequestAfter(double delaySeconds);
+
+    // Whether the iteration at nowSeconds should run a frame.
+    bool ShouldRender(double nowSeconds);
+    // How long the host may block at nowSeconds before a timer is due; negative means until an event.
+    double WaitSeconds(double nowSeconds) const;
+
+    // Bookkeeping for the host loop: a frame ran, or the host blocked for seconds.
+    void FrameRendered();
+    void IdleWaited(double seconds);
+
+    const RedrawStats& Stats() const { return m_stats; }
+    void ResetStats() { m_stats = RedrawStats(); }
+
+private:
+    bool m_idleEnabled = false;
+    bool m_animating = false;
+    uint32_t m_pending = 0;       // RedrawReason bits
+    uint32_t m_frameReasons = 0;  // reasons of the frame ShouldRender approved
+    uint32_t m_settleFrames = kSettleFrames; // render a few frames at startup too
+    bool m_hasTimer = false;
+    double m_timerSeconds = 0.0;
+    double m_nowSeconds = 0.0;    // as of the last ShouldRender
+    RedrawStats m_stats;
+};
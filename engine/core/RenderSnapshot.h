@@ -0,0 +1,46 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+#include "engine/gfx/DrawList.h"
+#include "editor/modes/modeling/RenderMesh.h"
+#include "third_party/imgui/imgui.h"
+
+// Everything the render thread needs to record one frame, copied out of the main thread's Engine
+// state by Engine::RenderFrame. The render thread only reads it, so Update can already change the
+// next frame while this one is being recorded.
+struct RenderSnapshot {
+    uint64_t frameIndex = 0;
+
+    DirectX::XMFLOAT4X4 viewProj = {};
+
+    // Per object, parallel.
+    std::vector<DirectX::XMFLOAT4X4> worlds;
+    std::vector<DirectX::XMFLOAT4> tints;
+    std::vector<uint32_t> meshes;
+    uint32_t selectedObject = 0;
+    uint32_t pivotObject = 0xFFFFFFFFu;
+    DrawSubmitMode drawSubmitMode = DrawSubmitMode::Instanced;
+
+    std::vector<Vertex> gizmoVertices;
+
+    // Uploads staged per mesh slot up to this frame. The render thread applies queued mesh uploads up
+    // to these versions before drawing, so geometry always matches the frame.
+    std::vector<uint64_t> meshVersions;
+
+    // ImGui output of this frame. The draw lists are clones owned by the snapshot (freed on the main
+    // thread, which owns the ImGui allocator).
+    ImDrawData uiDrawData;
+
+    RenderSnapshot() = default;
+    RenderSnapshot(const RenderSnapshot&) = delete;
+    RenderSnapshot& operator=(const RenderSnapshot&) = delete;
+    ~RenderSnapshot() { ReleaseUi(); }
+
+    void ReleaseUi() {
+        for (ImDrawList* list : uiDrawData.CmdLists) { IM_DELETE(list); }
+        uiDrawData.Clear();
+    }
+};
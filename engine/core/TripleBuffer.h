@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer triple buffer.
+// The producer always owns one slot to write and the consumer one slot to read; the third slot holds
+// the latest published value. Publish and Acquire are one atomic exchange each, so neither side ever
+// waits for the other. Publishing twice before the consumer looks overwrites the older value (latest wins).
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side.
+    T& WriteSlot() { return m_slots[m_write]; }
+
+    // Makes the write slot the latest value and hands the producer the previous middle slot.
+    // Returns true if that previous value was never acquired (the consumer skipped it).
+    bool Publish() {
+        uint32_t previous = m_middle.exchange(m_write | kFresh, std::memory_order_acq_rel);
+        m_write = previous & kIndexMask;
+        return (previous & kFresh) != 0;
+    }
+
+    // Consumer side. Swaps in the latest value if one was published since the last Acquire.
+    bool Acquire() {
+        if ((m_middle.load(std::memory_order_acquire) & kFresh) == 0) { return false; }
+
+        uint32_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & kIndexMask;
+        return true;
+    }
+
+    T& ReadSlot() { return m_slots[m_read]; }
+
+    // True while a published value has not been acquired yet. Either side may ask.
+    bool HasPending() const { return (m_middle.load(std::memory_order_acquire) & kFresh) != 0; }
+
+private:
+    static const uint32_t kIndexMask = 3;
+    static const uint32_t kFresh = 4;
+
+    T m_slots[3];
+    uint32_t m_write = 0;
+    uint32_t m_read = 1;
+    std::atomic<uint32_t> m_middle{ 2 };
+};
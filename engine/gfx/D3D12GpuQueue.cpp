@@ -0,0 +1,45 @@
+#include "engine/gfx/D3D12GpuQueue.h"
+
+bool D3D12GpuQueue::Initialize(ID3D12Device* device, ID3D12CommandQueue* queue) {
+    Shutdown();
+    if (!device || !queue) { return false; }
+
+    if (FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)))) { return false; }
+    m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!m_fenceEvent) {
+        m_fence.Reset();
+        return false;
+    }
+
+    m_queue = queue;
+    m_nextValue = 0;
+    return true;
+}
+
+void D3D12GpuQueue::Shutdown() {
+    if (m_fenceEvent) {
+        CloseHandle(m_fenceEvent);
+        m_fenceEvent = nullptr;
+    }
+    m_fence.Reset();
+    m_queue = nullptr;
+}
+
+uint64_t D3D12GpuQueue::Signal() {
+    if (!m_queue || !m_fence) { return 0; }
+
+    uint64_t value = ++m_nextValue;
+    m_queue->Signal(m_fence.Get(), value);
+    return value;
+}
+
+uint64_t D3D12GpuQueue::CompletedValue() {
+    return m_fence ? m_fence->GetCompletedValue() : 0;
+}
+
+void D3D12GpuQueue::WaitForValue(uint64_t value) {
+    if (!m_fence || m_fence->GetCompletedValue() >= value) { return; }
+
+    m_fence->SetEventOnCompletion(value, m_fenceEvent);
+    WaitForSingleObject(m_fenceEvent, INFINITE);
+}
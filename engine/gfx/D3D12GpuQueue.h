@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <windows.h>
+#include <wrl/client.h>
+
+#pragma warning(push)
+#pragma warning(disable : 6001)
+#include "third_party/d3dx12.h"
+#pragma warning(pop)
+
+#include "engine/gfx/GpuQueue.h"
+
+// IGpuQueue over a D3D12 command queue: owns the fence and the event the CPU waits on.
+class D3D12GpuQueue : public IGpuQueue {
+public:
+    ~D3D12GpuQueue() override { Shutdown(); }
+
+    bool Initialize(ID3D12Device* device, ID3D12CommandQueue* queue);
+    void Shutdown();
+
+    uint64_t Signal() override;
+    uint64_t CompletedValue() override;
+    void WaitForValue(uint64_t value) override;
+
+private:
+    ID3D12CommandQueue* m_queue = nullptr;
+    Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+    HANDLE m_fenceEvent = nullptr;
+    uint64_t m_nextValue = 0;
+};
@@ -0,0 +1,74 @@
+#include "engine/gfx/DrawList.h"
+
+static DirectX::XMFLOAT4 ResolveTint(const DrawListInput& input, uint32_t object) {
+    DirectX::XMFLOAT4 tint = input.tints[object];
+    if (tint.w == 0.0f) { tint = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f); }
+    if (object == input.pivotObject) {
+        tint = DirectX::XMFLOAT4(0.25f, 1.0f, 1.0f, 1.0f);
+    }
+    if (object == input.selectedObject) {
+        tint = DirectX::XMFLOAT4(1.0f, 0.35f, 0.35f, 1.0f);
+    }
+    return tint;
+}
+
+void BuildDrawList(DrawSubmitMode mode, const DrawListInput& input, DrawList& out) {
+    out.Clear();
+    out.mode = mode;
+
+    uint32_t count = input.objectCount;
+    if (count == 0 || !input.worlds || !input.tints || !input.meshes) { return; }
+
+    out.instances.resize(count);
+
+    if (mode == DrawSubmitMode::PerObject) {
+        out.draws.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            out.instances[i].world = input.worlds[i];
+            out.instances[i].tint = ResolveTint(input, i);
+
+            DrawCommand& draw = out.draws[i];
+            draw.mesh = input.meshes[i];
+            draw.firstInstance = i;
+            draw.instanceCount = 1;
+        }
+        return;
+    }
+
+    // Counting sort by mesh id. Mesh ids are dense slot indices, so the histogram stays small.
+    uint32_t meshSlots = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (input.meshes[i] + 1 > meshSlots) { meshSlots = input.meshes[i] + 1; }
+    }
+
+    std::vector<uint32_t> offsets(size_t(meshSlots) + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) { offsets[input.meshes[i] + 1]++; }
+    for (uint32_t m = 0; m < meshSlots; ++m) {
+        if (offsets[m + 1] > 0) {
+            DrawCommand draw;
+            draw.mesh = m;
+            draw.firstInstance = offsets[m];
+            draw.instanceCount = offsets[m + 1];
+            out.draws.push_back(draw);
+        }
+        offsets[m + 1] += offsets[m];
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        InstanceData& instance = out.instances[offsets[input.meshes[i]]++];
+        instance.world = input.worlds[i];
+        instance.tint = ResolveTint(input, i);
+    }
+}
+
+void WriteDrawList(const DrawList& list, FILE* out) {
+    if (!out) { return; }
+
+    std::fprintf(out, "DrawList mode=%s draws=%u instances=%u\n",
+        list.mode == DrawSubmitMode::Instanced ? "instanced" : "per-object",
+        list.DrawCallCount(), (unsigned)list.instances.size());
+
+    for (const DrawCommand& draw : list.draws) {
+        std::fprintf(out, "  draw mesh=%u first=%u count=%u\n", draw.mesh, draw.firstInstance, draw.instanceCount);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// How object draws are submitted.
+// PerObject: one draw per object, world*viewProj and tint go through root constants (original path).
+// Instanced: objects are grouped by mesh and each group is one instanced draw that reads world and
+// tint from a per-instance structured buffer.
+enum class DrawSubmitMode {
+    PerObject = 0,
+    Instanced
+};
+
+// Layout must match InstanceData in the instanced vertex shader (EditorMain).
+struct InstanceData {
+    DirectX::XMFLOAT4X4 world;
+    DirectX::XMFLOAT4 tint;
+};
+
+struct DrawCommand {
+    uint32_t mesh = 0;
+    uint32_t firstInstance = 0; // into DrawList::instances
+    uint32_t instanceCount = 0;
+};
+
+struct DrawListInput {
+    uint32_t objectCount = 0;
+    const DirectX::XMFLOAT4X4* worlds = nullptr;
+    const DirectX::XMFLOAT4* tints = nullptr;
+    const uint32_t* meshes = nullptr;
+    uint32_t selectedObject = 0xFFFFFFFFu; // tinted red
+    uint32_t pivotObject = 0xFFFFFFFFu;    // tinted cyan
+};
+
+// The object draws of one frame, recorded without any graphics API so it can be built and inspected
+// headless. Engine::PopulateCommandList replays it onto the D3D12 command list.
+struct DrawList {
+    DrawSubmitMode mode = DrawSubmitMode::PerObject;
+    std::vector<InstanceData> instances; // in draw order: each command's instances are contiguous
+    std::vector<DrawCommand> draws;
+
+    void Clear() {
+        instances.clear();
+        draws.clear();
+    }
+
+    uint32_t DrawCallCount() const { return (uint32_t)draws.size(); }
+};
+
+// Rebuilds `out` for the given objects. Tints are final (selection/pivot overrides applied).
+// Instanced mode groups by mesh with a stable counting sort, so instances of a mesh keep object order.
+void BuildDrawList(DrawSubmitMode mode, const DrawListInput& input, DrawList& out);
+
+// Human-readable dump of the recorded commands (one line per draw).
+void WriteDrawList(const DrawList& list, FILE* out);
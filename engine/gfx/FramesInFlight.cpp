@@ -0,0 +1,38 @@
+#include "engine/gfx/FramesInFlight.h"
+#include "engine/gfx/GpuQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+void FramesInFlight::Initialize(IGpuQueue* queue, uint32_t frameCount) {
+    m_queue = queue;
+    m_frameCount = (std::min)((std::max)(frameCount, 1u), uint32_t(kMaxFrames)); //a copy: std::min binds references, and kMaxFrames has no definition
+    m_slot = m_frameCount - 1; //the first BeginFrame moves to slot 0
+    for (uint64_t& value : m_slotFenceValues) { value = 0; }
+    m_stallCount.store(0, std::memory_order_relaxed);
+    m_stallMs.store(0.0, std::memory_order_relaxed);
+}
+
+uint32_t FramesInFlight::BeginFrame() {
+    m_slot = (m_slot + 1) % m_frameCount;
+
+    uint64_t fenceValue = m_slotFenceValues[m_slot];
+    if (m_queue && fenceValue != 0 && m_queue->CompletedValue() < fenceValue) {
+        auto start = std::chrono::steady_clock::now();
+        m_queue->WaitForValue(fenceValue);
+        double waitedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_stallMs.store(m_stallMs.load(std::memory_order_relaxed) + waitedMs, std::memory_order_relaxed); //only this thread writes
+        m_stallCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return m_slot;
+}
+
+uint64_t FramesInFlight::EndFrame() {
+    if (!m_queue) { return 0; }
+    m_slotFenceValues[m_slot] = m_queue->Signal();
+    return m_slotFenceValues[m_slot];
+}
+
+void FramesInFlight::WaitForIdle() {
+    if (m_queue) { m_queue->WaitForIdle(); }
+}
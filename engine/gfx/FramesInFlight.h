@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+class IGpuQueue;
+
+// Paces the CPU against the GPU with a ring of frame slots. Every slot owns its per-frame resources
+// (command allocator, upload buffers) and remembers the fence value signaled after its last frame.
+// BeginFrame only waits when the GPU still uses the slot being reused, i.e. when the CPU is
+// FrameCount() frames ahead, so with 2 or 3 slots the CPU records while the GPU renders.
+class FramesInFlight {
+public:
+    static const uint32_t kMaxFrames = 3;
+
+    // frameCount is clamped to [1, kMaxFrames].
+    void Initialize(IGpuQueue* queue, uint32_t frameCount);
+
+    uint32_t FrameCount() const { return m_frameCount; }
+    uint32_t CurrentSlot() const { return m_slot; }
+    IGpuQueue* Queue() const { return m_queue; }
+
+    // Advances to the next slot and waits until the GPU has finished the frame that last used it.
+    // Returns the slot; its resources may be rewritten from here on.
+    uint32_t BeginFrame();
+    // Signals the queue after this frame's submissions and tags the slot with the fence value.
+    // Returns that value (0 without a queue).
+    uint64_t EndFrame();
+    // Waits for every slot.
+    void WaitForIdle();
+
+    // Frames where BeginFrame had to block, and the total time it blocked. Readable from any thread.
+    uint64_t StallCount() const { return m_stallCount.load(std::memory_order_relaxed); }
+    double StallMs() const { return m_stallMs.load(std::memory_order_relaxed); }
+
+private:
+    IGpuQueue* m_queue = nullptr;
+    uint32_t m_frameCount = 1;
+    uint32_t m_slot = 0;
+    uint64_t m_slotFenceValues[kMaxFrames] = {};
+    std::atomic<uint64_t> m_stallCount{ 0 };
+    std::atomic<double> m_stallMs{ 0.0 };
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// The part of a GPU queue that frame pacing needs: a monotonically increasing fence signaled on the
+// queue after previously submitted work. Implemented for D3D12 (D3D12GpuQueue) and by a CPU
+// simulation (SimulatedGpuQueue), so FramesInFlight can be exercised without a GPU.
+class IGpuQueue {
+public:
+    virtual ~IGpuQueue() = default;
+
+    // Queues a fence signal after everything submitted so far. Returns the value that will be signaled.
+    virtual uint64_t Signal() = 0;
+    // Last fence value the queue has reached.
+    virtual uint64_t CompletedValue() = 0;
+    // Blocks the calling thread until the fence has reached value.
+    virtual void WaitForValue(uint64_t value) = 0;
+
+    // Blocks until the queue is idle.
+    void WaitForIdle() { WaitForValue(Signal()); }
+};
@@ -3,6 +3,8 @@
 bool GraphicsDevice::CreateCommandQueue(ID3D12Device* device) {
     if (!device) { return false; }
 
+    m_device = device;
+
     D3D12_COMMAND_QUEUE_DESC desc = {};
     desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
     desc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
@@ -38,7 +40,7 @@ bool GraphicsDevice::CreateSwapChain(IDXGIFactory6* factory, HWND hwnd, uint32_t
 }
 
 bool GraphicsDevice::CreateRTVs(ID3D12Device* device, DXGI_FORMAT rtvFormat, uint32_t bufferCount) {
-    if (!device || !m_swapChain) { return false; }
+    if (!device || !m_swapChain || bufferCount > kMaxBackBuffers) { return false; }
 
     D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
     heapDesc.NumDescriptors = bufferCount;
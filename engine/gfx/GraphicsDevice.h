@@ -12,6 +12,8 @@
 
 class GraphicsDevice {
 public:
+    static const uint32_t kMaxBackBuffers = 3;
+
     ID3D12Device* Device() const { return m_device.Get(); }
     ID3D12CommandQueue* Queue() const { return m_queue.Get(); }
     IDXGISwapChain3* SwapChain() const { return m_swapChain.Get(); }
@@ -45,7 +47,7 @@ private:
     Microsoft::WRL::ComPtr<IDXGISwapChain3> m_swapChain;
 
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_renderTargets[2];
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_renderTargets[kMaxBackBuffers];
     uint32_t m_rtvDescriptorSize = 0;
 
     uint32_t m_frameIndex = 0;
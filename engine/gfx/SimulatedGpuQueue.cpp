@@ -0,0 +1,72 @@
+#include "engine/gfx/SimulatedGpuQueue.h"
+
+#include <chrono>
+
+SimulatedGpuQueue::SimulatedGpuQueue(double workMs) : m_workMs(workMs) {
+    m_thread = std::thread([this]() { Run(); });
+}
+
+SimulatedGpuQueue::~SimulatedGpuQueue() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void SimulatedGpuQueue::Submit(std::function<void()> work) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_packets.push_back(Packet{ std::move(work), 0 });
+    }
+    m_wake.notify_one();
+}
+
+uint64_t SimulatedGpuQueue::Signal() {
+    uint64_t value = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        value = ++m_nextValue;
+        m_packets.push_back(Packet{ nullptr, value });
+    }
+    m_wake.notify_one();
+    return value;
+}
+
+uint64_t SimulatedGpuQueue::CompletedValue() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_completedValue;
+}
+
+void SimulatedGpuQueue::WaitForValue(uint64_t value) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_completed.wait(lock, [this, value]() { return m_completedValue >= value; });
+}
+
+void SimulatedGpuQueue::Run() {
+    for (;;) {
+        Packet packet;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_quit || !m_packets.empty(); });
+            if (m_packets.empty()) { return; } //quit once drained
+
+            packet = std::move(m_packets.front());
+            m_packets.pop_front();
+        }
+
+        if (packet.fenceValue != 0) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_completedValue = packet.fenceValue;
+            }
+            m_completed.notify_all();
+            continue;
+        }
+
+        // The work reads its inputs at the end of the packet, the last moment a GPU could still read them.
+        if (m_workMs > 0.0) { std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(m_workMs)); }
+        if (packet.work) { packet.work(); }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "engine/gfx/GpuQueue.h"
+
+// CPU stand-in for a GPU queue. Submitted work runs in order on a worker thread, each packet taking at
+// least workMs, and a fence completes when the worker reaches it, so the "GPU" lags the CPU the way a
+// real one does. A packet that reads a per-frame buffer sees whatever the CPU wrote there by the time
+// it runs, which is how overwrites of in-flight data show up. No platform headers.
+class SimulatedGpuQueue : public IGpuQueue {
+public:
+    explicit SimulatedGpuQueue(double workMs = 0.0);
+    ~SimulatedGpuQueue() override;
+
+    SimulatedGpuQueue(const SimulatedGpuQueue&) = delete;
+    SimulatedGpuQueue& operator=(const SimulatedGpuQueue&) = delete;
+
+    void Submit(std::function<void()> work);
+
+    uint64_t Signal() override;
+    uint64_t CompletedValue() override;
+    void WaitForValue(uint64_t value) override;
+
+private:
+    struct Packet {
+        std::function<void()> work;
+        uint64_t fenceValue = 0; //0 = work packet
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_completed;
+    std::deque<Packet> m_packets;
+    uint64_t m_nextValue = 0;
+    uint64_t m_completedValue = 0;
+    bool m_quit = false;
+    double m_workMs = 0.0;
+    std::thread m_thread;
+
+    void Run();
+};
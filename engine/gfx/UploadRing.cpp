@@ -0,0 +1,86 @@
+#include "engine/gfx/UploadRing.h"
+
+#include <algorithm>
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void UploadRing::Initialize(uint8_t* memory, uint64_t capacity) {
+    m_memory = memory;
+    m_capacity = memory ? capacity : 0;
+    m_head = 0;
+    m_tail = 0;
+    m_used = 0;
+    m_frameBytes = 0;
+    m_frames.clear();
+    m_highWater = 0;
+    m_lastFrameBytes = 0;
+    m_peakFrameBytes = 0;
+    m_failedAllocations = 0;
+}
+
+UploadAllocation UploadRing::Allocate(uint64_t size, uint64_t alignment) {
+    if (size == 0) { return UploadAllocation{}; }
+    alignment = (std::max)(alignment, uint64_t(1));
+
+    // Nothing in use: start over at the front so the free space is one piece.
+    if (m_used == 0) {
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    // Free space is [head, capacity) + [0, tail) while head is at or past tail, else [head, tail).
+    // head == tail with bytes in use means the ring is full.
+    bool full = (m_used > 0 && m_head == m_tail);
+    uint64_t offset = AlignUp(m_head, alignment);
+    uint64_t consumed = 0;
+    if (full) {
+        offset = m_capacity; //fails below
+    } else if (m_head >= m_tail) {
+        if (offset + size <= m_capacity) {
+            consumed = offset + size - m_head;
+        } else if (size <= m_tail) {
+            consumed = (m_capacity - m_head) + size; //skip the end of the ring and wrap to 0
+            offset = 0;
+        } else {
+            offset = m_capacity;
+        }
+    } else if (offset + size <= m_tail) {
+        consumed = offset + size - m_head;
+    } else {
+        offset = m_capacity;
+    }
+
+    if (offset + size > m_capacity) {
+        m_failedAllocations++;
+        return UploadAllocation{};
+    }
+
+    m_head = offset + size;
+    m_used += consumed;
+    m_frameBytes += consumed;
+    m_highWater = (std::max)(m_highWater, m_used);
+
+    UploadAllocation allocation;
+    allocation.cpu = m_memory + offset;
+    allocation.offset = offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void UploadRing::EndFrame(uint64_t fenceValue) {
+    if (m_frameBytes > 0) { m_frames.push_back(Frame{ m_head, m_frameBytes, fenceValue }); }
+
+    m_lastFrameBytes = m_frameBytes;
+    m_peakFrameBytes = (std::max)(m_peakFrameBytes, m_frameBytes);
+    m_frameBytes = 0;
+}
+
+void UploadRing::Reclaim(uint64_t completedFenceValue) {
+    while (!m_frames.empty() && m_frames.front().fenceValue <= completedFenceValue) {
+        m_tail = m_frames.front().end;
+        m_used -= m_frames.front().bytes;
+        m_frames.pop_front();
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+// One suballocation of an UploadRing. offset is from the start of the ring's memory, so a GPU address
+// is the backing buffer's base address + offset.
+struct UploadAllocation {
+    uint8_t* cpu = nullptr;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+
+    bool Valid() const { return cpu != nullptr; }
+};
+
+// Linear ring allocator for per-frame transient data over one persistently mapped block of memory
+// (an upload heap buffer, or plain CPU memory). Allocations are handed out back to back and never
+// freed one by one: EndFrame tags everything allocated since the previous EndFrame with the fence
+// value of that frame, and Reclaim frees whole frames once their fence value has completed.
+// Only offsets are managed here; no graphics API, so the logic runs anywhere.
+class UploadRing {
+public:
+    void Initialize(uint8_t* memory, uint64_t capacity);
+
+    // Returns an invalid allocation if the space not yet reclaimed leaves no room (or size is 0).
+    // alignment must be a power of two.
+    UploadAllocation Allocate(uint64_t size, uint64_t alignment);
+
+    void EndFrame(uint64_t fenceValue);
+    void Reclaim(uint64_t completedFenceValue);
+
+    uint64_t Capacity() const { return m_capacity; }
+    // Bytes held by frames not reclaimed yet, including the current one (alignment and wrap padding counted).
+    uint64_t UsedBytes() const { return m_used; }
+    uint64_t HighWaterBytes() const { return m_highWater; }
+    // Bytes the last ended frame took, and the most any frame took.
+    uint64_t LastFrameBytes() const { return m_lastFrameBytes; }
+    uint64_t PeakFrameBytes() const { return m_peakFrameBytes; }
+    uint64_t FailedAllocations() const { return m_failedAllocations; }
+
+private:
+    struct Frame {
+        uint64_t end = 0;   // m_head after the frame's last allocation
+        uint64_t bytes = 0;
+        uint64_t fenceValue = 0;
+    };
+
+    uint8_t* m_memory = nullptr;
+    uint64_t m_capacity = 0;
+    uint64_t m_head = 0; // next free byte
+    uint64_t m_tail = 0; // first byte still in use
+    uint64_t m_used = 0;
+    uint64_t m_frameBytes = 0;
+    std::deque<Frame> m_frames;
+
+    uint64_t m_highWater = 0;
+    uint64_t m_lastFrameBytes = 0;
+    uint64_t m_peakFrameBytes = 0;
+    uint64_t m_failedAllocations = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Shared by the replay benchmarks.
+
+inline double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Times fn `rounds` times; returns the fastest and the median run in ms, or false if a run failed.
+template <typename Fn>
+bool TimeRounds(uint32_t rounds, Fn fn, double& minMs, double& medianMs) {
+    std::vector<double> ms;
+    for (uint32_t i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (!fn()) { return false; }
+        ms.push_back(MsSince(start));
+    }
+    std::sort(ms.begin(), ms.end());
+    minMs = ms.front();
+    medianMs = ms[ms.size() / 2];
+    return true;
+}
+
+// xorshift32, the generator of WriteSyntheticReplayScript: <random> distributions differ between
+// standard libraries, this does not, so runs are comparable across machines.
+struct BenchRandom {
+    uint32_t state = 1u;
+
+    explicit BenchRandom(uint32_t seed = 1u) : state(seed ? seed : 1u) {}
+
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    float Range(float lo, float hi) { return lo + (hi - lo) * float(Next() >> 8) * (1.0f / 16777216.0f); }
+};
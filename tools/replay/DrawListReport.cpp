@@ -0,0 +1,62 @@
+#include "tools/replay/DrawListReport.h"
+#include "editor/SceneDocument.h"
+#include "engine/gfx/DrawList.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+bool SameInstance(const InstanceData& a, const InstanceData& b) {
+    return std::memcmp(&a, &b, sizeof(InstanceData)) == 0;
+}
+
+} // namespace
+
+int RunDrawListReport(FILE* out, const wchar_t* scenePath) {
+    SceneDocument document;
+    bool loaded = SceneDocument::IsBinaryScenePath(scenePath) ? document.LoadSceneBinary(scenePath) : document.LoadSceneAem(scenePath);
+    if (!loaded) {
+        std::fprintf(out, "cannot load the scene: %s\n", document.LastLoadError().c_str());
+        return 1;
+    }
+
+    // The same arrays App::Update hands the engine, without the orbit pivot marker.
+    const Scene& scene = document.GetScene();
+    uint32_t count = scene.Count();
+    std::vector<DirectX::XMFLOAT4X4> worlds(count);
+    for (uint32_t i = 0; i < count; ++i) { worlds[i] = scene.World(i); }
+
+    DrawListInput input;
+    input.objectCount = count;
+    input.worlds = worlds.data();
+    input.tints = scene.Colors().data();
+    input.meshes = scene.Meshes().data();
+    input.selectedObject = scene.IndexOf(document.ActiveObject());
+
+    DrawList perObject, instanced;
+    BuildDrawList(DrawSubmitMode::PerObject, input, perObject);
+    BuildDrawList(DrawSubmitMode::Instanced, input, instanced);
+    WriteDrawList(perObject, out);
+    WriteDrawList(instanced, out);
+
+    // Per object, draw i is object i. Instanced, each mesh's draw lists its objects in order.
+    uint32_t mismatches = 0;
+    if (perObject.DrawCallCount() != count || perObject.instances.size() != count || instanced.instances.size() != count) { mismatches++; }
+    std::vector<uint32_t> cursor(instanced.draws.size(), 0);
+    for (uint32_t i = 0; i < count && mismatches == 0; ++i) {
+        uint32_t d = 0;
+        while (d < instanced.draws.size() && instanced.draws[d].mesh != scene.Mesh(i)) { ++d; }
+        if (d == instanced.draws.size() || cursor[d] >= instanced.draws[d].instanceCount) { mismatches++; break; }
+
+        const InstanceData& expected = perObject.instances[i];
+        if (perObject.draws[i].mesh != scene.Mesh(i) || perObject.draws[i].firstInstance != i ||
+            !SameInstance(instanced.instances[instanced.draws[d].firstInstance + cursor[d]++], expected)) {
+            std::fprintf(out, "  MISMATCH object %u\n", i);
+            mismatches++;
+        }
+    }
+
+    std::fprintf(out, "%u objects: %u draws per object, %u instanced, %u mismatches\n", count, perObject.DrawCallCount(), instanced.DrawCallCount(), mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdio>
+
+// Loads a scene (.aem or .aeb) and records its object draws with BuildDrawList the way Engine does,
+// once per object and once instanced, then writes both with WriteDrawList. Checks that the instanced
+// list holds every object's world and tint exactly once, grouped by mesh in object order. Returns a
+// process exit code.
+int RunDrawListReport(FILE* out, const wchar_t* scenePath);
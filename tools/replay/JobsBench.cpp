@@ -0,0 +1,232 @@
+#include "tools/replay/JobsBench.h"
+#include "tools/replay/BenchUtil.h"
+#include "editor/Scene.h"
+#include "engine/core/JobSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint32_t kThreadCounts[] = { 1, 2, 4, 8 };
+
+// Every index in [0, count) visited once, through chunks that stay inside the range.
+bool CheckParallelFor(FILE* out, JobSystem& jobs, uint32_t count, uint32_t grainSize) {
+    std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[count + 1]);
+    for (uint32_t i = 0; i <= count; ++i) { visits[i].store(0); }
+    std::atomic<uint32_t> badChunks{ 0 };
+
+    jobs.ParallelFor(count, grainSize, [&](uint32_t begin, uint32_t end) {
+        if (begin >= end || end > count) { badChunks++; return; }
+        for (uint32_t i = begin; i < end; ++i) { visits[i].fetch_add(1, std::memory_order_relaxed); }
+    });
+
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (visits[i].load() != 1) { wrong++; }
+    }
+    if (wrong || badChunks) {
+        std::fprintf(out, "  FAIL ParallelFor(%u, grain %u): %u indices not visited once, %u bad chunks\n", count, grainSize, wrong, badChunks.load());
+        return false;
+    }
+    return true;
+}
+
+// Each ParallelFor chunk runs a few jobs on its own counter and waits for them, and one of those jobs
+// runs a ParallelFor of its own: waiting threads must keep executing jobs or this deadlocks.
+bool CheckNested(FILE* out, JobSystem& jobs) {
+    const uint32_t outer = 64, inner = 8, innermost = 32;
+    std::vector<std::atomic<uint32_t>> hits(outer * inner);
+    for (auto& hit : hits) { hit.store(0); }
+    std::atomic<uint32_t> innermostVisits{ 0 };
+    std::atomic<uint32_t> earlyWaits{ 0 };
+
+    jobs.ParallelFor(outer, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t o = begin; o < end; ++o) {
+            JobCounter counter;
+            for (uint32_t i = 0; i < inner; ++i) {
+                jobs.Run(counter, [&, o, i]() {
+                    hits[o * inner + i].fetch_add(1);
+                    if (i == 0) {
+                        jobs.ParallelFor(innermost, 4, [&](uint32_t b, uint32_t e) { innermostVisits.fetch_add(e - b); });
+                    }
+                });
+            }
+            jobs.Wait(counter);
+            for (uint32_t i = 0; i < inner; ++i) {
+                if (hits[o * inner + i].load() != 1) { earlyWaits++; } //Wait returned before its jobs finished
+            }
+        }
+    });
+
+    uint32_t wrong = 0;
+    for (auto& hit : hits) {
+        if (hit.load() != 1) { wrong++; }
+    }
+    if (wrong || earlyWaits || innermostVisits.load() != outer * innermost) {
+        std::fprintf(out, "  FAIL nested Run/Wait: %u jobs wrong, %u early waits, %u of %u innermost items\n",
+            wrong, earlyWaits.load(), innermostVisits.load(), outer * innermost);
+        return false;
+    }
+    return true;
+}
+
+// A binary tree of jobs on one counter: each job adds its children before it finishes, so the count
+// never reaches zero early.
+void SpawnTree(JobSystem& jobs, JobCounter& counter, std::atomic<uint32_t>& ran, uint32_t depth) {
+    ran.fetch_add(1);
+    if (depth == 0) { return; }
+    for (int child = 0; child < 2; ++child) {
+        jobs.Run(counter, [&jobs, &counter, &ran, depth]() { SpawnTree(jobs, counter, ran, depth - 1); });
+    }
+}
+
+bool CheckJobTree(FILE* out, JobSystem& jobs) {
+    const uint32_t depth = 10;
+    JobCounter counter;
+    std::atomic<uint32_t> ran{ 0 };
+    jobs.Run(counter, [&]() { SpawnTree(jobs, counter, ran, depth); });
+    jobs.Wait(counter);
+    uint32_t expected = (1u << (depth + 1)) - 1;
+    if (ran.load() != expected) {
+        std::fprintf(out, "  FAIL job tree: %u of %u jobs ran before Wait returned\n", ran.load(), expected);
+        return false;
+    }
+    return true;
+}
+
+// The debugging guarantee of one thread: jobs run on the caller, in submission order.
+bool CheckSingleThreadOrder(FILE* out, JobSystem& jobs) {
+    std::vector<uint32_t> order;
+    std::thread::id caller = std::this_thread::get_id();
+    bool otherThread = false;
+    JobCounter counter;
+    for (uint32_t i = 0; i < 100; ++i) {
+        jobs.Run(counter, [&, i]() {
+            order.push_back(i);
+            if (std::this_thread::get_id() != caller) { otherThread = true; }
+        });
+    }
+    jobs.Wait(counter);
+    for (uint32_t i = 0; i < (uint32_t)order.size(); ++i) {
+        if (order[i] != i) { otherThread = true; }
+    }
+    if (order.size() != 100 || otherThread) {
+        std::fprintf(out, "  FAIL single thread: jobs ran out of order or off the calling thread\n");
+        return false;
+    }
+    return true;
+}
+
+// Enough arithmetic per item that the loop is compute bound.
+float Work(uint32_t i) {
+    float x = float(i) * 1e-3f;
+    for (int k = 0; k < 16; ++k) { x = std::sqrt(x * x + 1.0f) - 0.5f * x; }
+    return x;
+}
+
+} // namespace
+
+int RunJobsBench(FILE* out, uint32_t itemCount, uint32_t rounds) {
+    itemCount = (std::max)(itemCount, 1u);
+    rounds = (std::max)(rounds, 1u);
+    uint32_t failures = 0;
+
+    // Tests.
+    const uint32_t counts[] = { 0, 1, 7, 64, 1000, 100003 };
+    const uint32_t grains[] = { 1, 16, 1000 };
+    for (uint32_t threads : kThreadCounts) {
+        JobSystem jobs;
+        jobs.Initialize(threads);
+        uint32_t before = failures;
+        for (uint32_t count : counts) {
+            for (uint32_t grain : grains) {
+                if (!CheckParallelFor(out, jobs, count, grain)) { failures++; }
+            }
+        }
+        if (!CheckNested(out, jobs)) { failures++; }
+        if (!CheckJobTree(out, jobs)) { failures++; }
+        if (threads == 1 && !CheckSingleThreadOrder(out, jobs)) { failures++; }
+        std::fprintf(out, "%u thread%s: %s (%llu jobs, %llu stolen)\n", threads, threads == 1 ? "" : "s",
+            failures == before ? "ok" : "FAILED", (unsigned long long)jobs.JobCount(), (unsigned long long)jobs.StealCount());
+    }
+
+    // Re-initializing with another thread count must leave a working system.
+    {
+        JobSystem jobs;
+        jobs.Initialize(8);
+        jobs.Initialize(2);
+        if (!CheckParallelFor(out, jobs, 5000, 16)) { failures++; }
+    }
+
+    // Scaling.
+    std::vector<float> results(itemCount);
+    Scene scene;
+    const uint32_t objectCount = 100000;
+    BenchRandom random;
+    scene.Reserve(objectCount);
+    std::vector<uint32_t> parents(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        ObjectTransform transform;
+        transform.pos = DirectX::XMFLOAT3(random.Range(-5.0f, 5.0f), random.Range(-5.0f, 5.0f), random.Range(-5.0f, 5.0f));
+        transform.rot = DirectX::XMFLOAT3(random.Range(-3.0f, 3.0f), 0.0f, 0.0f);
+        scene.Add(transform, DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+        parents[i] = (i % 100 == 0) ? Scene::kInvalidIndex : random.Next() % i;
+    }
+    scene.SetParents(parents.data());
+
+    std::fprintf(out, "hardware threads: %u\n", std::thread::hardware_concurrency());
+    std::fprintf(out, "%-8s %16s %8s %16s %8s %14s\n", "threads", "ParallelFor ms", "speedup", "100k worlds ms", "speedup", "ns per job");
+    double baseFor = 0.0, baseWorlds = 0.0;
+    for (uint32_t threads : kThreadCounts) {
+        JobSystem jobs;
+        jobs.Initialize(threads);
+
+        double forMin = 0.0, forMedian = 0.0;
+        TimeRounds(rounds, [&]() {
+            jobs.ParallelFor(itemCount, 1024, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) { results[i] = Work(i); }
+            });
+            return true;
+        }, forMin, forMedian);
+
+        // Only the update is timed, not flagging every object.
+        double worldsMin = 0.0;
+        for (uint32_t round = 0; round < rounds; ++round) {
+            for (uint32_t i = 0; i < objectCount; ++i) { scene.SetTransform(i, scene.Transform(i)); }
+            auto start = std::chrono::steady_clock::now();
+            if (scene.UpdateWorldMatrices(&jobs) != objectCount) { failures++; }
+            double ms = MsSince(start);
+            worldsMin = round ? (std::min)(worldsMin, ms) : ms;
+        }
+
+        // Empty jobs: the cost of Run, Wait and a steal, not of any work.
+        const uint32_t emptyJobs = 100000;
+        JobCounter counter;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < emptyJobs; ++i) { jobs.Run(counter, []() {}); }
+        jobs.Wait(counter);
+        double emptyMs = MsSince(start);
+
+        if (threads == 1) { baseFor = forMin; baseWorlds = worldsMin; }
+        std::fprintf(out, "%-8u %16.2f %7.2fx %16.2f %7.2fx %14.1f\n", threads, forMin, baseFor / forMin,
+            worldsMin, baseWorlds / worldsMin, emptyMs * 1.0e6 / emptyJobs);
+    }
+
+    // Every item written by whichever thread ran it, with the same value.
+    uint32_t wrongResults = 0;
+    for (uint32_t i = 0; i < itemCount; i += 97) {
+        if (results[i] != Work(i)) { wrongResults++; }
+    }
+    if (wrongResults) {
+        std::fprintf(out, "  FAIL: %u ParallelFor results differ\n", wrongResults);
+        failures++;
+    }
+
+    std::fprintf(out, "%u failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
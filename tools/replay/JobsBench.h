@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+// JobSystem test and scaling benchmark, run at 1, 2, 4 and 8 threads. Checks that ParallelFor covers
+// every index exactly once for a range of counts and grain sizes, that Run/Wait nested inside
+// ParallelFor chunks (and ParallelFor inside jobs) completes every job, that jobs may add jobs to the
+// counter being waited on, and that one thread runs jobs in submission order. Then times a ParallelFor
+// over itemCount items, world matrix updates of a 100k-object scene and the cost of an empty job, best
+// of `rounds`, with the speed-up over one thread. Returns a process exit code.
+int RunJobsBench(FILE* out, uint32_t itemCount, uint32_t rounds);
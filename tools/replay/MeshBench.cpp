@@ -0,0 +1,535 @@
+#include "tools/replay/MeshBench.h"
+#include "tools/replay/BenchUtil.h"
+#include "editor/EditorCamera.h"
+#include "editor/modes/modeling/EditableMesh.h"
+#include "editor/modes/modeling/MeshBVH.h"
+#include "editor/modes/modeling/RayTriangleBatch.h"
+#include "editor/modes/modeling/VertexPickGrid.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+using DirectX::XMFLOAT3;
+
+namespace {
+
+struct BenchRay {
+    XMFLOAT3 origin;
+    XMFLOAT3 dir;
+};
+
+// Small triangles scattered through [-1, 1]^3, every vertex its own. One in 64 is collapsed to a line,
+// which the kernels must reject like the scalar test does.
+void BuildRandomTriangles(EditableMesh& mesh, uint32_t triangleCount, BenchRandom& random) {
+    mesh.Clear();
+    mesh.Reserve(triangleCount * 3, triangleCount);
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        XMFLOAT3 a(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f));
+        XMFLOAT3 b(a.x + random.Range(-0.2f, 0.2f), a.y + random.Range(-0.2f, 0.2f), a.z + random.Range(-0.2f, 0.2f));
+        XMFLOAT3 c(a.x + random.Range(-0.2f, 0.2f), a.y + random.Range(-0.2f, 0.2f), a.z + random.Range(-0.2f, 0.2f));
+        if (t % 64 == 63) { c = XMFLOAT3((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f); }
+        VertexID v = mesh.AddVertex(a);
+        mesh.AddVertex(b);
+        mesh.AddVertex(c);
+        mesh.AddTriangle(v, v + 1, v + 2);
+    }
+}
+
+// From outside the box towards a random triangle's corner, so small meshes get hits too; directions
+// are left unnormalized, as picking makes them.
+BenchRay RandomRay(const EditableMesh& mesh, BenchRandom& random) {
+    BenchRay ray;
+    ray.origin = XMFLOAT3(random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f), random.Range(2.0f, 4.0f));
+    if (random.Next() & 1) { ray.origin.z = -ray.origin.z; }
+    const XMFLOAT3& corner = mesh.positions[random.Next() % mesh.vertexCount];
+    XMFLOAT3 target(corner.x + random.Range(-0.1f, 0.1f), corner.y + random.Range(-0.1f, 0.1f), corner.z + random.Range(-0.1f, 0.1f));
+    ray.dir = XMFLOAT3(target.x - ray.origin.x, target.y - ray.origin.y, target.z - ray.origin.z);
+    return ray;
+}
+
+// The reference: RayIntersectsTriangle over slots [first, first + slotCount), closest hit, ties to the
+// lowest slot.
+bool ScalarClosest(const EditableMesh& mesh, const TriangleBatch& batch, uint32_t first, uint32_t slotCount, const BenchRay& ray, float& bestT, uint32_t& bestSlot) {
+    bool hit = false;
+    for (uint32_t slot = first; slot < first + slotCount; ++slot) {
+        const EditTriangle& tri = mesh.triangles[batch.ids[slot]];
+        float t = 0.0f;
+        if (RayIntersectsTriangle(ray.origin, ray.dir, mesh.positions[tri.a], mesh.positions[tri.b], mesh.positions[tri.c], t) && t < bestT) {
+            bestT = t;
+            bestSlot = slot;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+// Rows of quads over [-1, 1]^2 with a bump in z, so rays from above always hit.
+void BuildBumpyGrid(EditableMesh& mesh, uint32_t cells) {
+    mesh.Clear();
+    mesh.Reserve((cells + 1) * (cells + 1), cells * cells * 2);
+    for (uint32_t y = 0; y <= cells; ++y) {
+        for (uint32_t x = 0; x <= cells; ++x) {
+            float fx = float(x) / cells * 2.0f - 1.0f;
+            float fy = float(y) / cells * 2.0f - 1.0f;
+            mesh.AddVertex(XMFLOAT3(fx, fy, 0.1f * std::sin(fx * 9.0f) * std::cos(fy * 7.0f)));
+        }
+    }
+    for (uint32_t y = 0; y < cells; ++y) {
+        for (uint32_t x = 0; x < cells; ++x) {
+            VertexID v = y * (cells + 1) + x;
+            mesh.AddTriangle(v, v + 1, v + cells + 1);
+            mesh.AddTriangle(v + 1, v + cells + 2, v + cells + 1);
+        }
+    }
+}
+
+// Triangles along 14 directions from the origin, each run 6 times farther out than the one before.
+// Binned SAH peels the far ones off a few at a time, which nests this mesh 47 levels deep without
+// the median splits past kMedianSplitDepth (see MeshBVH.cpp). Within 1e12, so the ray/triangle
+// products stay finite.
+void BuildDeepSpikes(EditableMesh& mesh) {
+    static const float kDirections[14][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 },
+        { 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { 1, -1, -1 }, { -1, 1, 1 }, { -1, 1, -1 }, { -1, -1, 1 }, { -1, -1, -1 }
+    };
+    mesh.Clear();
+    for (const float* dir : kDirections) {
+        for (float d = 1e-10f; d < 1e12f; d *= 6.0f) {
+            XMFLOAT3 a(dir[0] * d, dir[1] * d, dir[2] * d);
+            VertexID v = mesh.AddVertex(a);
+            mesh.AddVertex(XMFLOAT3(a.x + 0.05f * d, a.y, a.z));
+            mesh.AddVertex(XMFLOAT3(a.x, a.y + 0.05f * d, a.z + 0.05f * d));
+            mesh.AddTriangle(v, v + 1, v + 2);
+        }
+    }
+}
+
+bool BruteForceClosest(const EditableMesh& mesh, const BenchRay& ray, TriangleID& outTriangle, float& outT) {
+    outT = FLT_MAX;
+    outTriangle = kInvalidTriangleID;
+    for (uint32_t i = 0; i < mesh.triangleCount; ++i) {
+        const EditTriangle& tri = mesh.triangles[i];
+        float t = 0.0f;
+        if (RayIntersectsTriangle(ray.origin, ray.dir, mesh.positions[tri.a], mesh.positions[tri.b], mesh.positions[tri.c], t) && t < outT) {
+            outT = t;
+            outTriangle = i;
+        }
+    }
+    return outTriangle != kInvalidTriangleID;
+}
+
+// Equal t on different triangles is a ray through a shared edge or vertex: either answer is right.
+bool SamePick(TriangleID triangle, float t, TriangleID refTriangle, float refT) {
+    if (triangle == kInvalidTriangleID || refTriangle == kInvalidTriangleID) { return triangle == refTriangle; }
+    return triangle == refTriangle || std::fabs(t - refT) <= 1e-6f * (std::max)(std::fabs(refT), 1.0f);
+}
+
+struct ScreenVertex {
+    float x;
+    float y;
+    float depth;
+    bool visible;
+};
+
+// Projects like VertexPickGrid::Rebuild: one world * viewProj matrix, row vectors.
+std::vector<ScreenVertex> ProjectVertices(const EditableMesh& mesh, const DirectX::XMFLOAT4X4& world, const DirectX::XMFLOAT4X4& viewProj, float width, float height) {
+    DirectX::XMFLOAT4X4 mvp;
+    DirectX::XMStoreFloat4x4(&mvp, DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&world), DirectX::XMLoadFloat4x4(&viewProj)));
+
+    std::vector<ScreenVertex> screen(mesh.vertexCount);
+    for (uint32_t i = 0; i < mesh.vertexCount; ++i) {
+        const XMFLOAT3& p = mesh.positions[i];
+        float cx = p.x * mvp.m[0][0] + p.y * mvp.m[1][0] + p.z * mvp.m[2][0] + mvp.m[3][0];
+        float cy = p.x * mvp.m[0][1] + p.y * mvp.m[1][1] + p.z * mvp.m[2][1] + mvp.m[3][1];
+        float cz = p.x * mvp.m[0][2] + p.y * mvp.m[1][2] + p.z * mvp.m[2][2] + mvp.m[3][2];
+        float cw = p.x * mvp.m[0][3] + p.y * mvp.m[1][3] + p.z * mvp.m[2][3] + mvp.m[3][3];
+        screen[i].visible = cw >= 1e-6f;
+        screen[i].x = (cx / cw * 0.5f + 0.5f) * width;
+        screen[i].y = (-cy / cw * 0.5f + 0.5f) * height;
+        screen[i].depth = cz / cw;
+    }
+    return screen;
+}
+
+// The reference pick: every vertex, nearest on screen within the radius, ties to the nearest depth.
+int ScanPick(const std::vector<ScreenVertex>& screen, float x, float y, float radiusPx, float& outDistSq) {
+    const float tieEpsilonSq = 1e-4f;
+    float bestDistSq = 1.0e30f;
+    float bestDepth = 1.0e30f;
+    int best = -1;
+    for (uint32_t i = 0; i < (uint32_t)screen.size(); ++i) {
+        const ScreenVertex& v = screen[i];
+        if (!v.visible) { continue; }
+        float dx = v.x - x;
+        float dy = v.y - y;
+        float distSq = dx * dx + dy * dy;
+        if (distSq > radiusPx * radiusPx) { continue; }
+
+        bool closer = distSq < bestDistSq - tieEpsilonSq;
+        bool tie = !closer && distSq <= bestDistSq + tieEpsilonSq;
+        if (closer || (tie && (v.depth < bestDepth || (v.depth == bestDepth && int(i) < best)))) {
+            bestDistSq = distSq;
+            bestDepth = v.depth;
+            best = int(i);
+        }
+    }
+    outDistSq = bestDistSq;
+    return best;
+}
+
+bool SameHit(float t, uint32_t slot, float refT, uint32_t refSlot) {
+    if (slot != refSlot) { return false; }
+    return refSlot == 0xFFFFFFFFu || std::fabs(t - refT) <= 1e-6f * (std::max)(std::fabs(refT), 1.0f);
+}
+
+} // namespace
+
+int RunRayTriangleBench(FILE* out, uint32_t triangleCount, uint32_t rayCount) {
+    triangleCount = (std::max)(triangleCount, 1u);
+    rayCount = (std::max)(rayCount, 1u);
+
+    BenchRandom random;
+    EditableMesh mesh;
+    BuildRandomTriangles(mesh, triangleCount, random);
+
+    std::vector<uint32_t> order(triangleCount);
+    for (uint32_t i = 0; i < triangleCount; ++i) { order[i] = i; }
+    for (uint32_t i = triangleCount - 1; i > 0; --i) { std::swap(order[i], order[random.Next() % (i + 1)]); }
+    TriangleBatch batch;
+    batch.Build(mesh, order.data());
+
+    std::vector<BenchRay> rays(rayCount);
+    for (BenchRay& ray : rays) { ray = RandomRay(mesh, random); }
+
+    std::fprintf(out, "%u triangles, %u rays, %d lanes\n", triangleCount, rayCount, AE_RAYTRI_LANES);
+
+    // Whole batch, then ranges of up to 16 slots from any start, the way leaves sit in a BVH's batch.
+    uint32_t checks = 0, mismatches = 0, hits = 0;
+    auto check = [&](uint32_t first, uint32_t slotCount, const BenchRay& ray) {
+        float refT = FLT_MAX, t = FLT_MAX;
+        uint32_t refSlot = 0xFFFFFFFFu, slot = 0xFFFFFFFFu;
+        ScalarClosest(mesh, batch, first, slotCount, ray, refT, refSlot);
+        IntersectRayBatch(batch, first, slotCount, ray.origin, ray.dir, t, slot);
+        checks++;
+        if (refSlot != 0xFFFFFFFFu) { hits++; }
+        if (!SameHit(t, slot, refT, refSlot)) {
+            if (mismatches++ < 5) {
+                std::fprintf(out, "  MISMATCH [%u, +%u): slot %u t %.9g, reference slot %u t %.9g\n", first, slotCount, slot, t, refSlot, refT);
+            }
+        }
+    };
+    for (const BenchRay& ray : rays) {
+        check(0, triangleCount, ray);
+        for (uint32_t k = 0; k < 16; ++k) {
+            uint32_t first = (k < 8) ? triangleCount - 1 - (std::min)(k, triangleCount - 1) : random.Next() % triangleCount;
+            uint32_t slotCount = 1 + random.Next() % 16;
+            check(first, (std::min)(slotCount, triangleCount - first), ray);
+        }
+    }
+
+    // Packets: every ray's result must equal its single-ray result.
+    for (uint32_t r = 0; r < rayCount; r += RayPacket::kMaxRays) {
+        RayPacket packet;
+        packet.ResetHits();
+        for (uint32_t i = r; i < rayCount && i < r + RayPacket::kMaxRays; ++i) { packet.Add(rays[i].origin, rays[i].dir); }
+        IntersectPacketBatch(batch, 0, triangleCount, packet);
+        for (uint32_t i = 0; i < packet.count; ++i) {
+            float refT = FLT_MAX;
+            uint32_t refSlot = 0xFFFFFFFFu;
+            ScalarClosest(mesh, batch, 0, triangleCount, rays[r + i], refT, refSlot);
+            checks++;
+            if (!SameHit(packet.bestT[i], packet.bestSlot[i], refT, refSlot)) {
+                if (mismatches++ < 5) {
+                    std::fprintf(out, "  MISMATCH packet ray %u: slot %u t %.9g, reference slot %u t %.9g\n", r + i, packet.bestSlot[i], packet.bestT[i], refSlot, refT);
+                }
+            }
+        }
+    }
+    std::fprintf(out, "checks: %u ranges and packet rays (%u with a hit), %u mismatches\n", checks, hits, mismatches);
+
+    // Throughput over the whole batch, fastest of 3. The scalar loop walks the mesh in its own order, so
+    // it is not charged for the batch's shuffled slots.
+    const double tests = double(triangleCount) * rayCount;
+    uint32_t sink = 0;
+    double scalarMin = 0.0, scalarMedian = 0.0, batchMin = 0.0, batchMedian = 0.0, packetMin = 0.0, packetMedian = 0.0;
+    TimeRounds(3, [&]() {
+        for (const BenchRay& ray : rays) {
+            float bestT = FLT_MAX;
+            uint32_t best = 0xFFFFFFFFu;
+            for (uint32_t i = 0; i < triangleCount; ++i) {
+                const EditTriangle& tri = mesh.triangles[i];
+                float t = 0.0f;
+                if (RayIntersectsTriangle(ray.origin, ray.dir, mesh.positions[tri.a], mesh.positions[tri.b], mesh.positions[tri.c], t) && t < bestT) {
+                    bestT = t;
+                    best = i;
+                }
+            }
+            sink += best;
+        }
+        return true;
+    }, scalarMin, scalarMedian);
+    TimeRounds(3, [&]() {
+        for (const BenchRay& ray : rays) {
+            float t = FLT_MAX;
+            uint32_t slot = 0xFFFFFFFFu;
+            IntersectRayBatch(batch, 0, triangleCount, ray.origin, ray.dir, t, slot);
+            sink += slot;
+        }
+        return true;
+    }, batchMin, batchMedian);
+    TimeRounds(3, [&]() {
+        for (uint32_t r = 0; r < rayCount; r += RayPacket::kMaxRays) {
+            RayPacket packet;
+            packet.ResetHits();
+            for (uint32_t i = r; i < rayCount && i < r + RayPacket::kMaxRays; ++i) { packet.Add(rays[i].origin, rays[i].dir); }
+            IntersectPacketBatch(batch, 0, triangleCount, packet);
+            sink += packet.bestSlot[0];
+        }
+        return true;
+    }, packetMin, packetMedian);
+
+    scalarMin = (std::max)(scalarMin, 1e-6);
+    batchMin = (std::max)(batchMin, 1e-6);
+    packetMin = (std::max)(packetMin, 1e-6);
+    std::fprintf(out, "%-28s %12s %14s\n", "kernel", "ms", "Mtri/s");
+    std::fprintf(out, "%-28s %12.3f %14.1f\n", "scalar RayIntersectsTriangle", scalarMin, tests / (scalarMin * 1000.0));
+    std::fprintf(out, "%-28s %12.3f %14.1f\n", "IntersectRayBatch", batchMin, tests / (batchMin * 1000.0));
+    std::fprintf(out, "%-28s %12.3f %14.1f\n", "IntersectPacketBatch (16)", packetMin, tests / (packetMin * 1000.0));
+    std::fprintf(out, "batch speedup %.2fx, packet %.2fx (checksum %u)\n", scalarMin / batchMin, scalarMin / packetMin, sink);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int RunMeshBVHBench(FILE* out, uint32_t triangleCount, uint32_t rayCount) {
+    rayCount = (std::max)(rayCount, 1u);
+    uint32_t cells = (std::max)((uint32_t)std::sqrt(double(triangleCount) / 2.0), 1u);
+
+    BenchRandom random;
+    EditableMesh mesh;
+    BuildBumpyGrid(mesh, cells);
+
+    MeshBVH bvh;
+    auto start = std::chrono::steady_clock::now();
+    bvh.Build(mesh);
+    double buildMs = MsSince(start);
+    std::fprintf(out, "%u triangles: build %.1f ms, %u nodes, depth %u\n", mesh.triangleCount, buildMs, bvh.NodeCount(), bvh.Depth());
+
+    std::vector<BenchRay> rays(rayCount);
+    for (BenchRay& ray : rays) {
+        ray.origin = XMFLOAT3(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), 2.0f);
+        ray.dir = XMFLOAT3(random.Range(-0.2f, 0.2f), random.Range(-0.2f, 0.2f), -1.0f);
+    }
+
+    // Brute force costs a full pass over the mesh per ray, so at most 64 rays are checked that way.
+    uint32_t mismatches = 0;
+    auto report = [&](const char* what, uint32_t ray, TriangleID triangle, float t, TriangleID refTriangle, float refT) {
+        if (mismatches++ < 5) { std::fprintf(out, "  MISMATCH %s ray %u: triangle %u t %.9g, reference %u t %.9g\n", what, ray, triangle, t, refTriangle, refT); }
+    };
+    const uint32_t bruteRays = (std::min)(rayCount, 64u);
+    double bruteMs = 0.0;
+    for (uint32_t r = 0; r < bruteRays; ++r) {
+        TriangleID refTriangle = kInvalidTriangleID, triangle = kInvalidTriangleID;
+        float refT = 0.0f, t = 0.0f;
+        start = std::chrono::steady_clock::now();
+        BruteForceClosest(mesh, rays[r], refTriangle, refT);
+        bruteMs += MsSince(start);
+        bvh.Raycast(mesh, rays[r].origin, rays[r].dir, triangle, t);
+        if (!SamePick(triangle, t, refTriangle, refT)) { report("raycast", r, triangle, t, refTriangle, refT); }
+    }
+
+    // Every ray through the BVH, singly and in packets of 16.
+    std::vector<TriangleID> picked(rayCount, kInvalidTriangleID);
+    std::vector<float> pickedT(rayCount, 0.0f);
+    uint32_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rayCount; ++r) {
+        if (bvh.Raycast(mesh, rays[r].origin, rays[r].dir, picked[r], pickedT[r])) { hits++; }
+    }
+    double bvhMs = MsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rayCount; r += RayPacket::kMaxRays) {
+        RayPacket packet;
+        for (uint32_t i = r; i < rayCount && i < r + RayPacket::kMaxRays; ++i) { packet.Add(rays[i].origin, rays[i].dir); }
+        TriangleID triangles[RayPacket::kMaxRays];
+        bvh.RaycastPacket(mesh, packet, triangles);
+        for (uint32_t i = 0; i < packet.count; ++i) {
+            float t = (triangles[i] != kInvalidTriangleID) ? packet.bestT[i] : 0.0f;
+            if (!SamePick(triangles[i], t, picked[r + i], pickedT[r + i])) { report("packet", r + i, triangles[i], t, picked[r + i], pickedT[r + i]); }
+        }
+    }
+    double packetMs = MsSince(start);
+
+    std::fprintf(out, "%u rays, %u hits\n", rayCount, hits);
+    std::fprintf(out, "%-24s %14s\n", "pick", "us per ray");
+    std::fprintf(out, "%-24s %14.2f\n", "brute force", bruteMs * 1000.0 / bruteRays);
+    std::fprintf(out, "%-24s %14.2f\n", "MeshBVH::Raycast", bvhMs * 1000.0 / rayCount);
+    std::fprintf(out, "%-24s %14.2f\n", "MeshBVH::RaycastPacket", packetMs * 1000.0 / rayCount);
+
+    uint32_t deepHits = 0;
+    // A mesh that SAH alone nests deep, so the median splits that bound the depth are exercised.
+    EditableMesh spikes;
+    BuildDeepSpikes(spikes);
+    MeshBVH deep;
+    deep.Build(spikes);
+    std::fprintf(out, "deep spikes: %u triangles, depth %u (limit %u)\n", spikes.triangleCount, deep.Depth(), MeshBVH::kMaxDepth);
+    if (deep.Depth() > MeshBVH::kMaxDepth) {
+        std::fprintf(out, "  FAIL: depth over the limit\n");
+        mismatches++;
+    }
+    for (uint32_t r = 0; r < 1024; ++r) {
+        // Into a random triangle from a point at its own scale, so float precision does not decide the hit.
+        uint32_t picked = random.Next() % spikes.triangleCount;
+        const XMFLOAT3& a = spikes.positions[picked * 3];
+        float d = (std::max)((std::max)(std::fabs(a.x), std::fabs(a.y)), std::fabs(a.z));
+        XMFLOAT3 target(a.x + 0.015f * d, a.y + 0.015f * d, a.z + 0.015f * d);
+        BenchRay ray;
+        ray.origin = XMFLOAT3(target.x + 0.3f * d, target.y - 0.5f * d, target.z + 0.4f * d);
+        ray.dir = XMFLOAT3(target.x - ray.origin.x, target.y - ray.origin.y, target.z - ray.origin.z);
+        TriangleID refTriangle = kInvalidTriangleID, triangle = kInvalidTriangleID;
+        float refT = 0.0f, t = 0.0f;
+        BruteForceClosest(spikes, ray, refTriangle, refT);
+        deep.Raycast(spikes, ray.origin, ray.dir, triangle, t);
+        if (refTriangle != kInvalidTriangleID) { deepHits++; }
+        if (!SamePick(triangle, t, refTriangle, refT)) { report("deep spikes", r, triangle, t, refTriangle, refT); }
+    }
+    std::fprintf(out, "deep spikes: 1024 rays, %u hits\n", deepHits);
+
+    std::fprintf(out, "%u mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int RunEditableMeshBench(FILE* out, uint32_t triangleCount, uint32_t rounds) {
+    rounds = (std::max)(rounds, 1u);
+    const uint32_t cells = (std::max)((uint32_t)std::sqrt(double(triangleCount) / 2.0), 1u);
+    const uint32_t vertexCount = (cells + 1) * (cells + 1);
+    const uint32_t builtTriangles = cells * cells * 2;
+
+    // Same grid as BuildBumpyGrid, counting IDs that come back other than expected.
+    uint32_t badIds = 0;
+    auto build = [&](EditableMesh& mesh, bool reserve) {
+        mesh.Clear();
+        if (reserve) { mesh.Reserve(vertexCount, builtTriangles); }
+        for (uint32_t y = 0; y <= cells; ++y) {
+            for (uint32_t x = 0; x <= cells; ++x) {
+                VertexID expected = y * (cells + 1) + x;
+                if (mesh.AddVertex(XMFLOAT3(float(x), float(y), float(x ^ y))) != expected) { badIds++; }
+            }
+        }
+        for (uint32_t y = 0; y < cells; ++y) {
+            for (uint32_t x = 0; x < cells; ++x) {
+                VertexID v = y * (cells + 1) + x;
+                TriangleID expected = (y * cells + x) * 2;
+                if (mesh.AddTriangle(v, v + 1, v + cells + 1) != expected) { badIds++; }
+                if (mesh.AddTriangle(v + 1, v + cells + 2, v + cells + 1) != expected + 1) { badIds++; }
+            }
+        }
+        return true;
+    };
+
+    EditableMesh grown, reserved;
+    double grownMin = 0.0, grownMedian = 0.0, reservedMin = 0.0, reservedMedian = 0.0;
+    TimeRounds(rounds, [&]() { EditableMesh mesh; build(mesh, false); grown = std::move(mesh); return true; }, grownMin, grownMedian);
+    TimeRounds(rounds, [&]() { EditableMesh mesh; build(mesh, true); reserved = std::move(mesh); return true; }, reservedMin, reservedMedian);
+
+    uint32_t mismatches = badIds;
+    for (const EditableMesh* mesh : { &grown, &reserved }) {
+        if (mesh->vertexCount != vertexCount || mesh->triangleCount != builtTriangles) { mismatches++; }
+        for (uint32_t v = 0; v < mesh->vertexCount; v += 997) {
+            XMFLOAT3 p = mesh->GetVertex(v);
+            uint32_t x = v % (cells + 1), y = v / (cells + 1);
+            if (p.x != float(x) || p.y != float(y) || p.z != float(x ^ y)) { mismatches++; }
+        }
+        EditTriangle last = mesh->GetTriangle(builtTriangles - 1);
+        if (last.a != vertexCount - cells - 2 || last.b != vertexCount - 1 || last.c != vertexCount - 2) { mismatches++; }
+    }
+    if (grown.AddVertex(XMFLOAT3(0.0f, 0.0f, 0.0f)) != vertexCount) { mismatches++; } //still growable past the build
+
+    const double tight = double(vertexCount) * sizeof(XMFLOAT3) + double(builtTriangles) * sizeof(EditTriangle);
+    std::fprintf(out, "%u triangles, %u vertices, %u rounds (min / median ms)\n", builtTriangles, vertexCount, rounds);
+    std::fprintf(out, "%-20s %10s %10s %14s %14s\n", "build", "min", "median", "bytes/tri", "Mtri/s");
+    std::fprintf(out, "%-20s %10.2f %10.2f %14.1f %14.1f\n", "grown from empty", grownMin, grownMedian,
+        double(grown.MemoryBytes()) / builtTriangles, builtTriangles / ((std::max)(grownMin, 1e-6) * 1000.0));
+    std::fprintf(out, "%-20s %10.2f %10.2f %14.1f %14.1f\n", "after Reserve", reservedMin, reservedMedian,
+        double(reserved.MemoryBytes()) / builtTriangles, builtTriangles / ((std::max)(reservedMin, 1e-6) * 1000.0));
+    std::fprintf(out, "tight arrays: %.1f bytes/tri; %u mismatches\n", tight / builtTriangles, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int RunPickGridBench(FILE* out, uint32_t vertexCount, uint32_t picks) {
+    picks = (std::max)(picks, 1u);
+    const float width = 1920.0f, height = 1080.0f, radiusPx = 14.0f; //App::HitTestVertex's radius
+    uint32_t cells = (std::max)((uint32_t)std::sqrt(double(vertexCount)), 2u) - 1;
+
+    EditableMesh mesh;
+    BuildBumpyGrid(mesh, cells);
+
+    EditorCamera camera;
+    camera.SetViewport(width, height);
+    camera.SetPosition(XMFLOAT3(0.3f, 1.2f, -2.0f));
+    camera.LookAt(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    camera.UpdateMatrices();
+
+    DirectX::XMFLOAT4X4 world;
+    DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixMultiply(DirectX::XMMatrixScaling(1.2f, 1.2f, 1.2f),
+        DirectX::XMMatrixMultiply(DirectX::XMMatrixRotationRollPitchYaw(0.9f, 0.2f, 0.0f), DirectX::XMMatrixTranslation(0.1f, 0.0f, 0.2f))));
+
+    VertexPickGrid grid;
+    auto start = std::chrono::steady_clock::now();
+    grid.Update(mesh, world, camera.ViewProj(), width, height, radiusPx);
+    double rebuildMs = MsSince(start);
+    uint32_t mismatches = 0;
+    if (grid.Update(mesh, world, camera.ViewProj(), width, height, radiusPx)) {
+        std::fprintf(out, "  FAIL: unchanged inputs rebuilt the grid\n");
+        mismatches++;
+    }
+
+    std::vector<ScreenVertex> screen = ProjectVertices(mesh, world, camera.ViewProj(), width, height);
+
+    // Half the cursors anywhere in the viewport, half within the radius of some vertex.
+    BenchRandom random;
+    std::vector<XMFLOAT3> cursors(picks);
+    for (uint32_t i = 0; i < picks; ++i) {
+        cursors[i] = XMFLOAT3(random.Range(0.0f, width), random.Range(0.0f, height), 0.0f);
+        const ScreenVertex& v = screen[random.Next() % mesh.vertexCount];
+        if ((i & 1) && v.visible && v.x >= 0.0f && v.x < width && v.y >= 0.0f && v.y < height) {
+            cursors[i] = XMFLOAT3(v.x + random.Range(-10.0f, 10.0f), v.y + random.Range(-10.0f, 10.0f), 0.0f);
+        }
+    }
+
+    std::vector<int> picked(picks);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < picks; ++i) { picked[i] = grid.Pick(cursors[i].x, cursors[i].y); }
+    double gridMs = MsSince(start);
+
+    // The scan costs a pass over every vertex per pick, so at most 2000 picks are checked that way.
+    const uint32_t scanned = (std::min)(picks, 2000u);
+    uint32_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < scanned; ++i) {
+        float refDistSq = 0.0f;
+        int ref = ScanPick(screen, cursors[i].x, cursors[i].y, radiusPx, refDistSq);
+        if (ref >= 0) { hits++; }
+
+        // Distances within the tie epsilon of each other can resolve either way depending on visit order.
+        int got = picked[i];
+        bool same = (got == ref);
+        if (!same && got >= 0 && ref >= 0) {
+            float dx = screen[got].x - cursors[i].x, dy = screen[got].y - cursors[i].y;
+            same = std::fabs(dx * dx + dy * dy - refDistSq) <= 2e-4f;
+        }
+        if (!same && mismatches++ < 5) {
+            std::fprintf(out, "  MISMATCH pick %u at (%.2f, %.2f): grid %d, scan %d\n", i, cursors[i].x, cursors[i].y, got, ref);
+        }
+    }
+    double scanMs = MsSince(start);
+
+    std::fprintf(out, "%u vertices, %u cells of %.0f px, %u picks (%u checked, %u hits)\n", mesh.vertexCount, grid.CellCount(), radiusPx, picks, scanned, hits);
+    std::fprintf(out, "grid rebuild %.2f ms\n", rebuildMs);
+    std::fprintf(out, "%-24s %14s\n", "pick", "us per pick");
+    std::fprintf(out, "%-24s %14.3f\n", "scan all vertices", scanMs * 1000.0 / scanned);
+    std::fprintf(out, "%-24s %14.3f\n", "VertexPickGrid::Pick", gridMs * 1000.0 / picks);
+    std::fprintf(out, "%u mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+// Modeling-mode benchmarks and self-checks. Each prints its timings to out and returns a process exit
+// code: nonzero when a result differs from its reference.
+
+// Ray/triangle kernels (RayTriangleBatch): triangleCount random triangles in shuffled slot order, as
+// a BVH lays them out, against rayCount random rays. IntersectRayBatch and IntersectPacketBatch must
+// pick the same slot as RayIntersectsTriangle over the same range, with t within 1e-6 relative, for
+// the whole batch and for ranges starting at any slot (BVH leaves). Then prints triangles per second
+// for the scalar test, the batch kernel and packets of 16 rays.
+int RunRayTriangleBench(FILE* out, uint32_t triangleCount, uint32_t rayCount);
+
+// MeshBVH picking: a bumpy grid of about triangleCount triangles, built and then picked with rayCount
+// rays from above. Each Raycast must find the brute-force closest hit (same triangle, or the same t
+// when the ray lands on a shared edge), and RaycastPacket the same as Raycast. A mesh whose SAH splits
+// would nest deeper than MeshBVH::kMaxDepth is checked the same way. Prints build time, node count,
+// depth, and microseconds per pick for the BVH and for brute force.
+int RunMeshBVHBench(FILE* out, uint32_t triangleCount, uint32_t rayCount);
+
+// EditableMesh storage: builds a grid of about triangleCount triangles through AddVertex/AddTriangle,
+// growing from empty and after Reserve, `rounds` times each. Checks every ID came back valid and in
+// order and the mesh reads back what was added, then prints build times and heap bytes per triangle.
+int RunEditableMeshBench(FILE* out, uint32_t triangleCount, uint32_t rounds);
+
+// VertexPickGrid: a bumpy grid of about vertexCount vertices seen by an EditorCamera at 1920x1080.
+// Every Pick, at random pixels and next to projected vertices, must return what a scan of all
+// vertices returns with the same projection and tie rule. Then prints the rebuild time and
+// microseconds per pick for the grid and for the full scan.
+int RunPickGridBench(FILE* out, uint32_t vertexCount, uint32_t picks);
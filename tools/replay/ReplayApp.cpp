@@ -0,0 +1,372 @@
+#include "tools/replay/ReplayApp.h"
+#include "engine/core/JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <thread>
+
+static double ElapsedUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Upload ring for the simulated GPU: room for a few frames of 100k world matrices.
+static const uint64_t kUploadRingBytes = 64ull << 20;
+static const size_t kSlotBufferWords = 4096;
+
+static uint64_t SumWords(const uint8_t* data, uint64_t bytes) {
+    uint64_t sum = 0;
+    for (uint64_t offset = 0; offset + sizeof(uint64_t) <= bytes; offset += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + offset, sizeof(word));
+        sum = sum * 31 + word;
+    }
+    return sum;
+}
+
+static bool ParseCommandType(const char* name, EditorCommandType& type) {
+    for (int t = (int)EditorCommandType::AddObject; t <= (int)EditorCommandType::FocusCamera; ++t) {
+        if (std::strcmp(name, EditorCommandName((EditorCommandType)t)) == 0) {
+            type = (EditorCommandType)t;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoadReplayScript(const char* path, std::vector<ReplayStep>& steps, std::string& error) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+
+    char text[1024];
+    uint32_t lineNumber = 0;
+    while (std::fgets(text, sizeof(text), f)) {
+        ++lineNumber;
+        if (char* comment = std::strchr(text, '#')) { *comment = '\0'; }
+
+        char name[64] = {};
+        int consumed = 0;
+        if (std::sscanf(text, "%63s%n", name, &consumed) != 1) { continue; } //blank line
+        const char* args = text + consumed;
+
+        ReplayStep step;
+        step.line = lineNumber;
+        EditorCommand& command = step.command;
+
+        bool ok = true;
+        if (std::strcmp(name, "Idle") == 0) {
+            ok = std::sscanf(args, "%lf", &step.idleSeconds) == 1 && step.idleSeconds > 0.0;
+        } else if (std::strcmp(name, "Pick") == 0) {
+            step.pick = true;
+            ok = std::sscanf(args, "%f %f %f %f %f %f", &step.rayOrigin.x, &step.rayOrigin.y, &step.rayOrigin.z, &step.rayDir.x, &step.rayDir.y, &step.rayDir.z) == 6;
+        } else if (!ParseCommandType(name, command.type)) {
+            ok = false;
+        } else {
+            switch (command.type) {
+            case EditorCommandType::AddObject:
+                ok = std::sscanf(args, "%f %f %f", &command.pos.x, &command.pos.y, &command.pos.z) == 3;
+                break;
+
+            case EditorCommandType::SetActiveTransform:
+                ok = std::sscanf(args, "%f %f %f %f %f %f %f %f %f",
+                    &command.pos.x, &command.pos.y, &command.pos.z,
+                    &command.rot.x, &command.rot.y, &command.rot.z,
+                    &command.scale.x, &command.scale.y, &command.scale.z) == 9;
+                break;
+
+            case EditorCommandType::SetActiveObject:
+            case EditorCommandType::SetActiveParent:
+                ok = std::sscanf(args, "%d", &step.objectIndex) == 1;
+                break;
+
+            case EditorCommandType::SetGizmoMode:
+                ok = std::sscanf(args, "%u", &command.gizmoMode) == 1;
+                break;
+
+            case EditorCommandType::SaveScene:
+            case EditorCommandType::LoadScene:
+            case EditorCommandType::LoadSceneAsync: {
+                char narrow[512] = {};
+                ok = std::sscanf(args, " %511[^\r\n]", narrow) == 1;
+                if (ok) {
+                    size_t length = std::strlen(narrow);
+                    while (length > 0 && (narrow[length - 1] == ' ' || narrow[length - 1] == '\t')) { narrow[--length] = '\0'; }
+
+                    std::vector<wchar_t> wide(length + 1, L'\0');
+                    ok = std::mbstowcs(wide.data(), narrow, length + 1) != (size_t)-1;
+                    step.path = wide.data();
+                }
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+
+        if (!ok) {
+            error = std::string(path) + "(" + std::to_string(lineNumber) + "): cannot parse '" + name + "'";
+            std::fclose(f);
+            return false;
+        }
+        steps.push_back(std::move(step));
+    }
+
+    std::fclose(f);
+    return true;
+}
+
+void WriteSyntheticReplayScript(FILE* out, uint32_t objectCount, uint32_t seed) {
+    // xorshift32 rather than <random> distributions, whose output differs between standard libraries.
+    uint32_t state = seed ? seed : 1u;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+    auto range = [&next](float lo, float hi) { return lo + (hi - lo) * float(next() >> 8) * (1.0f / 16777216.0f); };
+
+    std::fprintf(out, "# Synthetic editing session: %u objects, seed %u\n", objectCount, seed);
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        std::fprintf(out, "AddObject %.3f %.3f %.3f\n", range(-50.0f, 50.0f), range(-50.0f, 50.0f), 0.0f);
+        std::fprintf(out, "SetActiveTransform %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f\n",
+            range(-50.0f, 50.0f), range(-50.0f, 50.0f), range(-5.0f, 5.0f),
+            range(-3.14f, 3.14f), range(-3.14f, 3.14f), range(-3.14f, 3.14f),
+            range(0.5f, 2.0f), range(0.5f, 2.0f), range(0.5f, 2.0f));
+
+        // The two startup objects come first, so the new object is at dense index i + 2.
+        if (i % 16 == 15) { std::fprintf(out, "SetActiveParent %u\n", next() % (i + 2)); }
+        if (i % 64 == 63) {
+            std::fprintf(out, "Pick %.3f %.3f -100 0 0 1\n", range(-50.0f, 50.0f), range(-50.0f, 50.0f));
+        }
+    }
+    std::fprintf(out, "SaveScene replay_session.aem\n");
+    std::fprintf(out, "LoadScene replay_session.aem\n");
+}
+
+ReplayApp::ReplayApp(std::vector<ReplayStep> steps, uint32_t stepsPerFrame)
+    : m_steps(std::move(steps)), m_stepsPerFrame((std::max)(stepsPerFrame, 1u)) {
+    CreateDefaultScene();
+    m_timings.reserve(m_steps.size());
+}
+
+bool ReplayApp::PumpMessages(int& exitCode) {
+    bool idle = std::chrono::steady_clock::now() < m_idleUntil;
+    if (idle) { return true; }
+    if (m_nextStep < m_steps.size()) {
+        m_redraw.Request(RedrawReason::Input);
+        return true;
+    }
+    if (IsLoadingScene()) {
+        m_redraw.Request(RedrawReason::Dirty);
+        return true;
+    }
+
+    // Every frame's GPU work has run (and been checked) before the report.
+    if (m_gpuQueue) { m_framesInFlight.WaitForIdle(); }
+    exitCode = 0;
+    return false;
+}
+
+void ReplayApp::SetGpuSimulation(uint32_t framesInFlight, double gpuLatencyMs) {
+    m_gpuQueue.reset();
+    if (framesInFlight == 0) { return; }
+
+    m_gpuLatencyMs = gpuLatencyMs;
+    m_gpuQueue = std::make_unique<SimulatedGpuQueue>(gpuLatencyMs);
+    m_framesInFlight.Initialize(m_gpuQueue.get(), framesInFlight);
+    m_uploadMemory.resize(kUploadRingBytes);
+    m_uploadRing.Initialize(m_uploadMemory.data(), m_uploadMemory.size());
+}
+
+void ReplayApp::Render() {
+    if (!m_gpuQueue) { return; }
+
+    // Same order as Engine: wait for the slot, free what completed frames used, record, signal.
+    uint32_t slot = m_framesInFlight.BeginFrame();
+    m_uploadRing.Reclaim(m_gpuQueue->CompletedValue());
+    uint64_t frame = m_frames;
+
+    // The frame number, the object count and every world matrix, checksummed as written.
+    uint32_t count = m_scene.Count();
+    uint64_t bytes = 2 * sizeof(uint64_t) + uint64_t(count) * sizeof(DirectX::XMFLOAT4X4);
+    UploadAllocation upload = m_uploadRing.Allocate(bytes, 256);
+    uint64_t uploadSum = 0;
+    if (upload.Valid()) {
+        uint64_t header[2] = { frame, count };
+        std::memcpy(upload.cpu, header, sizeof(header));
+        for (uint32_t i = 0; i < count; ++i) {
+            std::memcpy(upload.cpu + sizeof(header) + uint64_t(i) * sizeof(DirectX::XMFLOAT4X4), &m_scene.World(i), sizeof(DirectX::XMFLOAT4X4));
+        }
+        uploadSum = SumWords(upload.cpu, bytes);
+    }
+
+    std::vector<uint64_t>& slotBuffer = m_slotBuffers[slot];
+    slotBuffer.assign(kSlotBufferWords, frame);
+
+    // Reads at the end of the simulated work, as late as a GPU could. Data rewritten by a later frame
+    // before then means that frame did not wait for this one.
+    m_gpuQueue->Submit([this, upload, bytes, uploadSum, &slotBuffer, frame]() {
+        bool intact = !upload.Valid() || SumWords(upload.cpu, bytes) == uploadSum;
+        for (uint64_t word : slotBuffer) {
+            if (word != frame) { intact = false; }
+        }
+        if (!intact) { m_gpuOverwrites++; }
+        m_gpuFrames++;
+    });
+
+    m_uploadRing.EndFrame(m_framesInFlight.EndFrame());
+}
+
+void ReplayApp::WaitForEvents(double timeoutSeconds) {
+    auto wake = m_idleUntil;
+    if (timeoutSeconds >= 0.0) {
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeoutSeconds));
+        wake = (std::min)(wake, timeout);
+    }
+    std::this_thread::sleep_until(wake);
+}
+
+void ReplayApp::Update(const HostFrame& frame) {
+    auto frameStart = std::chrono::steady_clock::now();
+    m_frames = frame.frameIndex + 1;
+    m_scene.ClearChanged();
+    if (IsLoadingScene()) {
+        UpdateSceneLoad(kLoadSliceSeconds);
+        m_redraw.Request(RedrawReason::Dirty); //frames keep coming while loading, like the editor's
+    }
+
+    size_t end = (std::min)(m_steps.size(), m_nextStep + m_stepsPerFrame);
+    for (; m_nextStep < end && std::chrono::steady_clock::now() >= m_idleUntil && !IsLoadingScene(); ++m_nextStep) {
+        const ReplayStep& step = m_steps[m_nextStep];
+        if (step.idleSeconds > 0.0) {
+            m_idleUntil = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(step.idleSeconds));
+            m_idleSteps++;
+            continue;
+        }
+        if (!step.pick && (step.command.type == EditorCommandType::SetGizmoMode || step.command.type == EditorCommandType::FocusCamera)) {
+            m_skipped++;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = RunStep(step);
+        m_timings.push_back(StepTiming{ (uint32_t)m_nextStep, ok, ElapsedUs(start) });
+    }
+
+    // Same per-frame work as the editor's Update after its commands.
+    auto start = std::chrono::steady_clock::now();
+    m_scene.UpdateWorldMatrices(m_jobs);
+    m_worldUpdateUs.push_back(ElapsedUs(start));
+
+    m_wallMs += ElapsedUs(frameStart) / 1000.0;
+}
+
+bool ReplayApp::RunStep(const ReplayStep& step) {
+    if (step.pick) {
+        bool hit = PickObject(step.rayOrigin, step.rayDir) >= 0;
+        if (hit) { m_pickHits++; }
+        return true; //a miss is still an answered query
+    }
+
+    EditorCommand command = step.command;
+    if (command.type == EditorCommandType::SetActiveObject || command.type == EditorCommandType::SetActiveParent) {
+        command.object = (step.objectIndex >= 0) ? m_scene.HandleAt((uint32_t)step.objectIndex) : ObjectHandle{};
+    }
+    command.path = step.path.empty() ? nullptr : step.path.c_str();
+    return ExecuteCommand(command);
+}
+
+const char* ReplayApp::StepName(const ReplayStep& step) const {
+    return step.pick ? "Pick" : EditorCommandName(step.command.type);
+}
+
+void ReplayApp::FixedUpdate(const HostFrame& step) {
+    m_fixedSteps++;
+    m_simulatedSeconds += step.dt;
+}
+
+bool ReplayApp::IdleRedrawFailed() const {
+    const RedrawStats& redraw = m_redraw.Stats();
+    uint64_t settleFrames = redraw.framesRendered - redraw.framesRequested;
+    return !m_redraw.IdleEnabled() || m_idleSteps == 0 || redraw.idleWaits != m_idleSteps
+        || settleFrames != uint64_t(m_idleSteps) * RedrawPolicy::kSettleFrames;
+}
+
+void ReplayApp::WriteReport(FILE* out) const {
+    struct Row {
+        std::vector<double> us;
+        uint32_t failed = 0;
+    };
+    std::map<std::string, Row> rows;
+    for (const StepTiming& timing : m_timings) {
+        Row& row = rows[StepName(m_steps[timing.step])];
+        row.us.push_back(timing.us);
+        if (!timing.ok) { row.failed++; }
+    }
+    rows["(UpdateWorldMatrices)"].us = m_worldUpdateUs;
+
+    std::fprintf(out, "%-24s %9s %7s %12s %10s %10s %10s %10s\n", "step", "count", "failed", "total ms", "mean us", "p50 us", "p99 us", "max us");
+    for (auto& entry : rows) {
+        std::vector<double>& us = entry.second.us;
+        if (us.empty()) { continue; }
+
+        double total = 0.0;
+        for (double value : us) { total += value; }
+        std::sort(us.begin(), us.end());
+
+        std::fprintf(out, "%-24s %9zu %7u %12.3f %10.3f %10.3f %10.3f %10.3f\n",
+            entry.first.c_str(), us.size(), entry.second.failed, total / 1000.0, total / double(us.size()),
+            us[us.size() / 2], us[(std::min)(us.size() - 1, us.size() * 99 / 100)], us.back());
+    }
+
+    std::fprintf(out, "\n%zu steps (%u skipped, need a view) in %llu frames, %.3f ms\n",
+        m_steps.size(), m_skipped, (unsigned long long)m_frames, m_wallMs);
+
+    const RedrawStats& redraw = m_redraw.Stats();
+    std::fprintf(out, "idle redraw %s: %llu frames (%llu requested, %llu settle; input %llu, timer %llu), %llu idle waits, %.3f s idle\n",
+        m_redraw.IdleEnabled() ? "on" : "off", (unsigned long long)redraw.framesRendered,
+        (unsigned long long)redraw.framesRequested, (unsigned long long)(redraw.framesRendered - redraw.framesRequested),
+        (unsigned long long)redraw.framesByReason[(uint32_t)RedrawReason::Input], (unsigned long long)redraw.framesByReason[(uint32_t)RedrawReason::Timer],
+        (unsigned long long)redraw.idleWaits, redraw.idleSeconds);
+    if (m_fixedSteps > 0) {
+        std::fprintf(out, "fixed steps %llu, %.3f s simulated\n", (unsigned long long)m_fixedSteps, m_simulatedSeconds);
+    }
+    if (m_gpuQueue) {
+        std::fprintf(out, "simulated gpu: %u frames in flight, %.3f ms per frame: %llu frames, %llu cpu stalls (%.3f ms), %llu overwritten while in flight\n",
+            m_framesInFlight.FrameCount(), m_gpuLatencyMs, (unsigned long long)m_gpuFrames.load(),
+            (unsigned long long)m_framesInFlight.StallCount(), m_framesInFlight.StallMs(), (unsigned long long)m_gpuOverwrites.load());
+        std::fprintf(out, "upload ring: peak frame %.1f KB, high water %.1f KB of %.1f KB, %llu failed allocations\n",
+            m_uploadRing.PeakFrameBytes() / 1024.0, m_uploadRing.HighWaterBytes() / 1024.0, m_uploadRing.Capacity() / 1024.0,
+            (unsigned long long)m_uploadRing.FailedAllocations());
+    }
+    if (m_pacer) {
+        FramePacingStats pacing = m_pacer->Stats();
+        std::fprintf(out, "frame pacing %.3f ms target, %u frames: mean %.3f ms, deviation p50 %.3f / p99 %.3f / max %.3f ms, %llu missed, spin margin %.3f ms\n",
+            pacing.targetMs, pacing.frames, pacing.meanMs, pacing.p50DeviationMs, pacing.p99DeviationMs, pacing.maxDeviationMs,
+            (unsigned long long)pacing.missedDeadlines, pacing.spinMarginMs);
+    }
+    const SceneLoadStats& load = LoadStats();
+    if (!LastLoadError().empty()) {
+        std::fprintf(out, "last load failed: %s\n", LastLoadError().c_str());
+    }
+    if (!load.failed && load.objects > 0) {
+        std::fprintf(out, "async load: %u objects, %u meshes (%u placeholders); read %.3f ms, first objects %.3f ms, all objects %.3f ms, all meshes %.3f ms; %u frames, longest slice %.3f ms\n",
+            load.objects, load.meshes, load.placeholders, load.readMs, load.firstObjectsMs, load.allObjectsMs, load.allMeshesMs, load.slices, load.maxSliceMs);
+    }
+    std::fprintf(out, "objects %u, mesh assets %u, picks hit %u\n", m_scene.Count(), m_meshAssets.AliveCount(), m_pickHits);
+}
+
+void ReplayApp::WriteStepLog(FILE* out) const {
+    std::fprintf(out, "line,step,ok,us\n");
+    for (const StepTiming& timing : m_timings) {
+        const ReplayStep& step = m_steps[timing.step];
+        std::fprintf(out, "%u,%s,%d,%.3f\n", step.line, StepName(step), timing.ok ? 1 : 0, timing.us);
+    }
+}
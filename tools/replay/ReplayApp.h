@@ -0,0 +1,136 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "engine/core/FramePacer.h"
+#include "engine/core/HostApp.h"
+#include "engine/core/RedrawPolicy.h"
+#include "engine/gfx/FramesInFlight.h"
+#include "engine/gfx/SimulatedGpuQueue.h"
+#include "engine/gfx/UploadRing.h"
+#include "editor/EditorCommands.h"
+#include "editor/SceneDocument.h"
+
+// One line of a replay script. Commands name objects by dense index at the time they run (handles
+// are not known when the script is written); -1 means no object.
+struct ReplayStep {
+    EditorCommand command;
+    bool pick = false;      //not an EditorCommand: a picking query with rayOrigin/rayDir
+    double idleSeconds = 0.0; //not an EditorCommand: no input for this long (> 0)
+    int objectIndex = -1;   //SetActiveObject, SetActiveParent
+    std::wstring path;      //SaveScene, LoadScene
+    DirectX::XMFLOAT3 rayOrigin = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 rayDir = { 0.0f, 0.0f, 1.0f };
+    uint32_t line = 0;
+};
+
+// Script format, one step per line, '#' starts a comment. Names match EditorCommandName:
+//   AddObject px py pz
+//   DuplicateActiveObject
+//   DeleteActiveObject
+//   SetActiveObject index
+//   SetActiveTransform px py pz rx ry rz sx sy sz
+//   SetActiveParent index              (-1 = make it a root)
+//   SetGizmoMode mode
+//   FocusCamera
+//   SaveScene path
+//   LoadScene path
+//   LoadSceneAsync path                (later steps wait until the load is done; frames keep running)
+//   Pick ox oy oz dx dy dz             (nearest object hit by the world-space ray)
+//   Idle seconds                       (no input for that long; see ReplayApp)
+// Returns false with a message naming the line if a line does not parse.
+bool LoadReplayScript(const char* path, std::vector<ReplayStep>& steps, std::string& error);
+
+// Writes a reproducible synthetic session: objectCount AddObject + SetActiveTransform pairs with some
+// reparenting and picking mixed in, then a save and a load of the result. Same seed, same script.
+void WriteSyntheticReplayScript(FILE* out, uint32_t objectCount, uint32_t seed);
+
+// Headless host: replays a script against a SceneDocument through the same HostRunner loop as the
+// editor, with no window, device or UI. Every step is timed on its own, and so is each frame's world
+// matrix update. SetGizmoMode and FocusCamera need a view and are skipped.
+// Steps stand in for input: each frame that runs steps asks the RedrawPolicy for a frame, and an Idle
+// step stops asking for a while. With idle mode on HostRunner then blocks instead of running frames,
+// which the report shows as idle waits rather than frames. Steps wait while a LoadSceneAsync is still
+// publishing, as a user would wait for the scene to appear.
+class ReplayApp : public IHostApp, public SceneDocument {
+public:
+    // stepsPerFrame steps run per Update (at least 1).
+    ReplayApp(std::vector<ReplayStep> steps, uint32_t stepsPerFrame);
+
+    void SetIdleRedraw(bool enabled) { m_redraw.SetIdleEnabled(enabled); }
+
+    // Reported only; HostRunner does the waiting (see HostLoopConfig).
+    void SetFramePacer(const FramePacer* pacer) { m_pacer = pacer; }
+
+    // Renders against a SimulatedGpuQueue whose work takes gpuLatencyMs, paced by FramesInFlight like
+    // the editor's Engine: each frame uploads the world matrices through an UploadRing and rewrites the
+    // buffer of its frame slot, and the simulated GPU checks that both still hold what that frame wrote
+    // when it gets to them. framesInFlight 0 (the default) leaves Render empty.
+    void SetGpuSimulation(uint32_t framesInFlight, double gpuLatencyMs);
+    // Whether the simulated GPU ever read data the CPU had already overwritten.
+    bool GpuSimulationFailed() const { return m_gpuOverwrites.load() > 0; }
+    // Whether idle mode went wrong: it is off, the script has no Idle step, the host did not block exactly
+    // once per Idle step (WaitForEvents sleeps until the step ends), or frames other than the requested
+    // ones plus RedrawPolicy::kSettleFrames after each Idle step ran. Holds only for Idle steps longer
+    // than a few frames.
+    bool IdleRedrawFailed() const;
+
+    void BeginFrame() override {}
+    bool PumpMessages(int& exitCode) override; //quits once every step ran
+    void FixedUpdate(const HostFrame& step) override; //counts steps; the scene has nothing to simulate
+    void Update(const HostFrame& frame) override;
+    void BuildFrameUI() override {}
+    void Render() override;
+    RedrawPolicy* Redraw() override { return &m_redraw; }
+    void WaitForEvents(double timeoutSeconds) override; //sleeps until the idle step ends or the timeout
+
+    // Per step name: count, failures and time (total, mean, p50, p99, max).
+    void WriteReport(FILE* out) const;
+    // CSV, one row per step: line, step, ok, microseconds.
+    void WriteStepLog(FILE* out) const;
+
+private:
+    struct StepTiming {
+        uint32_t step = 0;
+        bool ok = false;
+        double us = 0.0;
+    };
+
+    std::vector<ReplayStep> m_steps;
+    uint32_t m_stepsPerFrame = 1;
+    size_t m_nextStep = 0;
+    const FramePacer* m_pacer = nullptr;
+
+    RedrawPolicy m_redraw;
+    std::chrono::steady_clock::time_point m_idleUntil; //no input before this
+    uint32_t m_idleSteps = 0;
+
+    std::vector<StepTiming> m_timings;
+    std::vector<double> m_worldUpdateUs; //per frame
+    uint64_t m_frames = 0;
+    uint64_t m_fixedSteps = 0;
+    double m_simulatedSeconds = 0.0;
+    uint32_t m_skipped = 0;
+    uint32_t m_pickHits = 0;
+    double m_wallMs = 0.0;
+
+    // Simulated GPU (SetGpuSimulation). The slot buffers stand in for buffers versioned per frame, such
+    // as the mesh vertex buffer.
+    std::unique_ptr<SimulatedGpuQueue> m_gpuQueue;
+    FramesInFlight m_framesInFlight;
+    double m_gpuLatencyMs = 0.0;
+    std::vector<uint8_t> m_uploadMemory;
+    UploadRing m_uploadRing;
+    std::vector<uint64_t> m_slotBuffers[FramesInFlight::kMaxFrames];
+    std::atomic<uint64_t> m_gpuFrames{ 0 };
+    std::atomic<uint64_t> m_gpuOverwrites{ 0 };
+
+    bool RunStep(const ReplayStep& step);
+    const char* StepName(const ReplayStep& step) const;
+};
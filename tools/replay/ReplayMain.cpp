@@ -0,0 +1,228 @@
+// Headless command replay. Runs EditorCommand scripts against the editor's SceneDocument with no
+// window, device or UI and prints per-step timing; see ReplayApp.h for the script format.
+//
+//   replay [--batch N] [--threads N] [--idle [--check-idle]] [--fps N] [--fixed-step HZ] [--frames-in-flight N] [--gpu-latency MS]
+//          [--csv steps.csv] [--trace trace.json] script.txt
+//   replay --generate OBJECTS [SEED] > script.txt
+//   replay --scene-bench OBJECTS [ROUNDS]     (text vs binary, sync vs async scene loads, see SceneBench.h)
+//   replay --raytri-bench TRIANGLES [RAYS]    (SIMD ray/triangle kernels vs the scalar test, see MeshBench.h)
+//   replay --bvh-bench TRIANGLES [RAYS]       (MeshBVH picks vs brute force)
+//   replay --mesh-bench TRIANGLES [ROUNDS]    (EditableMesh build time and bytes per triangle)
+//   replay --pick-grid-bench VERTICES [PICKS] (VertexPickGrid picks vs a scan of every vertex)
+//   replay --handles-bench OBJECTS [ROUNDS]   (Scene handle add/remove/lookup, by command too)
+//   replay --hierarchy-bench OBJECTS [ROUNDS] (Scene hierarchy vs a recursive reference, propagation time)
+//   replay --jobs-bench ITEMS [ROUNDS]        (JobSystem tests and scaling at 1/2/4/8 threads)
+//   replay --draw-list SCENE                  (a scene's draws per object and instanced)
+//   replay --parse-check SCENE                (.aem parser vs fscanf, 1 vs 4 threads, error positions)
+//
+// --batch    steps per frame (default 1, like commands issued from the UI)
+// --threads  job system threads for world matrix updates (default 1, so runs are reproducible; 0 = one per core)
+// --idle     event-driven frames (RedrawPolicy idle mode): Idle steps block instead of running frames
+// --check-idle  fail unless frames ran only for steps plus RedrawPolicy::kSettleFrames after each Idle
+//            step, and the host blocked once per Idle step (see ReplayApp::IdleRedrawFailed)
+// --fps      hold frames to N per second with FramePacer (default 0, unpaced) and report the jitter
+// --fixed-step  run FixedUpdate at HZ steps per second of frame time
+// --frames-in-flight  render against a simulated GPU with N frame slots (1 to 3, see ReplayApp::SetGpuSimulation);
+//            fails if the GPU ever reads data the CPU already overwrote
+// --gpu-latency  simulated GPU time per frame in ms (default 0; only with --frames-in-flight)
+// --trace    write the profiler's zones as a Chrome trace (only the last Profiler::kZonesPerThread per thread)
+//
+// Platform-free; builds with tools/replay/CMakeLists.txt (which finds or fetches DirectXMath and, off
+// Windows, supplies the sal.h it includes):
+//   cmake -S tools/replay -B build/replay && cmake --build build/replay && ctest --test-dir build/replay
+#include "tools/replay/ReplayApp.h"
+#include "tools/replay/DrawListReport.h"
+#include "tools/replay/JobsBench.h"
+#include "tools/replay/MeshBench.h"
+#include "tools/replay/SceneBench.h"
+#include "tools/replay/SceneOpsBench.h"
+#include "tools/replay/SceneParseCheck.h"
+#include "engine/core/FramePacer.h"
+#include "engine/core/HostRunner.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/Profiler.h"
+
+#include <clocale>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static int Usage() {
+    std::fprintf(stderr,
+        "usage: replay [--batch N] [--threads N] [--idle [--check-idle]] [--fps N] [--fixed-step HZ]\n"
+        "              [--frames-in-flight N] [--gpu-latency MS] [--csv steps.csv] [--trace trace.json] script.txt\n"
+        "       replay --generate OBJECTS [SEED]\n"
+        "       replay --scene-bench OBJECTS [ROUNDS]\n"
+        "       replay --raytri-bench TRIANGLES [RAYS]\n"
+        "       replay --bvh-bench TRIANGLES [RAYS]\n"
+        "       replay --mesh-bench TRIANGLES [ROUNDS]\n"
+        "       replay --pick-grid-bench VERTICES [PICKS]\n"
+        "       replay --handles-bench OBJECTS [ROUNDS]\n"
+        "       replay --hierarchy-bench OBJECTS [ROUNDS]\n"
+        "       replay --jobs-bench ITEMS [ROUNDS]\n"
+        "       replay --draw-list SCENE\n"
+        "       replay --parse-check SCENE\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::setlocale(LC_CTYPE, ""); //scene paths in scripts are converted with the user's locale; numbers stay in the C locale
+
+    if (argc >= 3 && std::strcmp(argv[1], "--generate") == 0) {
+        uint32_t objects = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t seed = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 1u;
+        WriteSyntheticReplayScript(stdout, objects, seed);
+        return 0;
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--scene-bench") == 0) {
+        uint32_t objects = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rounds = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 5u;
+        return RunSceneBench(stdout, objects, rounds);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--raytri-bench") == 0) {
+        uint32_t triangles = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rays = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 256u;
+        return RunRayTriangleBench(stdout, triangles, rays);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--bvh-bench") == 0) {
+        uint32_t triangles = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rays = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 10000u;
+        return RunMeshBVHBench(stdout, triangles, rays);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--mesh-bench") == 0) {
+        uint32_t triangles = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rounds = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 5u;
+        return RunEditableMeshBench(stdout, triangles, rounds);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--pick-grid-bench") == 0) {
+        uint32_t vertices = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t picks = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 100000u;
+        return RunPickGridBench(stdout, vertices, picks);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--handles-bench") == 0) {
+        uint32_t objects = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rounds = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 3u;
+        return RunHandlesBench(stdout, objects, rounds);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--hierarchy-bench") == 0) {
+        uint32_t objects = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rounds = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 5u;
+        return RunHierarchyBench(stdout, objects, rounds);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--jobs-bench") == 0) {
+        uint32_t items = (uint32_t)std::strtoul(argv[2], nullptr, 10);
+        uint32_t rounds = (argc >= 4) ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : 5u;
+        return RunJobsBench(stdout, items, rounds);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--draw-list") == 0) {
+        size_t length = std::strlen(argv[2]);
+        std::vector<wchar_t> path(length + 1, L'\0');
+        if (std::mbstowcs(path.data(), argv[2], length + 1) == (size_t)-1) { return Usage(); }
+        return RunDrawListReport(stdout, path.data());
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "--parse-check") == 0) {
+        size_t length = std::strlen(argv[2]);
+        std::vector<wchar_t> path(length + 1, L'\0');
+        if (std::mbstowcs(path.data(), argv[2], length + 1) == (size_t)-1) { return Usage(); }
+        return RunSceneParseCheck(stdout, path.data());
+    }
+
+    uint32_t batch = 1;
+    uint32_t threads = 1;
+    bool idle = false;
+    bool checkIdle = false;
+    double fps = 0.0;
+    double fixedStepHz = 0.0;
+    uint32_t framesInFlight = 0;
+    double gpuLatencyMs = 0.0;
+    const char* csvPath = nullptr;
+    const char* tracePath = nullptr;
+    const char* scriptPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--batch") == 0 && hasValue) {
+            batch = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--idle") == 0) {
+            idle = true;
+        } else if (std::strcmp(argv[i], "--check-idle") == 0) {
+            checkIdle = true;
+        } else if (std::strcmp(argv[i], "--fps") == 0 && hasValue) {
+            fps = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--fixed-step") == 0 && hasValue) {
+            fixedStepHz = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--frames-in-flight") == 0 && hasValue) {
+            framesInFlight = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--gpu-latency") == 0 && hasValue) {
+            gpuLatencyMs = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+            tracePath = argv[++i];
+        } else if (argv[i][0] != '-' && !scriptPath) {
+            scriptPath = argv[i];
+        } else {
+            return Usage();
+        }
+    }
+    if (!scriptPath) { return Usage(); }
+
+    std::vector<ReplayStep> steps;
+    std::string error;
+    if (!LoadReplayScript(scriptPath, steps, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    JobSystem jobs;
+    jobs.Initialize(threads);
+
+    ReplayApp app(std::move(steps), batch);
+    app.SetJobSystem(&jobs);
+    app.SetIdleRedraw(idle);
+    app.SetGpuSimulation(framesInFlight, gpuLatencyMs);
+
+    FramePacer pacer;
+    pacer.SetTargetFrameRate(fps);
+    app.SetFramePacer(&pacer);
+
+    HostLoopConfig loop;
+    loop.pacer = &pacer;
+    loop.fixedStepSeconds = (fixedStepHz > 0.0) ? 1.0 / fixedStepHz : 0.0;
+
+    std::clock_t cpuStart = std::clock();
+    int exitCode = HostRunner::Run(app, loop);
+    double cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    app.WriteReport(stdout);
+    std::printf("process cpu %.3f s (std::clock)\n", cpuSeconds);
+    if (csvPath) {
+        FILE* csv = std::fopen(csvPath, "wb");
+        if (!csv) {
+            std::fprintf(stderr, "cannot write %s\n", csvPath);
+            return 1;
+        }
+        app.WriteStepLog(csv);
+        std::fclose(csv);
+    }
+    if (tracePath) {
+        FILE* trace = std::fopen(tracePath, "wb");
+        if (!trace) {
+            std::fprintf(stderr, "cannot write %s\n", tracePath);
+            return 1;
+        }
+        Profiler::Get().WriteChromeTrace(trace);
+        std::fclose(trace);
+    }
+
+    jobs.Shutdown();
+    if (checkIdle && app.IdleRedrawFailed()) {
+        std::fprintf(stderr, "idle redraw check failed: frames other than requested + %u settle per Idle step, or not one wait per Idle step\n", RedrawPolicy::kSettleFrames);
+        return 1;
+    }
+    return app.GpuSimulationFailed() ? 1 : exitCode;
+}
@@ -0,0 +1,159 @@
+#include "tools/replay/SceneBench.h"
+#include "tools/replay/BenchUtil.h"
+#include "editor/SceneBinary.h"
+#include "editor/SceneDocument.h"
+#include "editor/SceneFile.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const wchar_t* kTextPath = L"scene_bench.aem";
+static const wchar_t* kBinaryPath = L"scene_bench.aeb";
+static const wchar_t* kRoundTripPath = L"scene_bench_roundtrip.aem";
+
+static bool ReadWholeFile(const wchar_t* path, std::string& out) {
+    MappedFile file;
+    if (!file.Open(path)) { return false; }
+    out.assign(static_cast<const char*>(file.Data()), file.Size());
+    return true;
+}
+
+// Gives objects a mesh of their own, as edits in the modeling mode do, so binary files carry geometry.
+class BenchDocument : public SceneDocument {
+public:
+    void SetGridMesh(uint32_t index, uint32_t cells) {
+        MeshAssetID id = m_meshAssets.Create();
+        EditableMesh& mesh = m_meshAssets.Get(id)->editMesh;
+        mesh.Reserve((cells + 1) * (cells + 1), cells * cells * 2);
+        for (uint32_t y = 0; y <= cells; ++y) {
+            for (uint32_t x = 0; x <= cells; ++x) { mesh.AddVertex(DirectX::XMFLOAT3(float(x) / cells - 0.5f, float(y) / cells - 0.5f, 0.0f)); }
+        }
+        for (uint32_t y = 0; y < cells; ++y) {
+            for (uint32_t x = 0; x < cells; ++x) {
+                VertexID v = y * (cells + 1) + x;
+                mesh.AddTriangle(v, v + 1, v + cells + 1);
+                mesh.AddTriangle(v + 1, v + cells + 2, v + cells + 1);
+            }
+        }
+        m_meshAssets.Get(id)->renderMesh.BuildFromEditable(mesh);
+
+        m_meshAssets.AddRef(id);
+        m_meshAssets.Release(m_scene.Mesh(index));
+        m_scene.SetMesh(index, id);
+    }
+};
+
+// Loads path in the background with a 60 Hz frame loop: UpdateSceneLoad once per frame, as the editor
+// does. Returns false if the load fails.
+static bool LoadAsync(SceneDocument& document, const wchar_t* path, SceneLoadStats& stats) {
+    const auto frame = std::chrono::microseconds(16667);
+    auto next = std::chrono::steady_clock::now();
+    if (!document.BeginLoadScene(path)) { return false; }
+    while (document.IsLoadingScene()) {
+        document.UpdateSceneLoad(SceneDocument::kLoadSliceSeconds);
+        next += frame;
+        std::this_thread::sleep_until(next);
+    }
+    stats = document.LoadStats();
+    return !stats.failed;
+}
+
+int RunSceneBench(FILE* out, uint32_t objectCount, uint32_t rounds) {
+    rounds = (std::max)(rounds, 1u);
+
+    BenchRandom random;
+
+    BenchDocument document;
+    document.CreateDefaultScene();
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        document.AddObject(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f));
+        document.SetActiveObjectTransform(
+            DirectX::XMFLOAT3(random.Range(-50.0f, 50.0f), random.Range(-50.0f, 50.0f), random.Range(-5.0f, 5.0f)),
+            DirectX::XMFLOAT3(random.Range(-3.14f, 3.14f), random.Range(-3.14f, 3.14f), random.Range(-3.14f, 3.14f)),
+            DirectX::XMFLOAT3(random.Range(0.5f, 2.0f), random.Range(0.5f, 2.0f), random.Range(0.5f, 2.0f)));
+        if (i % 16 == 15) { document.SetActiveObjectParent(document.GetScene().HandleAt(random.Next() % (i + 2))); }
+        if (i % 1000 == 999) { document.SetGridMesh(i + 2, 64); } //8192 triangles
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!document.SaveSceneAem(kTextPath)) { std::fprintf(stderr, "cannot write scene_bench.aem\n"); return 1; }
+    double saveTextMs = MsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    if (!document.SaveSceneBinary(kBinaryPath)) { std::fprintf(stderr, "cannot write scene_bench.aeb\n"); return 1; }
+    double saveBinaryMs = MsSince(start);
+
+    std::string text, roundTrip;
+    if (!ReadWholeFile(kTextPath, text)) { return 1; }
+
+    // Loads parse text on every core, as in the editor.
+    JobSystem jobs;
+    jobs.Initialize(0);
+    SceneDocument loaded;
+    loaded.SetJobSystem(&jobs);
+    double textMin = 0.0, textMedian = 0.0, binaryMin = 0.0, binaryMedian = 0.0, openMin = 0.0, openMedian = 0.0;
+    bool ok = TimeRounds(rounds, [&]() { return loaded.LoadSceneAem(kTextPath); }, textMin, textMedian)
+        && TimeRounds(rounds, [&]() { return loaded.LoadSceneBinary(kBinaryPath); }, binaryMin, binaryMedian);
+
+    // Map and validate only: what reading the file costs before the document is rebuilt from it.
+    size_t binaryBytes = 0;
+    ok = ok && TimeRounds(rounds, [&]() {
+        MappedFile file;
+        SceneBinaryContents contents;
+        if (!file.Open(kBinaryPath) || !OpenSceneBinary(file.Data(), file.Size(), contents)) { return false; }
+        binaryBytes = file.Size();
+        return true;
+    }, openMin, openMedian);
+    // Parse only, from memory: what the text format costs before the document is rebuilt from it.
+    double parseMin = 0.0, parseMedian = 0.0, parallelMin = 0.0, parallelMedian = 0.0;
+    SceneFileData parsed;
+    ok = ok && TimeRounds(rounds, [&]() { return ParseSceneAem(text.data(), text.size(), parsed); }, parseMin, parseMedian)
+        && TimeRounds(rounds, [&]() { return ParseSceneAem(text.data(), text.size(), parsed, &jobs); }, parallelMin, parallelMedian);
+    if (!ok) { std::fprintf(stderr, "load failed: %s\n", loaded.LastLoadError().c_str()); return 1; }
+
+    // The binary-loaded document must save the same text as the original.
+    bool same = loaded.SaveSceneAem(kRoundTripPath) && ReadWholeFile(kRoundTripPath, roundTrip) && roundTrip == text;
+
+    // Asynchronous loads: the frame loop never waits for the file, only for one slice per frame.
+    SceneLoadStats textAsync, binaryAsync;
+    if (!LoadAsync(loaded, kTextPath, textAsync) || !LoadAsync(loaded, kBinaryPath, binaryAsync)) { std::fprintf(stderr, "async load failed: %s\n", loaded.LastLoadError().c_str()); return 1; }
+
+    std::fprintf(out, "%u objects, %u rounds (min / median ms)\n", document.ObjectCount(), rounds);
+    std::fprintf(out, "%-26s %10s %10s %10s %12s\n", "format", "save ms", "load min", "load med", "bytes");
+    std::fprintf(out, "%-26s %10.3f %10.3f %10.3f %12zu\n", "text (.aem)", saveTextMs, textMin, textMedian, text.size());
+    std::fprintf(out, "%-26s %10s %10.3f %10.3f\n", "  parse only, 1 thread", "", parseMin, parseMedian);
+    if (jobs.ThreadCount() > 1) {
+        char parallelLabel[48];
+        std::snprintf(parallelLabel, sizeof(parallelLabel), "  parse only, %u threads", jobs.ThreadCount());
+        std::fprintf(out, "%-26s %10s %10.3f %10.3f\n", parallelLabel, "", parallelMin, parallelMedian);
+    }
+    std::fprintf(out, "%-26s %10.3f %10.3f %10.3f %12zu\n", "binary (.aeb)", saveBinaryMs, binaryMin, binaryMedian, binaryBytes);
+    std::fprintf(out, "%-26s %10s %10.3f %10.3f\n", "  map + validate only", "", openMin, openMedian);
+    std::fprintf(out, "load speedup %.1fx, round trip %s\n", textMedian / binaryMedian, same ? "identical" : "DIFFERS");
+
+    // A synchronous load holds the frame it runs in for the whole load.
+    std::fprintf(out, "\nasync at 60 Hz (ms since the request; a synchronous load stalls one frame for its full load time)\n");
+    std::fprintf(out, "%-26s %10s %12s %12s %12s %12s %8s\n", "format", "read", "first objs", "all objs", "all meshes", "max slice", "frames");
+    const SceneLoadStats* asyncStats[] = { &textAsync, &binaryAsync };
+    const char* asyncNames[] = { "text (.aem)", "binary (.aeb)" };
+    for (int i = 0; i < 2; ++i) {
+        const SceneLoadStats& stats = *asyncStats[i];
+        std::fprintf(out, "%-26s %10.3f %12.3f %12.3f %12.3f %12.3f %8u\n", asyncNames[i], stats.readMs, stats.firstObjectsMs, stats.allObjectsMs, stats.allMeshesMs, stats.maxSliceMs, stats.slices);
+    }
+    std::fprintf(out, "binary async: %u meshes, %u objects shown with the placeholder first\n", binaryAsync.meshes, binaryAsync.placeholders);
+
+    // Same document either way.
+    std::string asyncText;
+    bool asyncSame = loaded.SaveSceneAem(kRoundTripPath) && ReadWholeFile(kRoundTripPath, asyncText) && asyncText == text;
+    std::fprintf(out, "async round trip %s\n", asyncSame ? "identical" : "DIFFERS");
+
+    std::remove("scene_bench.aem");
+    std::remove("scene_bench.aeb");
+    std::remove("scene_bench_roundtrip.aem");
+    return (same && asyncSame) ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+// Scene file benchmark: builds a document of objectCount objects (random transforms, some parented,
+// one in 1000 with a mesh of its own), saves it as .aem text and .aeb binary in the current directory,
+// then loads each format `rounds` times and prints save/load times and file sizes, and how long the
+// text takes to parse from memory on one thread and on all of them. Each format is then
+// loaded once more with BeginLoadScene under a 60 Hz frame loop, printing when objects and meshes
+// appeared and the longest frame slice. Also checks that the binary and async loads reproduce the text
+// file byte for byte. Returns a process exit code.
+int RunSceneBench(FILE* out, uint32_t objectCount, uint32_t rounds);
@@ -0,0 +1,552 @@
+#include "tools/replay/SceneOpsBench.h"
+#include "tools/replay/BenchUtil.h"
+#include "editor/EditorCommands.h"
+#include "editor/Scene.h"
+#include "editor/SceneDocument.h"
+#include "engine/core/JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Every handle the bench was given, in the order it was issued. id is stored as the object's mesh and
+// as its x position, so a handle resolving to the wrong object shows.
+struct TrackedObject {
+    ObjectHandle handle;
+    uint32_t id = 0;
+    bool alive = false;
+};
+
+ObjectTransform TransformFor(uint32_t id) {
+    ObjectTransform transform;
+    transform.pos = DirectX::XMFLOAT3(float(id), 0.0f, 0.0f); //exact below 2^24
+    return transform;
+}
+
+uint32_t CheckHandles(FILE* out, const Scene& scene, const std::vector<TrackedObject>& tracked, uint32_t liveCount) {
+    uint32_t mismatches = 0;
+    auto fail = [&](const char* what, uint32_t id) {
+        if (mismatches++ < 5) { std::fprintf(out, "  MISMATCH object %u: %s\n", id, what); }
+    };
+
+    if (scene.Count() != liveCount) { fail("object count", liveCount); }
+    for (const TrackedObject& object : tracked) {
+        uint32_t index = scene.IndexOf(object.handle);
+        if (!object.alive) {
+            if (index != Scene::kInvalidIndex) { fail("removed handle still resolves", object.id); }
+            continue;
+        }
+        if (index == Scene::kInvalidIndex) { fail("live handle does not resolve", object.id); continue; }
+        if (scene.Mesh(index) != object.id || scene.Transform(index).pos.x != float(object.id)) { fail("handle resolves to another object", object.id); }
+        if (scene.HandleAt(index) != object.handle) { fail("HandleAt does not return the handle", object.id); }
+    }
+    for (uint32_t i = 0; i < scene.Count(); ++i) {
+        if (scene.IndexOf(scene.HandleAt(i)) != i) { fail("dense index does not round-trip", i); }
+    }
+    return mismatches;
+}
+
+// The hierarchy is a preorder: every object sits inside its parent's range, and subtree sizes add up.
+uint32_t CheckHierarchy(FILE* out, const Scene& scene) {
+    const std::vector<uint32_t>& order = scene.HierarchyOrder();
+    uint32_t count = scene.Count();
+    if (order.size() != count) {
+        std::fprintf(out, "  MISMATCH: hierarchy order has %zu entries for %u objects\n", order.size(), count);
+        return 1;
+    }
+    std::vector<uint32_t> position(count, Scene::kInvalidIndex);
+    std::vector<uint32_t> childSizes(count, 0);
+    for (uint32_t p = 0; p < count; ++p) {
+        if (order[p] >= count || position[order[p]] != Scene::kInvalidIndex) {
+            std::fprintf(out, "  MISMATCH: hierarchy order is not a permutation\n");
+            return 1;
+        }
+        position[order[p]] = p;
+    }
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t parent = scene.Parent(i);
+        if (parent == Scene::kInvalidIndex) { continue; }
+        childSizes[parent] += scene.SubtreeSize(i);
+        bool inside = position[parent] < position[i] && position[i] + scene.SubtreeSize(i) <= position[parent] + scene.SubtreeSize(parent);
+        if (!inside && mismatches++ < 5) { std::fprintf(out, "  MISMATCH: object %u is outside its parent's range\n", i); }
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (scene.SubtreeSize(i) != 1 + childSizes[i] && mismatches++ < 5) { std::fprintf(out, "  MISMATCH: object %u subtree size\n", i); }
+    }
+    return mismatches;
+}
+
+// Indices of `count` distinct live entries of tracked, in random order.
+std::vector<uint32_t> PickLive(const std::vector<TrackedObject>& tracked, uint32_t count, BenchRandom& random) {
+    std::vector<uint32_t> live;
+    for (uint32_t i = 0; i < (uint32_t)tracked.size(); ++i) {
+        if (tracked[i].alive) { live.push_back(i); }
+    }
+    for (uint32_t i = (uint32_t)live.size(); i > 1; --i) { std::swap(live[i - 1], live[random.Next() % i]); }
+    live.resize((std::min)(count, (uint32_t)live.size()));
+    return live;
+}
+
+// The reference for RunHierarchyBench: objects by id (never reused), parents by id.
+struct RefObject {
+    ObjectHandle handle;
+    uint32_t parent = Scene::kInvalidIndex;
+    ObjectTransform transform;
+    bool alive = false;
+};
+
+ObjectTransform RandomTransform(BenchRandom& random) {
+    ObjectTransform transform;
+    transform.pos = DirectX::XMFLOAT3(random.Range(-2.0f, 2.0f), random.Range(-2.0f, 2.0f), random.Range(-2.0f, 2.0f));
+    transform.rot = DirectX::XMFLOAT3(random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f));
+    transform.scale = DirectX::XMFLOAT3(random.Range(0.5f, 1.5f), random.Range(0.5f, 1.5f), random.Range(0.5f, 1.5f));
+    return transform;
+}
+
+// Same product as Scene::RebuildWorld.
+DirectX::XMMATRIX LocalMatrix(const ObjectTransform& transform) {
+    DirectX::XMMATRIX S = DirectX::XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z);
+    DirectX::XMMATRIX R = DirectX::XMMatrixRotationRollPitchYaw(transform.rot.x, transform.rot.y, transform.rot.z);
+    DirectX::XMMATRIX T = DirectX::XMMatrixTranslation(transform.pos.x, transform.pos.y, transform.pos.z);
+    return S * R * T;
+}
+
+// The textbook scene graph walk: each node's world is its local matrix times its parent's, children
+// reached through per-node child lists. Stores the inverse too, as the Scene does.
+struct RecursiveGraph {
+    std::vector<std::vector<uint32_t>> children;
+    std::vector<DirectX::XMFLOAT4X4> worlds;
+    std::vector<DirectX::XMFLOAT4X4> inverseWorlds;
+
+    void Build(const std::vector<uint32_t>& parents) {
+        uint32_t count = (uint32_t)parents.size();
+        children.assign(count, std::vector<uint32_t>());
+        for (uint32_t i = 0; i < count; ++i) {
+            if (parents[i] != Scene::kInvalidIndex) { children[parents[i]].push_back(i); }
+        }
+        worlds.assign(count, DirectX::XMFLOAT4X4());
+        inverseWorlds.assign(count, DirectX::XMFLOAT4X4());
+    }
+
+    void Propagate(const std::vector<ObjectTransform>& transforms, uint32_t node, const DirectX::XMMATRIX& parentWorld) {
+        DirectX::XMMATRIX world = LocalMatrix(transforms[node]) * parentWorld;
+        DirectX::XMStoreFloat4x4(&worlds[node], world);
+        DirectX::XMStoreFloat4x4(&inverseWorlds[node], DirectX::XMMatrixInverse(nullptr, world));
+        for (uint32_t child : children[node]) { Propagate(transforms, child, world); }
+    }
+
+    void PropagateAll(const std::vector<uint32_t>& parents, const std::vector<ObjectTransform>& transforms) {
+        for (uint32_t i = 0; i < (uint32_t)parents.size(); ++i) {
+            if (parents[i] == Scene::kInvalidIndex) { Propagate(transforms, i, DirectX::XMMatrixIdentity()); }
+        }
+    }
+};
+
+bool IsRefAncestor(const std::vector<RefObject>& refs, uint32_t ancestor, uint32_t id) {
+    for (uint32_t a = id; a != Scene::kInvalidIndex; a = refs[a].parent) {
+        if (a == ancestor) { return true; }
+    }
+    return false;
+}
+
+// Both sides do the same float operations in the same order, so matrices normally match exactly; the
+// tolerance only absorbs a compiler contracting them differently.
+bool SameMatrix(const DirectX::XMFLOAT4X4& a, const DirectX::XMFLOAT4X4& b) {
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            if (!(std::fabs(a.m[r][c] - b.m[r][c]) <= 1e-4f * (1.0f + std::fabs(b.m[r][c])))) { return false; }
+        }
+    }
+    return true;
+}
+
+// Parents and world matrices of every live reference object against the scene. Updates the scene first.
+uint32_t CompareWithReference(FILE* out, Scene& scene, const std::vector<RefObject>& refs, JobSystem* jobs) {
+    scene.UpdateWorldMatrices(jobs);
+
+    std::vector<uint32_t> parents(refs.size());
+    std::vector<ObjectTransform> transforms(refs.size());
+    for (size_t id = 0; id < refs.size(); ++id) {
+        parents[id] = refs[id].alive ? refs[id].parent : Scene::kInvalidIndex;
+        transforms[id] = refs[id].transform;
+    }
+    RecursiveGraph graph;
+    graph.Build(parents);
+    graph.PropagateAll(parents, transforms);
+
+    uint32_t mismatches = 0, alive = 0;
+    for (uint32_t id = 0; id < (uint32_t)refs.size(); ++id) {
+        const RefObject& ref = refs[id];
+        if (!ref.alive) { continue; }
+        alive++;
+        uint32_t index = scene.IndexOf(ref.handle);
+        if (index == Scene::kInvalidIndex) { mismatches++; continue; }
+        uint32_t parent = (ref.parent == Scene::kInvalidIndex) ? Scene::kInvalidIndex : scene.IndexOf(refs[ref.parent].handle);
+        if (scene.Parent(index) != parent) {
+            if (mismatches++ < 5) { std::fprintf(out, "  MISMATCH object %u: parent\n", id); }
+            continue;
+        }
+        if (!SameMatrix(scene.World(index), graph.worlds[id]) || !SameMatrix(scene.InverseWorld(index), graph.inverseWorlds[id])) {
+            if (mismatches++ < 5) { std::fprintf(out, "  MISMATCH object %u: world matrix\n", id); }
+        }
+    }
+    if (alive != scene.Count()) { mismatches++; }
+    return mismatches + CheckHierarchy(out, scene);
+}
+
+double NsPer(double ms, uint32_t count) {
+    return count ? ms * 1.0e6 / count : 0.0;
+}
+
+} // namespace
+
+int RunHandlesBench(FILE* out, uint32_t objectCount, uint32_t rounds) {
+    objectCount = (std::max)(objectCount, 2u);
+    BenchRandom random;
+    const DirectX::XMFLOAT4 white(1.0f, 1.0f, 1.0f, 1.0f);
+
+    Scene scene;
+    std::vector<TrackedObject> tracked;
+    tracked.reserve(objectCount + size_t(objectCount / 10 + 1) * rounds);
+    uint32_t nextId = 0;
+    uint32_t liveCount = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        TrackedObject object;
+        object.id = nextId++;
+        object.handle = scene.Add(TransformFor(object.id), white, object.id);
+        object.alive = true;
+        tracked.push_back(object);
+    }
+    double addMs = MsSince(start);
+    liveCount = objectCount;
+
+    // One object in eight gets a parent, so removals also take the path that keeps subtrees together.
+    auto parentSome = [&](size_t first) {
+        for (size_t i = first; i < tracked.size(); ++i) {
+            const TrackedObject& parent = tracked[random.Next() % tracked.size()];
+            if (i % 8 != 7 || !parent.alive) { continue; }
+            scene.SetParent(scene.IndexOf(tracked[i].handle), scene.IndexOf(parent.handle)); //cycles are refused
+        }
+    };
+    parentSome(0);
+    uint32_t mismatches = CheckHandles(out, scene, tracked, liveCount) + CheckHierarchy(out, scene);
+
+    uint64_t indexSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const TrackedObject& object : tracked) { indexSum += scene.IndexOf(object.handle); }
+    double indexOfMs = MsSince(start);
+    if (indexSum != uint64_t(objectCount) * (objectCount - 1) / 2) {
+        std::fprintf(out, "  MISMATCH: IndexOf over the fresh scene is not a permutation\n");
+        mismatches++;
+    }
+
+    // Roots without children come out in O(1); the rest shift the hierarchy order behind them.
+    double removeMs[2] = {};
+    uint32_t removedKind[2] = {};
+    double readdMs = 0.0;
+    uint32_t removed = 0, readded = 0, reusedSlots = 0;
+    for (uint32_t round = 0; round < rounds; ++round) {
+        std::vector<uint32_t> victims = PickLive(tracked, objectCount / 10, random);
+        for (uint32_t t : victims) {
+            uint32_t index = scene.IndexOf(tracked[t].handle);
+            int kind = (scene.Parent(index) == Scene::kInvalidIndex && scene.SubtreeSize(index) == 1) ? 0 : 1;
+            auto opStart = std::chrono::steady_clock::now();
+            bool ok = scene.Remove(tracked[t].handle);
+            removeMs[kind] += MsSince(opStart);
+            removedKind[kind]++;
+            if (!ok) { mismatches++; }
+        }
+        for (uint32_t t : victims) { tracked[t].alive = false; }
+        removed += (uint32_t)victims.size();
+        liveCount -= (uint32_t)victims.size();
+
+        for (uint32_t t : victims) {
+            if (scene.Remove(tracked[t].handle)) { mismatches++; std::fprintf(out, "  MISMATCH: removed object %u twice\n", tracked[t].id); }
+        }
+
+        size_t firstNew = tracked.size();
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < victims.size(); ++i) {
+            TrackedObject object;
+            object.id = nextId++;
+            object.handle = scene.Add(TransformFor(object.id), white, object.id);
+            object.alive = true;
+            tracked.push_back(object);
+        }
+        readdMs += MsSince(start);
+        readded += (uint32_t)victims.size();
+        liveCount += (uint32_t)victims.size();
+        for (size_t i = firstNew; i < tracked.size(); ++i) {
+            if (tracked[i].handle.index < objectCount) { reusedSlots++; }
+        }
+        parentSome(firstNew);
+
+        mismatches += CheckHandles(out, scene, tracked, liveCount) + CheckHierarchy(out, scene);
+    }
+
+    std::fprintf(out, "Scene: %u objects, %u rounds (%u removed, %u added, %u into freed slots)\n", objectCount, rounds, removed, readded, reusedSlots);
+    std::fprintf(out, "%-28s %12s\n", "operation", "ns per op");
+    std::fprintf(out, "%-28s %12.1f\n", "Add", NsPer(addMs, objectCount));
+    std::fprintf(out, "%-28s %12.1f\n", "IndexOf", NsPer(indexOfMs, objectCount));
+    std::fprintf(out, "%-28s %12.1f  (%u)\n", "Remove (root, no children)", NsPer(removeMs[0], removedKind[0]), removedKind[0]);
+    std::fprintf(out, "%-28s %12.1f  (%u)\n", "Remove (in a hierarchy)", NsPer(removeMs[1], removedKind[1]), removedKind[1]);
+    std::fprintf(out, "%-28s %12.1f\n", "Add (reusing slots)", NsPer(readdMs, readded));
+
+    // The same through the document, by command: select a handle, delete it, and check a stale handle
+    // is refused without changing the selection.
+    SceneDocument document;
+    std::vector<TrackedObject> docTracked(objectCount);
+    EditorCommand command;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        command.type = EditorCommandType::AddObject;
+        command.pos = DirectX::XMFLOAT3(float(i), 0.0f, 0.0f);
+        document.ExecuteCommand(command);
+        docTracked[i].handle = document.ActiveObject();
+        docTracked[i].id = i;
+        docTracked[i].alive = true;
+    }
+    double docAddMs = MsSince(start);
+    uint32_t docLive = document.ObjectCount();
+    uint32_t existing = docLive - objectCount; //whatever the document starts with
+
+    const uint32_t deletes = (std::min)(objectCount / 10, 1000u);
+    std::vector<uint32_t> victims = PickLive(docTracked, deletes, random);
+    double selectMs = 0.0, deleteMs = 0.0;
+    for (uint32_t t : victims) {
+        command.type = EditorCommandType::SetActiveObject;
+        command.object = docTracked[t].handle;
+        auto opStart = std::chrono::steady_clock::now();
+        bool selected = document.ExecuteCommand(command);
+        selectMs += MsSince(opStart);
+        if (!selected || document.ActiveObject() != docTracked[t].handle) { mismatches++; continue; }
+
+        command.type = EditorCommandType::DeleteActiveObject;
+        opStart = std::chrono::steady_clock::now();
+        bool deleted = document.ExecuteCommand(command);
+        deleteMs += MsSince(opStart);
+        if (!deleted) { mismatches++; continue; }
+        docTracked[t].alive = false;
+        docLive--;
+
+        ObjectHandle active = document.ActiveObject();
+        command.type = EditorCommandType::SetActiveObject;
+        command.object = docTracked[t].handle;
+        if (document.ExecuteCommand(command) || document.ActiveObject() != active) {
+            if (mismatches++ < 5) { std::fprintf(out, "  MISMATCH: stale handle of object %u was accepted\n", t); }
+        }
+    }
+
+    const Scene& docScene = document.GetScene();
+    if (docScene.Count() != docLive) { mismatches++; }
+    for (const TrackedObject& object : docTracked) {
+        uint32_t index = docScene.IndexOf(object.handle);
+        bool ok = object.alive ? (index != Scene::kInvalidIndex && docScene.Transform(index).pos.x == float(object.id)) : (index == Scene::kInvalidIndex);
+        if (!ok && mismatches++ < 5) { std::fprintf(out, "  MISMATCH document object %u\n", object.id); }
+    }
+
+    std::fprintf(out, "SceneDocument: %u objects (+%u default), %u deleted by command\n", objectCount, existing, (uint32_t)victims.size());
+    std::fprintf(out, "%-28s %12.1f\n", "AddObject", NsPer(docAddMs, objectCount));
+    std::fprintf(out, "%-28s %12.1f\n", "SetActiveObject", NsPer(selectMs, (uint32_t)victims.size()));
+    std::fprintf(out, "%-28s %12.1f\n", "DeleteActiveObject", NsPer(deleteMs, (uint32_t)victims.size()));
+    std::fprintf(out, "%u mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int RunHierarchyBench(FILE* out, uint32_t objectCount, uint32_t rounds) {
+    objectCount = (std::max)(objectCount, 16u);
+    rounds = (std::max)(rounds, 1u);
+    BenchRandom random;
+    const DirectX::XMFLOAT4 white(1.0f, 1.0f, 1.0f, 1.0f);
+    JobSystem jobs;
+    jobs.Initialize(4);
+
+    // Differential test. Every round alternates single threaded and job system updates; SetParents
+    // flags every object, which is enough for the parallel path.
+    const uint32_t testCount = (std::min)(objectCount, 5000u);
+    const uint32_t testRounds = 24;
+    Scene scene;
+    std::vector<RefObject> refs;
+    auto addObject = [&]() {
+        RefObject ref;
+        ref.transform = RandomTransform(random);
+        ref.handle = scene.Add(ref.transform, white, (uint32_t)refs.size());
+        ref.alive = true;
+        refs.push_back(ref);
+    };
+    auto randomLive = [&]() {
+        for (;;) {
+            uint32_t id = random.Next() % (uint32_t)refs.size();
+            if (refs[id].alive) { return id; }
+        }
+    };
+    for (uint32_t i = 0; i < testCount; ++i) { addObject(); }
+
+    uint32_t mismatches = 0, operations = 0, rejectedLinks = 0, partialChecks = 0;
+    for (uint32_t round = 0; round < testRounds; ++round) {
+        for (uint32_t step = 0; step < 400; ++step, ++operations) {
+            uint32_t op = random.Next() % 20;
+            if (op < 8) {
+                uint32_t id = randomLive();
+                refs[id].transform = RandomTransform(random);
+                scene.SetTransform(scene.IndexOf(refs[id].handle), refs[id].transform);
+            } else if (op < 15) {
+                uint32_t id = randomLive();
+                uint32_t parent = (random.Next() % 5 == 0) ? Scene::kInvalidIndex : randomLive();
+                if (op == 14) {
+                    // Under one of its own descendants (or itself), which must be refused.
+                    std::vector<uint32_t> ancestors;
+                    for (uint32_t a = parent; a != Scene::kInvalidIndex; a = refs[a].parent) { ancestors.push_back(a); }
+                    if (!ancestors.empty()) { id = ancestors[random.Next() % ancestors.size()]; }
+                }
+                bool expected = (parent == Scene::kInvalidIndex) || !IsRefAncestor(refs, id, parent);
+                uint32_t parentIndex = (parent == Scene::kInvalidIndex) ? Scene::kInvalidIndex : scene.IndexOf(refs[parent].handle);
+                bool linked = scene.SetParent(scene.IndexOf(refs[id].handle), parentIndex);
+                if (expected) { refs[id].parent = parent; } else { rejectedLinks++; }
+                if (linked != expected && mismatches++ < 5) { std::fprintf(out, "  MISMATCH: SetParent(%u, %u) returned %d\n", id, parent, linked); }
+            } else if (op < 18 && scene.Count() > 1) {
+                // Children move up to the removed object's parent.
+                uint32_t id = randomLive();
+                for (RefObject& ref : refs) {
+                    if (ref.alive && ref.parent == id) { ref.parent = refs[id].parent; }
+                }
+                refs[id].alive = false;
+                scene.Remove(refs[id].handle);
+            } else {
+                addObject();
+            }
+        }
+
+        if (round % 4 == 3) {
+            // Whole-scene relink: some links out of range, to the object itself or into cycles. Mirrored
+            // as SetParent calls in dense index order from all roots, which is what SetParents promises.
+            uint32_t count = scene.Count();
+            std::vector<uint32_t> parents(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                uint32_t kind = random.Next() % 8;
+                parents[i] = (kind < 4) ? random.Next() % count : (kind == 4) ? count + kind : (kind == 5) ? i : Scene::kInvalidIndex;
+            }
+            for (RefObject& ref : refs) { ref.parent = Scene::kInvalidIndex; }
+            for (uint32_t i = 0; i < count; ++i) {
+                if (parents[i] >= count || parents[i] == i) { continue; }
+                uint32_t id = scene.Mesh(i), parent = scene.Mesh(parents[i]);
+                if (!IsRefAncestor(refs, id, parent)) { refs[id].parent = parent; } else { rejectedLinks++; }
+            }
+            scene.SetParents(parents.data());
+        }
+
+        mismatches += CompareWithReference(out, scene, refs, (round & 1) ? &jobs : nullptr);
+
+        // Only flagged subtrees are rebuilt: moving a few objects must rebuild exactly them and their
+        // descendants.
+        std::vector<uint8_t> moved(refs.size(), 0);
+        for (uint32_t m = 0; m < 8; ++m) {
+            uint32_t id = randomLive();
+            moved[id] = 1;
+            refs[id].transform = RandomTransform(random);
+            scene.SetTransform(scene.IndexOf(refs[id].handle), refs[id].transform);
+        }
+        uint32_t expectedRebuilds = 0;
+        for (uint32_t id = 0; id < (uint32_t)refs.size(); ++id) {
+            if (!refs[id].alive) { continue; }
+            for (uint32_t a = id; a != Scene::kInvalidIndex; a = refs[a].parent) {
+                if (moved[a]) { expectedRebuilds++; break; }
+            }
+        }
+        uint32_t rebuilt = scene.UpdateWorldMatrices((round & 1) ? &jobs : nullptr);
+        if (rebuilt != expectedRebuilds && mismatches++ < 5) { std::fprintf(out, "  MISMATCH: partial update rebuilt %u, expected %u\n", rebuilt, expectedRebuilds); }
+        mismatches += CompareWithReference(out, scene, refs, nullptr);
+        partialChecks++;
+    }
+    std::fprintf(out, "differential: %u operations on %u objects (%u links refused as cycles), %u partial updates, %u mismatches\n",
+        operations, testCount, rejectedLinks, partialChecks, mismatches);
+
+    // Propagation timing on a random forest: one object in 100 a root, the rest under a random earlier one.
+    Scene forest;
+    forest.Reserve(objectCount);
+    std::vector<ObjectTransform> transforms(objectCount);
+    std::vector<uint32_t> parents(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        transforms[i] = RandomTransform(random);
+        forest.Add(transforms[i], white, i);
+        parents[i] = (i % 100 == 0) ? Scene::kInvalidIndex : random.Next() % i;
+    }
+    forest.SetParents(parents.data());
+    forest.UpdateWorldMatrices();
+    uint32_t depth = 0;
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        uint32_t d = 0;
+        for (uint32_t a = i; a != Scene::kInvalidIndex; a = forest.Parent(a)) { d++; }
+        depth = (std::max)(depth, d);
+    }
+
+    auto touchAll = [&]() {
+        for (uint32_t i = 0; i < objectCount; ++i) { forest.SetTransform(i, transforms[i]); }
+    };
+    double serialMs = 0.0, parallelMs = 0.0, recursiveMs = 0.0, minMs = 0.0;
+    for (uint32_t round = 0; round < rounds; ++round) {
+        touchAll();
+        auto start = std::chrono::steady_clock::now();
+        forest.UpdateWorldMatrices();
+        minMs = MsSince(start);
+        serialMs = round ? (std::min)(serialMs, minMs) : minMs;
+
+        touchAll();
+        start = std::chrono::steady_clock::now();
+        forest.UpdateWorldMatrices(&jobs);
+        minMs = MsSince(start);
+        parallelMs = round ? (std::min)(parallelMs, minMs) : minMs;
+    }
+
+    // Child lists are built once in a real scene graph, so only the walk is timed.
+    RecursiveGraph graph;
+    graph.Build(parents);
+    for (uint32_t round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        graph.PropagateAll(parents, transforms);
+        minMs = MsSince(start);
+        recursiveMs = round ? (std::min)(recursiveMs, minMs) : minMs;
+    }
+    // SetParents dropped no link here (every parent is an earlier object), so the walk is a reference too.
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        if (!SameMatrix(forest.World(i), graph.worlds[i]) && mismatches++ < 5) { std::fprintf(out, "  MISMATCH forest object %u\n", i); }
+    }
+
+    // A frame where one object in 100 moves.
+    for (uint32_t i = 0; i < objectCount / 100; ++i) {
+        uint32_t index = random.Next() % objectCount;
+        forest.SetTransform(index, transforms[index]);
+    }
+    auto start = std::chrono::steady_clock::now();
+    uint32_t partialRebuilds = forest.UpdateWorldMatrices();
+    double partialMs = MsSince(start);
+
+    // Incremental reparenting: a subtree moves within the order, nothing is re-sorted.
+    const uint32_t reparents = 1000;
+    uint32_t refused = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < reparents; ++i) {
+        uint32_t index = random.Next() % objectCount;
+        uint32_t parent = (i % 10 == 0) ? Scene::kInvalidIndex : random.Next() % objectCount;
+        if (!forest.SetParent(index, parent)) { refused++; }
+    }
+    double setParentMs = MsSince(start);
+    mismatches += CheckHierarchy(out, forest);
+
+    std::fprintf(out, "forest: %u objects, %u roots, depth %u\n", objectCount, (objectCount + 99) / 100, depth);
+    std::fprintf(out, "%-36s %12s\n", "world matrices", "ms (best)");
+    std::fprintf(out, "%-36s %12.3f\n", "recursive walk over child lists", recursiveMs);
+    std::fprintf(out, "%-36s %12.3f\n", "Scene, all flagged", serialMs);
+    std::fprintf(out, "%-36s %12.3f\n", "Scene, all flagged, 4 job threads", parallelMs);
+    std::fprintf(out, "%-36s %12.3f  (%u rebuilt)\n", "Scene, 1 in 100 moved", partialMs, partialRebuilds);
+    std::fprintf(out, "SetParent %.2f us per call (%u of %u refused as cycles)\n", setParentMs * 1000.0 / reparents, refused, reparents);
+    std::fprintf(out, "%u mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
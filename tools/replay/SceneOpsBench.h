@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+// Scene handle benchmark: adds objectCount objects to a Scene, then for each of `rounds` removes a random
+// tenth and adds as many back (reusing their slots). Every live handle must still resolve to its own
+// object and every removed one must fail. Then drives a SceneDocument of the same size through
+// SetActiveObject / DeleteActiveObject commands addressed by handle. Prints nanoseconds per operation.
+// Returns a process exit code.
+int RunHandlesBench(FILE* out, uint32_t objectCount, uint32_t rounds);
+
+// Scene hierarchy test and benchmark. First a differential test: random SetTransform, SetParent, SetParents,
+// Add and Remove calls on a Scene of up to 5000 objects are mirrored on a plain parent-pointer model,
+// whose world matrices come from a recursive walk over child lists; every round parents, world
+// matrices and the number of matrices a partial update rebuilds must match. Then times propagation on
+// objectCount objects (a random forest) against the same recursive walk, single threaded and on the
+// job system, plus a partial update and SetParent. Returns a process exit code.
+int RunHierarchyBench(FILE* out, uint32_t objectCount, uint32_t rounds);
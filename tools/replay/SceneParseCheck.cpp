@@ -0,0 +1,232 @@
+#include "tools/replay/SceneParseCheck.h"
+#include "tools/replay/BenchUtil.h"
+#include "editor/SceneDocument.h"
+#include "editor/SceneFile.h"
+#include "engine/core/JobSystem.h"
+#include "engine/core/MappedFile.h"
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+const wchar_t* kBrokenPath = L"parse_check_broken.aem";
+
+// The loop ReadSceneAem ran before ParseSceneAem, reading from memory with sscanf instead of a FILE.
+bool ScanfSceneAem(const std::string& text, SceneFileData& out) {
+    const char* p = text.c_str();
+    int used = 0;
+
+    char header[64] = {};
+    int ver = 0;
+    if (std::sscanf(p, "%63s %d%n", header, &ver, &used) != 2) { return false; }
+    p += used;
+    if (std::strcmp(header, "AE_MODEL") != 0 || ver < 1 || ver > 2) { return false; }
+
+    char key[64] = {};
+    unsigned n = 0;
+    if (std::sscanf(p, "%63s %u%n", key, &n, &used) != 2 || std::strcmp(key, "objects") != 0) { return false; }
+    p += used;
+
+    unsigned active = 0;
+    if (std::sscanf(p, "%63s %u%n", key, &active, &used) != 2 || std::strcmp(key, "active") != 0) { return false; }
+    p += used;
+
+    if (n == 0) n = 1;
+
+    out.positions.resize(n);
+    out.rotations.resize(n);
+    out.scales.resize(n);
+    out.colors.resize(n);
+    out.parents.assign(n, -1);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        char objKey[16] = {};
+        char prim[16] = {};
+        if (std::sscanf(p, "%15s %15s%n", objKey, prim, &used) != 2) { return false; }
+        p += used;
+        if (std::strcmp(objKey, "obj") != 0 || std::strcmp(prim, "tetra") != 0) { return false; }
+
+        DirectX::XMFLOAT3& pos = out.positions[i];
+        DirectX::XMFLOAT3& rot = out.rotations[i];
+        DirectX::XMFLOAT3& scale = out.scales[i];
+        DirectX::XMFLOAT4& color = out.colors[i];
+        if (std::sscanf(p, "%f %f %f %f %f %f %f %f %f %f %f %f %f%n",
+            &pos.x, &pos.y, &pos.z,
+            &rot.x, &rot.y, &rot.z,
+            &scale.x, &scale.y, &scale.z,
+            &color.x, &color.y, &color.z, &color.w, &used
+        ) != 13) { return false; }
+        p += used;
+
+        int parent = -1;
+        if (ver >= 2) {
+            if (std::sscanf(p, "%d%n", &parent, &used) != 1) { return false; }
+            p += used;
+        }
+        out.parents[i] = parent;
+    }
+
+    out.contents = SceneBinaryContents();
+    out.contents.objectCount = n;
+    out.contents.activeIndex = (active < n) ? (uint32_t)active : 0;
+    return true;
+}
+
+template <typename T>
+bool SameArray(const T* a, const T* b, uint32_t count) {
+    return std::memcmp(a, b, sizeof(T) * count) == 0;
+}
+
+bool SameScene(const SceneFileData& a, const SceneFileData& b) {
+    uint32_t n = a.contents.objectCount;
+    return n == b.contents.objectCount && a.contents.activeIndex == b.contents.activeIndex
+        && SameArray(a.positions.data(), b.positions.data(), n) && SameArray(a.rotations.data(), b.rotations.data(), n)
+        && SameArray(a.scales.data(), b.scales.data(), n) && SameArray(a.colors.data(), b.colors.data(), n)
+        && SameArray(a.parents.data(), b.parents.data(), n);
+}
+
+// The values of assets/scenes/scene.aem.
+bool IsDefaultScene(const SceneFileData& data) {
+    const DirectX::XMFLOAT3 positions[] = { { -7.4505806e-09f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f } };
+    const DirectX::XMFLOAT3 zero[] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+    const DirectX::XMFLOAT3 ones[] = { { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+    const DirectX::XMFLOAT4 white[] = { { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+    const int32_t roots[] = { -1, -1 };
+    return data.contents.objectCount == 2 && data.contents.activeIndex == 0
+        && SameArray(data.positions.data(), positions, 2) && SameArray(data.rotations.data(), zero, 2)
+        && SameArray(data.scales.data(), ones, 2) && SameArray(data.colors.data(), white, 2)
+        && SameArray(data.parents.data(), roots, 2);
+}
+
+// A v2 file in the spellings fscanf accepts: spaces and tabs, CRLF, blank lines, '+', exponents and
+// values past float's range. When badObject < objectCount, that object's fifth number is "1.5.2" and
+// badLine/badColumn say where it starts.
+std::string MakeAemText(uint32_t objectCount, uint32_t badObject, uint32_t& badLine, uint32_t& badColumn) {
+    static const char* kOddValues[] = { "1e-40", "-1.4e-45", "1e39", "-1e39", "+2.5", "3.4028235e+38", "inf", "-0", "7E-3", ".5", "5." };
+    BenchRandom random(7u);
+    std::string text = "AE_MODEL 2\r\nobjects " + std::to_string(objectCount) + "\n\tactive 3\n";
+    uint32_t line = 4;
+    char field[48];
+
+    for (uint32_t i = 0; i < objectCount; ++i, ++line) {
+        if (random.Next() % 64 == 0) { text += (random.Next() & 1) ? "\n" : " \t\r\n"; line++; }
+
+        size_t lineStart = text.size();
+        text += (random.Next() % 8 == 0) ? "  obj\ttetra" : "obj tetra";
+        for (uint32_t f = 0; f < 13; ++f) {
+            text += (random.Next() % 8 == 0) ? "\t " : " ";
+            if (i == badObject && f == 4) {
+                badLine = line;
+                badColumn = (uint32_t)(text.size() - lineStart) + 1;
+                text += "1.5.2";
+                continue;
+            }
+            uint32_t pick = random.Next() % 16;
+            if (pick < (uint32_t)(sizeof(kOddValues) / sizeof(kOddValues[0]))) {
+                text += kOddValues[pick];
+            } else {
+                std::snprintf(field, sizeof(field), (pick & 1) ? "%.9g" : "%.4e", random.Range(-1000.0f, 1000.0f));
+                text += field;
+            }
+        }
+        int32_t parent = (random.Next() % 4 == 0) ? (int32_t)(random.Next() % objectCount) : -1;
+        std::snprintf(field, sizeof(field), (parent > 0 && random.Next() % 4 == 0) ? " +%d" : " %d", parent);
+        text += field;
+        text += (random.Next() % 4 == 0) ? "\r\n" : "\n";
+    }
+    return text;
+}
+
+bool WriteFileText(const wchar_t* path, const std::string& text) {
+    FILE* f = OpenSceneFile(path, true);
+    if (!f) { return false; }
+    bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+struct BrokenFile {
+    const char* name;
+    const char* text;
+    const char* error;
+};
+
+const BrokenFile kBrokenFiles[] = {
+    { "bad number",
+      "AE_MODEL 1\nobjects 2\nactive 0\nobj tetra 0 0 0 0 0 0 1 1 1 1 1 1 1\nobj tetra 2 0 x 0 0 0 1 1 1 1 1 1 1\n",
+      "line 5, column 15: expected a number" },
+    { "missing parent (v2)",
+      "AE_MODEL 2\nobjects 1\nactive 0\nobj tetra 0 0 0 0 0 0 1 1 1 1 1 1 1\n",
+      "line 4, column 36: expected a parent index" },
+    { "trailing text",
+      "AE_MODEL 1\nobjects 1\nactive 0\nobj tetra 0 0 0 0 0 0 1 1 1 1 1 1 1 extra\n",
+      "line 4, column 37: unexpected text after the object" },
+    { "short object count",
+      "AE_MODEL 2\nobjects 3\nactive 0\nobj tetra 0 0 0 0 0 0 1 1 1 1 1 1 1 -1\nobj tetra 0 0 0 0 0 0 1 1 1 1 1 1 1 0\n",
+      "line 6, column 1: file ends after 2 of 3 objects" },
+    { "bad header count",
+      "AE_MODEL 1\nobjects x\nactive 0\n",
+      "line 2, column 9: expected an object count" },
+};
+
+} // namespace
+
+int RunSceneParseCheck(FILE* out, const wchar_t* scenePath) {
+    uint32_t failures = 0;
+    auto check = [&](bool ok, const char* what) {
+        std::fprintf(out, "  %-44s %s\n", what, ok ? "ok" : "FAIL");
+        if (!ok) { failures++; }
+    };
+
+    // The shipped scene: fixed values, and the same bits as the fscanf loader.
+    MappedFile file;
+    if (!file.Open(scenePath)) {
+        std::fprintf(out, "cannot open the scene\n");
+        return 1;
+    }
+    std::string sceneText(static_cast<const char*>(file.Data()), file.Size());
+    SceneFileData scene, sceneReference;
+    std::string error;
+    bool parsed = ReadSceneAem(scenePath, scene, nullptr, nullptr, &error);
+    check(parsed && IsDefaultScene(scene), "scene.aem values");
+    check(parsed && ScanfSceneAem(sceneText, sceneReference) && SameScene(scene, sceneReference), "scene.aem matches fscanf");
+
+    // Many chunks: serial and parallel parses against the reference.
+    const uint32_t objectCount = 20000;
+    uint32_t badLine = 0, badColumn = 0;
+    std::string text = MakeAemText(objectCount, objectCount, badLine, badColumn);
+    SceneFileData reference, serial, parallel;
+    JobSystem jobs;
+    jobs.Initialize(4);
+    bool referenceOk = ScanfSceneAem(text, reference);
+    bool serialOk = ParseSceneAem(text.data(), text.size(), serial, nullptr, nullptr, &error);
+    bool parallelOk = ParseSceneAem(text.data(), text.size(), parallel, &jobs, nullptr, &error);
+    std::fprintf(out, "generated: %u objects, %zu bytes\n", objectCount, text.size());
+    check(referenceOk && serialOk && SameScene(serial, reference), "1 thread matches fscanf");
+    check(referenceOk && parallelOk && SameScene(parallel, reference), "4 threads match fscanf");
+    check(serialOk && parallelOk && SameScene(serial, parallel), "1 thread and 4 threads identical");
+
+    // An error deep in a later chunk still reports its own line and column, with and without jobs.
+    std::string broken = MakeAemText(objectCount, objectCount * 3 / 4, badLine, badColumn);
+    char expected[96];
+    std::snprintf(expected, sizeof(expected), "line %u, column %u: expected a number", badLine, badColumn);
+    std::string serialError, parallelError;
+    ParseSceneAem(broken.data(), broken.size(), serial, nullptr, nullptr, &serialError);
+    ParseSceneAem(broken.data(), broken.size(), parallel, &jobs, nullptr, &parallelError);
+    jobs.Shutdown();
+    std::fprintf(out, "  expect \"%s\"\n", expected);
+    check(serialError == expected, "late error, 1 thread");
+    check(parallelError == expected, "late error, 4 threads");
+
+    // Broken files through the document, as the editor reports them.
+    for (const BrokenFile& brokenFile : kBrokenFiles) {
+        SceneDocument document;
+        bool loaded = WriteFileText(kBrokenPath, brokenFile.text) && document.LoadSceneAem(kBrokenPath);
+        bool ok = !loaded && document.LastLoadError() == brokenFile.error;
+        if (!ok) { std::fprintf(out, "  got \"%s\", expected \"%s\"\n", document.LastLoadError().c_str(), brokenFile.error); }
+        check(ok, brokenFile.name);
+    }
+
+    std::fprintf(out, "%u failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdio>
+
+// .aem parser test. Parses scenePath (assets/scenes/scene.aem, whose values it expects) and checks
+// them against fixed values and against the fscanf loader ParseSceneAem replaced (kept here, over
+// memory, as the reference). Then parses a generated v2 file of many chunks, with exponents,
+// denormals, out-of-range values, '+', tabs, CRLF and blank lines, serially and on a 4-thread
+// JobSystem, and requires both to match the reference bit for bit. Last, loads broken files through
+// SceneDocument and checks the exact "line L, column C: ..." of LastLoadError. Files it writes go to
+// the current directory. Returns a process exit code.
+int RunSceneParseCheck(FILE* out, const wchar_t* scenePath);
@@ -0,0 +1,47 @@
+#pragma once
+
+// Empty SAL annotations for non-Windows builds: DirectXMath includes <sal.h>, which only the Windows
+// SDK ships. The annotations only feed MSVC's code analysis, so expanding to nothing is enough.
+
+#define _In_
+#define _In_opt_
+#define _In_z_
+#define _In_reads_(size)
+#define _In_reads_opt_(size)
+#define _In_reads_bytes_(size)
+#define _In_reads_bytes_opt_(size)
+#define _In_range_(lo, hi)
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_(size)
+#define _Out_writes_opt_(size)
+#define _Out_writes_bytes_(size)
+#define _Out_writes_bytes_opt_(size)
+#define _Out_writes_all_(size)
+#define _Out_writes_to_(size, count)
+#define _Out_range_(lo, hi)
+#define _Inout_
+#define _Inout_opt_
+#define _Inout_updates_(size)
+#define _Inout_updates_bytes_(size)
+#define _Outptr_
+#define _Outptr_opt_
+#define _Ret_
+#define _Ret_maybenull_
+#define _Ret_notnull_
+#define _Success_(expr)
+#define _Check_return_
+#define _Must_inspect_result_
+#define _Use_decl_annotations_
+#define _Analysis_assume_(expr)
+#define _Pre_satisfies_(expr)
+#define _Post_satisfies_(expr)
+#define _When_(expr, annotations)
+#define _Notnull_
+#define _Maybenull_
+#define _Null_terminated_
+#define _Printf_format_string_
+#define _Field_size_(size)
+#define _Field_size_bytes_(size)
+#define _Frees_ptr_
+#define _Frees_ptr_opt_